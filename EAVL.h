@@ -120,23 +120,51 @@
 #define EAVL_FIND_GT		(4)
 
 
+/*
+** Greatest possible tree height; path arrays of this size always suffice:
+*/
+#define EAVL_HEIGHT_MAX		((unsigned int)(sizeof(uintptr_t) * 12))
+
+
+/*
+** cbPathe vector request index and the most elements requested:
+*/
+#define EAVL_PATHE_VECTOR	(-2u)
+#define EAVL_PATHE_VECTOR_SIZE	(EAVL_HEIGHT_MAX + 2)
+
+
+/*
+** Separately locked parts of a tree's context registry:
+*/
+#define EAVL_CONTEXT_SHARDS	(8)
+
+
+/*
+** Serialized tree shape size, in bytes, for COUNT nodes:
+*/
+#define EAVL_SHAPE_SIZE(COUNT)	(((COUNT)>>1) + ((COUNT)&1))
+
+
 /*
 ** CHECK values:
 **
 **	Useful for debugging EAVL and client code.
 **
-** Warning:
-**	Although the the main tree manipulation code is non-recursive,
-**	the code that these flags enable may be recursive with an
-**	expected recursion depth proportional to log2(tree node count).
+** Note:
+**	The tree checks walk the tree with an explicit stack of at most
+**	EAVL_HEIGHT_MAX nodes, so a corrupt (cyclic) tree fails the
+**	check rather than overflowing the call stack.
 */
 #define EAVL_CHECK_TREE		(1u<<0)	/* Validate tree before each op	*/
 #define EAVL_CHECK_CONTEXT	(1u<<1)	/* Validate context consistency	*/
 #define EAVL_CHECK_ORDER	(1u<<2)	/* Validate node ordering also	*/
 #define EAVL_CHECK_PARAM	(1u<<3)	/* Validate parameters		*/
 #define EAVL_CHECK_CALLBACK	(1u<<4)	/* Validate callback results	*/
+#define EAVL_CHECK_PATH		(1u<<5)	/* Validate changed path	*/
+#define EAVL_CHECK_GENERATION	(1u<<6)	/* Validate context currency	*/
 
-#define EAVL_CHECK_ALL	((1u<<5)-1)	/* Enable all available checks	*/
+#define EAVL_CHECK_ALL	((1u<<7)-1)	/* Enable all available checks	*/
+#define EAVL_CHECK_COUNT	(7)	/* Number of check bits		*/
 
 
 typedef uintptr_t		EAVL_node_spec_t;
@@ -155,18 +183,54 @@ typedef struct EAVL_context_common	EAVL_context_common_t;
 typedef struct
 	{
 	EAVL_context_node_t*	contexts;
+	uintptr_t		lock;
+	}			EAVL_context_shard_t;
+typedef struct
+	{
+	EAVL_context_shard_t	contexts[EAVL_CONTEXT_SHARDS];
 	uintptr_t		associations;
+	uintptr_t		generation;	/* Advanced by each change	*/
+	unsigned int		checks;		/* Checks allowed for the tree	*/
 	}			EAVL_tree_common_t;
 struct EAVL_context_common
 	{
 	EAVL_context_node_t	node;
 	void*			cbdata;
 	EAVL_context_common_t*	self;
+	uintptr_t		generation;	/* Tree's, when last set	*/
 	};
 typedef unsigned int		EAVL_dir_t;
 typedef unsigned int		EAVL_order_t;
 typedef unsigned int		EAVL_rel_t;
 
+typedef int (*EAVL_cbJob_t)(
+		unsigned int		index,
+		void*			jobdata
+		);
+
+typedef int (*EAVL_cbRun_t)(
+		unsigned int		count,
+		EAVL_cbJob_t		job,
+		void*			jobdata,
+		void*			cbdata
+		);
+
+typedef int64_t			EAVL_aug_value_t;
+typedef struct EAVL_monoid	EAVL_monoid_t;
+struct EAVL_monoid
+	{
+	EAVL_aug_value_t	(*combine)(
+			EAVL_aug_value_t	left,
+			EAVL_aug_value_t	right
+			);
+	EAVL_aug_value_t	identity;	/* combine(identity, x) == x	*/
+	};
+
+
+extern const EAVL_monoid_t	EAVL_Monoid_Sum;
+extern const EAVL_monoid_t	EAVL_Monoid_Min;
+extern const EAVL_monoid_t	EAVL_Monoid_Max;
+
 
 #define EAVL_ADDR(ADDR)		((uintptr_t)(ADDR) & ~(uintptr_t)0x1u)
 #define EAVL_NODE(A)		((EAVL_node_t *)EAVL_ADDR(A))
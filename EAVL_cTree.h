@@ -49,13 +49,24 @@
 
 typedef struct EAVLc_tree	EAVLc_tree_t;
 typedef struct EAVLc_context	EAVLc_context_t;
+typedef struct EAVLc_cursor	EAVLc_cursor_t;
+typedef struct EAVLc_aug_node	EAVLc_aug_node_t;
 typedef struct
 	{
 	EAVL_node_t		EAVLnode;
 	uintptr_t		references;
 	}			EAVLc_node_t;
 typedef struct EAVLc_cbset	EAVLc_cbset_t;
+typedef struct EAVLc_version	EAVLc_version_t;
+typedef struct EAVLc_epoch	EAVLc_epoch_t;
+typedef struct EAVLc_epoch_reader	EAVLc_epoch_reader_t;
 typedef EAVLc_node_t*		EAVLc_pathelement_t;
+typedef struct
+	{
+	uintptr_t		nodes;		/* Nodes in the tree		*/
+	uintptr_t		unique;		/* Nodes in no other tree	*/
+	uintptr_t		shared;		/* Nodes in other trees also	*/
+	}			EAVLc_usage_t;
 
 typedef EAVL_dir_t (*EAVLc_cbCompare_t)(
 		void*			ref_value,
@@ -88,6 +99,11 @@ typedef int (*EAVLc_cbRelease_t)(
 		void*			cbdata
 		);
 
+typedef int (*EAVLc_cbVisit_t)(
+		EAVLc_node_t*		node,
+		void*			cbdata
+		);
+
 typedef EAVLc_pathelement_t* (*EAVLc_cbPathe_t)(
 		unsigned int		index,
 		unsigned int		param,
@@ -99,6 +115,8 @@ struct EAVLc_tree
 	{
 	EAVLc_node_t*		root;
 	EAVLc_cbset_t*		cbset;
+	uintptr_t		count;		/* Nodes in the tree		*/
+	uintptr_t		unique;		/* Unshared nodes; lower bound	*/
 	EAVL_tree_common_t	common;
 	};
 
@@ -109,6 +127,25 @@ struct EAVLc_context
 	EAVL_context_common_t	common;
 	unsigned int		pathlen;
 	EAVLc_cbPathe_t		cbpathe;
+	unsigned int		vectored;	/* cbpathe hands out vectors	*/
+	};
+
+struct EAVLc_cursor
+	{
+	EAVLc_tree_t*		tree;
+	EAVLc_node_t*		recent;
+	void*			cbdata;
+	unsigned int		pathlen;
+	EAVLc_node_t*		path[EAVL_HEIGHT_MAX];	/* Ancestors of recent	*/
+	};
+
+struct EAVLc_aug_node
+	{
+	EAVLc_node_t		node;		/* Must be first		*/
+	uintptr_t		count;		/* Nodes in subtree		*/
+	EAVL_aug_value_t	value;		/* Of this node			*/
+	EAVL_aug_value_t	total;		/* Of subtree, in order		*/
+	const EAVL_monoid_t*	monoid;
 	};
 
 struct EAVLc_cbset
@@ -117,12 +154,48 @@ struct EAVLc_cbset
 	EAVLc_cbDup_t		dup;
 	EAVLc_cbFixup_t		fixup;
 	EAVLc_cbVerify_t	verify;
+	EAVLc_cbRelease_t	release;
+	};
+
+struct EAVLc_version
+	{
+	EAVLc_tree_t		tree;		/* Writer's working version	*/
+	EAVLc_node_t*		published;	/* Latest published root	*/
+	uintptr_t		count;		/* Nodes in published version	*/
+	uintptr_t		sequence;	/* Odd while publishing		*/
+	uintptr_t		readers[2];	/* Pinning readers per phase	*/
+	unsigned int		phase;
+	};
+
+struct EAVLc_epoch
+	{
+	uintptr_t		global;		/* Current epoch		*/
+	EAVLc_epoch_reader_t*	readers;	/* Registered readers		*/
+	EAVLc_node_t*		limbo[3];	/* Retired nodes per epoch	*/
+	};
+
+struct EAVLc_epoch_reader
+	{
+	uintptr_t		active;		/* Entered epoch or 0		*/
+	EAVLc_epoch_reader_t*	next;
 	};
 
 
 extern unsigned int	EAVLc_Checks_Available;
 extern unsigned int	EAVLc_Checks_Enabled;
 
+extern unsigned int	EAVLc_Atomics_Available;
+
+
+int EAVLc_Checks_Sample(
+		unsigned int		checks,
+		unsigned int		interval
+		);
+
+int EAVLc_Tree_Checks(
+		EAVLc_tree_t*		tree,
+		unsigned int		checks
+		);
 
 int EAVLc_Tree_Init(
 		EAVLc_tree_t*		tree,
@@ -141,6 +214,21 @@ int EAVLc_Split(
 		EAVLc_node_t**		nodep
 		);
 
+int EAVLc_Serialize(
+		EAVLc_context_t*	context,
+		unsigned int*		countp,
+		EAVLc_node_t*		nodes[],
+		unsigned char		shape[]
+		);
+
+int EAVLc_Deserialize(
+		EAVLc_context_t*	context,
+		unsigned int		count,
+		EAVLc_node_t*		nodes[],
+		unsigned char		shape[],
+		int			fixup
+		);
+
 int EAVLc_Clear(
 		EAVLc_context_t*	context,
 		EAVLc_cbRelease_t	noderelease
@@ -150,12 +238,79 @@ int EAVLc_Release(
 		EAVLc_tree_t*		tree
 		);
 
+int EAVLc_Usage(
+		EAVLc_context_t*	context,
+		int			exact,
+		EAVLc_usage_t*		usage
+		);
+
+int EAVLc_Version_Init(
+		EAVLc_version_t*	version,
+		EAVLc_cbset_t*		cbset
+		);
+
+int EAVLc_Version_Publish(
+		EAVLc_version_t*	version,
+		EAVLc_context_t*	context,
+		EAVLc_cbRelease_t	cbrelease
+		);
+
+int EAVLc_Version_Pin(
+		EAVLc_version_t*	version,
+		EAVLc_tree_t*		tree
+		);
+
+int EAVLc_Version_Read(
+		EAVLc_version_t*	version,
+		EAVLc_tree_t*		tree
+		);
+
+int EAVLc_Epoch_Init(
+		EAVLc_epoch_t*		epoch
+		);
+
+int EAVLc_Epoch_Register(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_epoch_reader_t*	reader
+		);
+
+int EAVLc_Epoch_Unregister(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_epoch_reader_t*	reader
+		);
+
+int EAVLc_Epoch_Enter(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_epoch_reader_t*	reader
+		);
+
+int EAVLc_Epoch_Leave(
+		EAVLc_epoch_reader_t*	reader
+		);
+
+int EAVLc_Epoch_Retire(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_node_t*		node
+		);
+
+int EAVLc_Epoch_Reclaim(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_cbRelease_t	cbrelease,
+		void*			cbdata
+		);
+
 int EAVLc_Context_Init(
 		EAVLc_context_t*	context,
 		EAVLc_cbPathe_t		cbpathe,
 		void*			cbdata
 		);
 
+int EAVLc_Context_Init_Vectored(
+		EAVLc_context_t*	context,
+		EAVLc_cbPathe_t		cbpathe,
+		void*			cbdata
+		);
+
 int EAVLc_Context_Associate(
 		EAVLc_context_t*	context,
 		EAVLc_tree_t*		tree
@@ -165,6 +320,10 @@ int EAVLc_Context_Disassociate(
 		EAVLc_context_t*	context
 		);
 
+int EAVLc_Context_Reseek(
+		EAVLc_context_t*	context
+		);
+
 int EAVLc_Insert(
 		EAVLc_context_t*	context,
 		EAVLc_node_t*		node,
@@ -207,6 +366,114 @@ int EAVLc_Fixup(
 		EAVLc_context_t*	context
 		);
 
+int EAVLc_Fixup_All(
+		EAVLc_context_t*	context,
+		unsigned int		nthreads,
+		EAVL_cbRun_t		cbrun
+		);
+
+int EAVLc_Cursor_Init(
+		EAVLc_cursor_t*		cursor,
+		EAVLc_tree_t*		tree,
+		void*			cbdata
+		);
+
+int EAVLc_Cursor_Find(
+		EAVLc_cursor_t*		cursor,
+		EAVL_rel_t		rel,
+		EAVLc_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLc_node_t*		ref_node,
+		EAVLc_node_t**		resultp
+		);
+
+int EAVLc_Cursor_First(
+		EAVLc_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLc_node_t**		resultp
+		);
+#define EAVLc_Cursor_Last(C, D, R)					\
+	EAVLc_Cursor_First((C), EAVL_DIR_OTHER((D)), (R))
+
+int EAVLc_Cursor_Next(
+		EAVLc_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLc_node_t**		resultp
+		);
+#define EAVLc_Cursor_Prev(C, D, R)					\
+	EAVLc_Cursor_Next((C), EAVL_DIR_OTHER((D)), (R))
+
+int EAVLc_Verify(
+		EAVLc_context_t*	context,
+		unsigned int		nthreads,
+		EAVL_cbRun_t		cbrun,
+		EAVLc_node_t*		path[],
+		unsigned int*		pathlenp
+		);
+
+int EAVLc_Traverse_Parallel(
+		EAVLc_context_t*	context,
+		EAVL_dir_t		dir,
+		EAVL_order_t		order,
+		unsigned int		nthreads,
+		EAVLc_cbVisit_t		cbvisit,
+		EAVL_cbRun_t		cbrun
+		);
+
+int EAVLc_Aug_Init(
+		EAVLc_aug_node_t*	aug,
+		const EAVL_monoid_t*	monoid,
+		EAVL_aug_value_t	value
+		);
+
+int EAVLc_Aug_Fixup(
+		EAVLc_node_t*		node,
+		EAVLc_node_t*		childL,
+		EAVLc_node_t*		childR,
+		void*			cbdata
+		);
+
+int EAVLc_Aug_Verify(
+		EAVLc_node_t*		node,
+		EAVLc_node_t*		childL,
+		EAVLc_node_t*		childR,
+		void*			cbdata
+		);
+
+int EAVLc_Aug_Range(
+		EAVLc_context_t*	context,
+		EAVLc_cbCompare_t	compare,
+		void*			lo_value,
+		EAVLc_node_t*		lo_node,
+		void*			hi_value,
+		EAVLc_node_t*		hi_node,
+		EAVL_aug_value_t*	totalp
+		);
+
+int EAVLc_Rank(
+		EAVLc_context_t*	context,
+		EAVLc_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLc_node_t*		ref_node,
+		uintptr_t*		rankp
+		);
+
+int EAVLc_Select(
+		EAVLc_context_t*	context,
+		uintptr_t		index,
+		EAVLc_node_t**		resultp
+		);
+
+int EAVLc_Count_Range(
+		EAVLc_context_t*	context,
+		EAVLc_cbCompare_t	compare,
+		void*			lo_value,
+		EAVLc_node_t*		lo_node,
+		void*			hi_value,
+		EAVLc_node_t*		hi_node,
+		uintptr_t*		countp
+		);
+
 
 #define EAVLc_GET_CHILD(NODE, DIR)					\
 	(EAVLc_node_t*)EAVL_GET_CHILD(&(NODE)->EAVLnode, (DIR))
@@ -214,8 +481,12 @@ int EAVLc_Fixup(
 
 #define EAVLc_GET_REFS(NODE)		((NODE)->references+1)
 
+#define EAVLc_USAGE_BYTES(USAGE, SIZE)	((USAGE)->unique * (SIZE))
+
 #define EAVLc_CONTEXT_TREE(CONTEXT)	(EAVLc_tree_t*)((CONTEXT)->tree)
 #define EAVLc_TREE_ROOT(TREE)		(EAVLc_node_t*)((TREE)->root)
 
+#define EAVLc_AUG(NODE)			((EAVLc_aug_node_t*)(NODE))
+
 
 #endif	/* _EAVL_CTREE_H */
@@ -49,8 +49,16 @@
 
 typedef struct EAVLp_tree	EAVLp_tree_t;
 typedef struct EAVLp_context	EAVLp_context_t;
+typedef struct EAVLp_cursor	EAVLp_cursor_t;
+typedef struct EAVLp_aug_node	EAVLp_aug_node_t;
+typedef struct EAVLp_interval	EAVLp_interval_t;
 typedef EAVL_pnode_t		EAVLp_node_t;
 typedef struct EAVLp_cbset	EAVLp_cbset_t;
+typedef struct EAVLp_seq	EAVLp_seq_t;
+typedef struct EAVLp_shard	EAVLp_shard_t;
+typedef struct EAVLp_shards	EAVLp_shards_t;
+typedef struct EAVLp_combiner	EAVLp_combiner_t;
+typedef struct EAVLp_combiner_slot	EAVLp_combiner_slot_t;
 
 typedef EAVL_dir_t (*EAVLp_cbCompare_t)(
 		void*			ref_value,
@@ -78,12 +86,18 @@ typedef int (*EAVLp_cbRelease_t)(
 		void*			cbdata
 		);
 
+typedef int (*EAVLp_cbVisit_t)(
+		EAVLp_node_t*		node,
+		void*			cbdata
+		);
+
 
 struct EAVLp_tree
 	{
 	EAVLp_node_t*		root;
 	EAVLp_cbset_t*		cbset;
 	EAVL_tree_common_t	common;
+	unsigned int		deferred;	/* Fixups wait for EAVLp_Fixup	*/
 	};
 
 struct EAVLp_context
@@ -93,6 +107,30 @@ struct EAVLp_context
 	EAVL_context_common_t	common;
 	};
 
+struct EAVLp_cursor
+	{
+	EAVLp_tree_t*		tree;
+	EAVLp_node_t*		recent;
+	void*			cbdata;
+	};
+
+struct EAVLp_aug_node
+	{
+	EAVLp_node_t		node;		/* Must be first		*/
+	uintptr_t		count;		/* Nodes in subtree		*/
+	EAVL_aug_value_t	value;		/* Of this node			*/
+	EAVL_aug_value_t	total;		/* Of subtree, in order		*/
+	const EAVL_monoid_t*	monoid;
+	};
+
+struct EAVLp_interval
+	{
+	EAVLp_node_t		node;		/* Must be first		*/
+	EAVL_aug_value_t	start;
+	EAVL_aug_value_t	end;		/* Inclusive			*/
+	EAVL_aug_value_t	max_end;	/* Of subtree			*/
+	};
+
 struct EAVLp_cbset
 	{
 	EAVLp_cbCompare_t	compare;
@@ -100,11 +138,60 @@ struct EAVLp_cbset
 	EAVLp_cbVerify_t	verify;
 	};
 
+struct EAVLp_seq
+	{
+	EAVLp_tree_t		tree;
+	uintptr_t		sequence;	/* Odd while writing		*/
+	};
+
+struct EAVLp_shard
+	{
+	EAVLp_tree_t		tree;
+	EAVLp_node_t*		bound;		/* Least key; NULL in shard 0	*/
+	uintptr_t		count;		/* Nodes in the shard		*/
+	uintptr_t		lock;
+	};
+
+struct EAVLp_shards
+	{
+	EAVLp_shard_t*		shard;
+	unsigned int		count;		/* Number of shards		*/
+	};
+
+struct EAVLp_combiner
+	{
+	EAVLp_tree_t		tree;
+	void*			cbdata;
+	EAVLp_combiner_slot_t*	slots;		/* Registered slots		*/
+	uintptr_t		lock;
+	};
+
+struct EAVLp_combiner_slot
+	{
+	EAVLp_node_t*		node;
+	EAVLp_node_t*		resultnode;
+	int			result;
+	unsigned int		op;
+	uintptr_t		pending;	/* Request not yet done		*/
+	EAVLp_combiner_slot_t*	next;		/* Registered slots		*/
+	EAVLp_combiner_slot_t*	batch;		/* Requests being combined	*/
+	};
+
 
 extern unsigned int	EAVLp_Checks_Available;
 extern unsigned int	EAVLp_Checks_Enabled;
 
 
+int EAVLp_Checks_Sample(
+		unsigned int		checks,
+		unsigned int		interval
+		);
+
+int EAVLp_Tree_Checks(
+		EAVLp_tree_t*		tree,
+		unsigned int		checks
+		);
+
 int EAVLp_Tree_Init(
 		EAVLp_tree_t*		tree,
 		EAVLp_tree_t*		existing,
@@ -117,6 +204,21 @@ int EAVLp_Load(
 		EAVLp_node_t*		nodes[]
 		);
 
+int EAVLp_Serialize(
+		EAVLp_context_t*	context,
+		unsigned int*		countp,
+		EAVLp_node_t*		nodes[],
+		unsigned char		shape[]
+		);
+
+int EAVLp_Deserialize(
+		EAVLp_context_t*	context,
+		unsigned int		count,
+		EAVLp_node_t*		nodes[],
+		unsigned char		shape[],
+		int			fixup
+		);
+
 int EAVLp_Clear(
 		EAVLp_context_t*	context,
 		EAVLp_cbRelease_t	noderelease
@@ -140,6 +242,10 @@ int EAVLp_Context_Disassociate(
 		EAVLp_context_t*	context
 		);
 
+int EAVLp_Context_Reseek(
+		EAVLp_context_t*	context
+		);
+
 int EAVLp_Insert(
 		EAVLp_context_t*	context,
 		EAVLp_node_t*		node,
@@ -182,15 +288,244 @@ int EAVLp_Fixup(
 		EAVLp_context_t*	context
 		);
 
+int EAVLp_Fixup_All(
+		EAVLp_context_t*	context,
+		unsigned int		nthreads,
+		EAVL_cbRun_t		cbrun
+		);
+
+int EAVLp_Fixup_Deferred(
+		EAVLp_context_t*	context,
+		unsigned int		deferred
+		);
+
+int EAVLp_Cursor_Init(
+		EAVLp_cursor_t*		cursor,
+		EAVLp_tree_t*		tree,
+		void*			cbdata
+		);
+
+int EAVLp_Cursor_Find(
+		EAVLp_cursor_t*		cursor,
+		EAVL_rel_t		rel,
+		EAVLp_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		resultp
+		);
+
+int EAVLp_Cursor_First(
+		EAVLp_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLp_node_t**		resultp
+		);
+#define EAVLp_Cursor_Last(C, D, R)					\
+	EAVLp_Cursor_First((C), EAVL_DIR_OTHER((D)), (R))
+
+int EAVLp_Cursor_Next(
+		EAVLp_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLp_node_t**		resultp
+		);
+#define EAVLp_Cursor_Prev(C, D, R)					\
+	EAVLp_Cursor_Next((C), EAVL_DIR_OTHER((D)), (R))
+
+int EAVLp_Seq_Init(
+		EAVLp_seq_t*		seq,
+		EAVLp_cbset_t*		cbset
+		);
+
+int EAVLp_Seq_Write_Begin(
+		EAVLp_seq_t*		seq
+		);
+
+int EAVLp_Seq_Write_End(
+		EAVLp_seq_t*		seq
+		);
+
+int EAVLp_Seq_Find(
+		EAVLp_seq_t*		seq,
+		EAVL_rel_t		rel,
+		EAVLp_cbCompare_t	compare,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		resultp
+		);
+
+int EAVLp_Shards_Init(
+		EAVLp_shards_t*		shards,
+		unsigned int		count,
+		EAVLp_shard_t		shard[],
+		EAVLp_node_t*		bounds[],
+		EAVLp_cbset_t*		cbset
+		);
+
+int EAVLp_Shards_Insert(
+		EAVLp_shards_t*		shards,
+		void*			cbdata,
+		EAVLp_node_t*		node,
+		EAVLp_node_t**		resultp
+		);
+
+int EAVLp_Shards_Remove(
+		EAVLp_shards_t*		shards,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		nodep
+		);
+
+int EAVLp_Shards_Find(
+		EAVLp_shards_t*		shards,
+		EAVL_rel_t		rel,
+		EAVLp_cbCompare_t	compare,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		resultp
+		);
+
+int EAVLp_Shards_Rebalance(
+		EAVLp_shards_t*		shards,
+		void*			cbdata,
+		unsigned int		index,
+		EAVLp_node_t*		bound,
+		EAVLp_node_t**		oldp
+		);
+
+int EAVLp_Combiner_Init(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_cbset_t*		cbset,
+		void*			cbdata
+		);
+
+int EAVLp_Combiner_Register(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot
+		);
+
+int EAVLp_Combiner_Unregister(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot
+		);
+
+int EAVLp_Combiner_Insert(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot,
+		EAVLp_node_t*		node,
+		EAVLp_node_t**		resultp
+		);
+
+int EAVLp_Combiner_Remove(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		nodep
+		);
+
+int EAVLp_Aug_Init(
+		EAVLp_aug_node_t*	aug,
+		const EAVL_monoid_t*	monoid,
+		EAVL_aug_value_t	value
+		);
+
+int EAVLp_Aug_Fixup(
+		EAVLp_node_t*		node,
+		EAVLp_node_t*		childL,
+		EAVLp_node_t*		childR,
+		void*			cbdata
+		);
+
+int EAVLp_Aug_Verify(
+		EAVLp_node_t*		node,
+		EAVLp_node_t*		childL,
+		EAVLp_node_t*		childR,
+		void*			cbdata
+		);
+
+int EAVLp_Aug_Range(
+		EAVLp_context_t*	context,
+		EAVLp_cbCompare_t	compare,
+		void*			lo_value,
+		EAVLp_node_t*		lo_node,
+		void*			hi_value,
+		EAVLp_node_t*		hi_node,
+		EAVL_aug_value_t*	totalp
+		);
+
+int EAVLp_Rank(
+		EAVLp_context_t*	context,
+		EAVLp_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		uintptr_t*		rankp
+		);
+
+int EAVLp_Select(
+		EAVLp_context_t*	context,
+		uintptr_t		index,
+		EAVLp_node_t**		resultp
+		);
+
+int EAVLp_Count_Range(
+		EAVLp_context_t*	context,
+		EAVLp_cbCompare_t	compare,
+		void*			lo_value,
+		EAVLp_node_t*		lo_node,
+		void*			hi_value,
+		EAVLp_node_t*		hi_node,
+		uintptr_t*		countp
+		);
+
+int EAVLp_Interval_Init(
+		EAVLp_interval_t*	interval,
+		EAVL_aug_value_t	start,
+		EAVL_aug_value_t	end
+		);
+
+EAVL_dir_t EAVLp_Interval_Compare(
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t*		node,
+		void*			cbdata
+		);
+
+int EAVLp_Interval_Fixup(
+		EAVLp_node_t*		node,
+		EAVLp_node_t*		childL,
+		EAVLp_node_t*		childR,
+		void*			cbdata
+		);
+
+int EAVLp_Interval_Verify(
+		EAVLp_node_t*		node,
+		EAVLp_node_t*		childL,
+		EAVLp_node_t*		childR,
+		void*			cbdata
+		);
+
+int EAVLp_Interval_Overlap(
+		EAVLp_context_t*	context,
+		EAVL_aug_value_t	lo,
+		EAVL_aug_value_t	hi,
+		EAVLp_cbVisit_t		cbvisit
+		);
+#define EAVLp_Interval_Stab(C, P, V)					\
+	EAVLp_Interval_Overlap((C), (P), (P), (V))
+
 
 #define EAVLp_GET_CHILD(NODE, DIR)					\
 	(EAVLp_node_t*)EAVL_GET_CHILD(&(NODE)->EAVLnode, (DIR))
 #define EAVLp_GET_BAL(NODE)		EAVL_GET_BAL(&(NODE)->EAVLnode)
 
-#define EAVLp_GET_PARENT(NODE)		(EAVLp_node_t *)((NODE)->parent)
+#define EAVLp_GET_PARENT(NODE)		(EAVLp_node_t *)EAVL_ADDR((NODE)->parent)
 
 #define EAVLp_CONTEXT_TREE(CONTEXT)	(EAVLp_tree_t*)((CONTEXT)->tree)
 #define EAVLp_TREE_ROOT(TREE)		(EAVLp_node_t*)((TREE)->root)
 
+#define EAVLp_AUG(NODE)			((EAVLp_aug_node_t*)(NODE))
+#define EAVLp_INTERVAL(NODE)		((EAVLp_interval_t*)(NODE))
+
 
 #endif	/* _EAVL_PTREE_H */
@@ -0,0 +1,378 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#ifndef _EAVL_RTREE_H
+#define _EAVL_RTREE_H 1
+
+
+#include <stddef.h>
+
+#include "EAVL.h"
+
+
+/*
+** The "r" (relative) tree type links nodes with self-relative offsets
+** instead of addresses so that a tree, together with its root link,
+** may be placed in memory that is mapped at different addresses in
+** different processes.
+*/
+typedef struct EAVLr_tree	EAVLr_tree_t;
+typedef struct EAVLr_context	EAVLr_context_t;
+typedef struct EAVLr_cursor	EAVLr_cursor_t;
+typedef struct
+	{
+	EAVL_node_t		EAVLnode;
+	EAVL_node_spec_t	parent;
+	}			EAVLr_node_t;
+typedef struct
+	{
+	EAVL_node_spec_t	link;
+	}			EAVLr_root_t;
+typedef struct EAVLr_cbset	EAVLr_cbset_t;
+typedef struct EAVLr_image	EAVLr_image_t;
+typedef struct EAVLr_image_copy	EAVLr_image_copy_t;
+
+typedef EAVL_dir_t (*EAVLr_cbCompare_t)(
+		void*			ref_value,
+		EAVLr_node_t*		ref_node,
+		EAVLr_node_t*		node,
+		void*			cbdata
+		);
+
+typedef int (*EAVLr_cbFixup_t)(
+		EAVLr_node_t*		node,
+		EAVLr_node_t*		childL,
+		EAVLr_node_t*		childR,
+		void*			cbdata
+		);
+
+typedef int (*EAVLr_cbVerify_t)(
+		EAVLr_node_t*		node,
+		EAVLr_node_t*		childL,
+		EAVLr_node_t*		childR,
+		void*			cbdata
+		);
+
+typedef int (*EAVLr_cbRelease_t)(
+		EAVLr_node_t*		node,
+		void*			cbdata
+		);
+
+typedef int (*EAVLr_cbSync_t)(
+		void*			addr,
+		size_t			length,
+		void*			cbdata
+		);
+
+
+struct EAVLr_tree
+	{
+	EAVLr_root_t*		root;
+	EAVLr_cbset_t*		cbset;
+	EAVLr_image_t*		image;		/* tracked image, or NULL	*/
+	size_t			nodeoffset;	/* EAVLr_node_t in a node	*/
+	size_t			nodesize;	/* bytes per node		*/
+	EAVL_tree_common_t	common;
+	};
+
+struct EAVLr_context
+	{
+	EAVLr_tree_t*		tree;
+	EAVLr_node_t*		recent;
+	EAVL_context_common_t	common;
+	};
+
+struct EAVLr_cursor
+	{
+	EAVLr_tree_t*		tree;
+	EAVLr_node_t*		recent;
+	void*			cbdata;
+	};
+
+struct EAVLr_cbset
+	{
+	EAVLr_cbCompare_t	compare;
+	EAVLr_cbFixup_t		fixup;
+	EAVLr_cbVerify_t	verify;
+	};
+
+/*
+** Image header; located at the start of a (file) mapping and followed by
+** the two committed copies and the data region holding the nodes. The
+** members before current are fixed by EAVLr_Image_Init().
+*/
+struct EAVLr_image
+	{
+	char			magic[8];	/* EAVLr_IMAGE_MAGIC		*/
+	uint32_t		version;	/* EAVLr_IMAGE_VERSION		*/
+	uint32_t		byteorder;	/* EAVLr_IMAGE_BYTEORDER	*/
+	uint32_t		linksize;	/* sizeof(EAVL_node_spec_t)	*/
+	uint32_t		block;		/* bytes per checksum block	*/
+	uint64_t		size;		/* total image bytes		*/
+	uint64_t		header;		/* header bytes; data offset	*/
+	uint32_t		blocks;		/* data region blocks		*/
+	uint32_t		marks;		/* bytes per block bitmap	*/
+	uint64_t		copy[2];	/* committed copy offsets	*/
+	uint32_t		current;	/* newest committed copy	*/
+	uint32_t		reserved;
+	EAVLr_root_t		root;		/* live root link		*/
+	unsigned char		mark[];		/* dirty and stale bitmaps	*/
+	};
+
+/*
+** A committed root link and data region checksums; the valid copy with the
+** highest sequence describes the image.
+*/
+struct EAVLr_image_copy
+	{
+	uint64_t		sequence;	/* sync sequence number		*/
+	EAVL_node_spec_t	root;		/* root link, as root.link	*/
+	uint32_t		crc;		/* fixed header and copy crc	*/
+	uint32_t		blockcrc[];	/* data region block checksums	*/
+	};
+
+#define EAVLr_IMAGE_MAGIC	"EAVLrimg"
+#define EAVLr_IMAGE_VERSION	(2)
+#define EAVLr_IMAGE_BYTEORDER	(0x01020304u)
+
+
+extern unsigned int	EAVLr_Checks_Available;
+extern unsigned int	EAVLr_Checks_Enabled;
+
+
+int EAVLr_Checks_Sample(
+		unsigned int		checks,
+		unsigned int		interval
+		);
+
+int EAVLr_Tree_Checks(
+		EAVLr_tree_t*		tree,
+		unsigned int		checks
+		);
+
+int EAVLr_Tree_Init(
+		EAVLr_tree_t*		tree,
+		EAVLr_root_t*		root,
+		EAVLr_tree_t*		existing,
+		EAVLr_cbset_t*		cbset
+		);
+
+int EAVLr_Load(
+		EAVLr_context_t*	context,
+		unsigned int		node_count,
+		EAVLr_node_t*		nodes[]
+		);
+
+int EAVLr_Serialize(
+		EAVLr_context_t*	context,
+		unsigned int*		countp,
+		EAVLr_node_t*		nodes[],
+		unsigned char		shape[]
+		);
+
+int EAVLr_Deserialize(
+		EAVLr_context_t*	context,
+		unsigned int		count,
+		EAVLr_node_t*		nodes[],
+		unsigned char		shape[],
+		int			fixup
+		);
+
+int EAVLr_Clear(
+		EAVLr_context_t*	context,
+		EAVLr_cbRelease_t	noderelease
+		);
+
+int EAVLr_Release(
+		EAVLr_tree_t*		tree
+		);
+
+int EAVLr_Context_Init(
+		EAVLr_context_t*	context,
+		void*			cbdata
+		);
+
+int EAVLr_Context_Associate(
+		EAVLr_context_t*	context,
+		EAVLr_tree_t*		tree
+		);
+
+int EAVLr_Context_Disassociate(
+		EAVLr_context_t*	context
+		);
+
+int EAVLr_Context_Reseek(
+		EAVLr_context_t*	context
+		);
+
+int EAVLr_Insert(
+		EAVLr_context_t*	context,
+		EAVLr_node_t*		node,
+		EAVLr_node_t**		resultp
+		);
+
+int EAVLr_Remove(
+		EAVLr_context_t*	context,
+		EAVLr_node_t**		nodep
+		);
+
+int EAVLr_Find(
+		EAVLr_context_t*	context,
+		EAVL_rel_t		rel,
+		EAVLr_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLr_node_t*		ref_node,
+		EAVLr_node_t**		resultp
+		);
+
+int EAVLr_First(
+		EAVLr_context_t*	context,
+		EAVL_dir_t		dir,
+		EAVL_order_t		order,
+		EAVLr_node_t**		resultp
+		);
+#define EAVLr_Last(C, D, O, R)						\
+	EAVLr_First((C), EAVL_DIR_OTHER((D)), EAVL_ORDER_INVERSE((O)), (R))
+
+int EAVLr_Next(
+		EAVLr_context_t*	context,
+		EAVL_dir_t		dir,
+		EAVL_order_t		order,
+		EAVLr_node_t**		resultp
+		);
+#define EAVLr_Prev(C, D, O, R)						\
+	EAVLr_Next((C), EAVL_DIR_OTHER((D)), EAVL_ORDER_INVERSE((O)), (R))
+
+int EAVLr_Fixup(
+		EAVLr_context_t*	context
+		);
+
+int EAVLr_Cursor_Init(
+		EAVLr_cursor_t*		cursor,
+		EAVLr_tree_t*		tree,
+		void*			cbdata
+		);
+
+int EAVLr_Cursor_Find(
+		EAVLr_cursor_t*		cursor,
+		EAVL_rel_t		rel,
+		EAVLr_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLr_node_t*		ref_node,
+		EAVLr_node_t**		resultp
+		);
+
+int EAVLr_Cursor_First(
+		EAVLr_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLr_node_t**		resultp
+		);
+#define EAVLr_Cursor_Last(C, D, R)					\
+	EAVLr_Cursor_First((C), EAVL_DIR_OTHER((D)), (R))
+
+int EAVLr_Cursor_Next(
+		EAVLr_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLr_node_t**		resultp
+		);
+#define EAVLr_Cursor_Prev(C, D, R)					\
+	EAVLr_Cursor_Next((C), EAVL_DIR_OTHER((D)), (R))
+
+int EAVLr_Image_Init(
+		EAVLr_image_t*		image,
+		size_t			size,
+		size_t			block
+		);
+
+int EAVLr_Image_Open(
+		EAVLr_image_t*		image,
+		size_t			size,
+		int			verify
+		);
+
+int EAVLr_Image_Sync(
+		EAVLr_image_t*		image,
+		EAVLr_cbSync_t		cbsync,
+		void*			cbdata
+		);
+
+int EAVLr_Image_Track(
+		EAVLr_image_t*		image,
+		EAVLr_tree_t*		tree,
+		size_t			nodeoffset,
+		size_t			nodesize
+		);
+
+int EAVLr_Image_Dirty(
+		EAVLr_image_t*		image,
+		void*			addr,
+		size_t			length
+		);
+
+
+/*
+** A link is the offset of the target from the address of the structure
+** holding the link; an offset of 0 is a NULL link.
+*/
+#define EAVLr_LINK(BASE, SPEC)						\
+	((EAVL_ADDR((SPEC)))						\
+		? (EAVLr_node_t*)((uintptr_t)(BASE) + EAVL_ADDR((SPEC)))	\
+		: (EAVLr_node_t*)NULL					\
+		)
+
+#define EAVLr_GET_CHILD(NODE, DIR)					\
+	EAVLr_LINK((NODE), (NODE)->EAVLnode.child[(DIR)])
+#define EAVLr_GET_BAL(NODE)		EAVL_GET_BAL(&(NODE)->EAVLnode)
+
+#define EAVLr_GET_PARENT(NODE)		EAVLr_LINK((NODE), (NODE)->parent)
+
+#define EAVLr_ROOT_INIT(ROOT)		((ROOT)->link = 0)
+
+#define EAVLr_CONTEXT_TREE(CONTEXT)	(EAVLr_tree_t*)((CONTEXT)->tree)
+#define EAVLr_TREE_ROOT(TREE)		EAVLr_LINK((TREE)->root, (TREE)->root->link)
+
+#define EAVLr_IMAGE_ROOT(IMAGE)		(&(IMAGE)->root)
+#define EAVLr_IMAGE_DATA(IMAGE)		((void*)((char*)(IMAGE) + (IMAGE)->header))
+#define EAVLr_IMAGE_DATA_SIZE(IMAGE)	((size_t)((IMAGE)->size - (IMAGE)->header))
+
+
+#endif	/* _EAVL_RTREE_H */
@@ -49,6 +49,8 @@
 
 typedef struct EAVLs_tree	EAVLs_tree_t;
 typedef struct EAVLs_context	EAVLs_context_t;
+typedef struct EAVLs_cursor	EAVLs_cursor_t;
+typedef struct EAVLs_aug_node	EAVLs_aug_node_t;
 typedef struct
 	{
 	EAVL_node_t		EAVLnode;
@@ -103,6 +105,25 @@ struct EAVLs_context
 	EAVL_context_common_t	common;
 	unsigned int		pathlen;
 	EAVLs_cbPathe_t		cbpathe;
+	unsigned int		vectored;	/* cbpathe hands out vectors	*/
+	};
+
+struct EAVLs_cursor
+	{
+	EAVLs_tree_t*		tree;
+	EAVLs_node_t*		recent;
+	void*			cbdata;
+	unsigned int		pathlen;
+	EAVLs_node_t*		path[EAVL_HEIGHT_MAX];	/* Ancestors of recent	*/
+	};
+
+struct EAVLs_aug_node
+	{
+	EAVLs_node_t		node;		/* Must be first		*/
+	uintptr_t		count;		/* Nodes in subtree		*/
+	EAVL_aug_value_t	value;		/* Of this node			*/
+	EAVL_aug_value_t	total;		/* Of subtree, in order		*/
+	const EAVL_monoid_t*	monoid;
 	};
 
 struct EAVLs_cbset
@@ -117,6 +138,16 @@ extern unsigned int	EAVLs_Checks_Available;
 extern unsigned int	EAVLs_Checks_Enabled;
 
 
+int EAVLs_Checks_Sample(
+		unsigned int		checks,
+		unsigned int		interval
+		);
+
+int EAVLs_Tree_Checks(
+		EAVLs_tree_t*		tree,
+		unsigned int		checks
+		);
+
 int EAVLs_Tree_Init(
 		EAVLs_tree_t*		tree,
 		EAVLs_tree_t*		existing,
@@ -129,6 +160,21 @@ int EAVLs_Load(
 		EAVLs_node_t*		nodes[]
 		);
 
+int EAVLs_Serialize(
+		EAVLs_context_t*	context,
+		unsigned int*		countp,
+		EAVLs_node_t*		nodes[],
+		unsigned char		shape[]
+		);
+
+int EAVLs_Deserialize(
+		EAVLs_context_t*	context,
+		unsigned int		count,
+		EAVLs_node_t*		nodes[],
+		unsigned char		shape[],
+		int			fixup
+		);
+
 int EAVLs_Clear(
 		EAVLs_context_t*	context,
 		EAVLs_cbRelease_t	noderelease
@@ -144,6 +190,12 @@ int EAVLs_Context_Init(
 		void*			cbdata
 		);
 
+int EAVLs_Context_Init_Vectored(
+		EAVLs_context_t*	context,
+		EAVLs_cbPathe_t		cbpathe,
+		void*			cbdata
+		);
+
 int EAVLs_Context_Associate(
 		EAVLs_context_t*	context,
 		EAVLs_tree_t*		tree
@@ -153,6 +205,10 @@ int EAVLs_Context_Disassociate(
 		EAVLs_context_t*	context
 		);
 
+int EAVLs_Context_Reseek(
+		EAVLs_context_t*	context
+		);
+
 int EAVLs_Insert(
 		EAVLs_context_t*	context,
 		EAVLs_node_t*		node,
@@ -195,6 +251,97 @@ int EAVLs_Fixup(
 		EAVLs_context_t*	context
 		);
 
+int EAVLs_Fixup_All(
+		EAVLs_context_t*	context,
+		unsigned int		nthreads,
+		EAVL_cbRun_t		cbrun
+		);
+
+int EAVLs_Cursor_Init(
+		EAVLs_cursor_t*		cursor,
+		EAVLs_tree_t*		tree,
+		void*			cbdata
+		);
+
+int EAVLs_Cursor_Find(
+		EAVLs_cursor_t*		cursor,
+		EAVL_rel_t		rel,
+		EAVLs_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLs_node_t*		ref_node,
+		EAVLs_node_t**		resultp
+		);
+
+int EAVLs_Cursor_First(
+		EAVLs_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLs_node_t**		resultp
+		);
+#define EAVLs_Cursor_Last(C, D, R)					\
+	EAVLs_Cursor_First((C), EAVL_DIR_OTHER((D)), (R))
+
+int EAVLs_Cursor_Next(
+		EAVLs_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLs_node_t**		resultp
+		);
+#define EAVLs_Cursor_Prev(C, D, R)					\
+	EAVLs_Cursor_Next((C), EAVL_DIR_OTHER((D)), (R))
+
+int EAVLs_Aug_Init(
+		EAVLs_aug_node_t*	aug,
+		const EAVL_monoid_t*	monoid,
+		EAVL_aug_value_t	value
+		);
+
+int EAVLs_Aug_Fixup(
+		EAVLs_node_t*		node,
+		EAVLs_node_t*		childL,
+		EAVLs_node_t*		childR,
+		void*			cbdata
+		);
+
+int EAVLs_Aug_Verify(
+		EAVLs_node_t*		node,
+		EAVLs_node_t*		childL,
+		EAVLs_node_t*		childR,
+		void*			cbdata
+		);
+
+int EAVLs_Aug_Range(
+		EAVLs_context_t*	context,
+		EAVLs_cbCompare_t	compare,
+		void*			lo_value,
+		EAVLs_node_t*		lo_node,
+		void*			hi_value,
+		EAVLs_node_t*		hi_node,
+		EAVL_aug_value_t*	totalp
+		);
+
+int EAVLs_Rank(
+		EAVLs_context_t*	context,
+		EAVLs_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLs_node_t*		ref_node,
+		uintptr_t*		rankp
+		);
+
+int EAVLs_Select(
+		EAVLs_context_t*	context,
+		uintptr_t		index,
+		EAVLs_node_t**		resultp
+		);
+
+int EAVLs_Count_Range(
+		EAVLs_context_t*	context,
+		EAVLs_cbCompare_t	compare,
+		void*			lo_value,
+		EAVLs_node_t*		lo_node,
+		void*			hi_value,
+		EAVLs_node_t*		hi_node,
+		uintptr_t*		countp
+		);
+
 
 #define EAVLs_GET_CHILD(NODE, DIR)					\
 	(EAVLs_node_t*)EAVL_GET_CHILD(&(NODE)->EAVLnode, (DIR))
@@ -203,5 +350,7 @@ int EAVLs_Fixup(
 #define EAVLs_CONTEXT_TREE(CONTEXT)	(EAVLs_tree_t*)((CONTEXT)->tree)
 #define EAVLs_TREE_ROOT(TREE)		(EAVLs_node_t*)((TREE)->root)
 
+#define EAVLs_AUG(NODE)			((EAVLs_aug_node_t*)(NODE))
+
 
 #endif	/* _EAVL_STREE_H */
@@ -56,9 +56,13 @@
 #include "eavl_internal.h"
 #include "naming_internal.h"
 #include "pathe_internal.h"
+#include "serialize_internal.h"
 #include "treeload_internal.h"
 
 
+unsigned int	PUBLIC(Atomics_Available) = EAVLc_ATOMICS_AVAILABLE;
+
+
 int PUBLIC(Tree_Init)(
 		EAVLc_tree_t*		tree,
 		EAVLc_tree_t*		existing,
@@ -75,37 +79,45 @@ int PUBLIC(Tree_Init)(
 		tree->cbset = existing->cbset;
 		tree->root = existing->root;
 		REFS_INC(existing->root);
+		tree->count = existing->count;
+		tree->unique = 0;
+		existing->unique = 0;
 		}
 	else if (cbset && cbset->compare && cbset->dup)
 		{
 		tree->cbset = cbset;
 		tree->root = NULL;
+		tree->count = 0;
+		tree->unique = 0;
 		}
 	else
 		{
 		return EAVL_ERROR_PARAMETER;
 		}
 
-	tree->common.contexts = NULL;
+	CONTEXTS_INIT(tree);
 	tree->common.associations = 0;
+	tree->common.checks = EAVL_CHECK_ALL;
 
 	return EAVL_OK;
 	}
 
 
-#define NODE_DUP(NODE, PARENT, CB, CBDATA)				\
+#define NODE_DUP(NODE, PARENT, CBSET, CBDATA, DUPS)			\
 	do								\
 		{							\
 		if (GET_REFS((NODE)))					\
 			{						\
 			EAVLc_node_t*		ND_T0;			\
 			EAVLc_node_t*		ND_T1;			\
+			EAVLc_cbRelease_t	ND_release;		\
 			EAVL_dir_t		ND_bal;			\
+			unsigned int		ND_last;		\
 									\
-			CB_DUP((NODE), (CB), (CBDATA), ND_T0);		\
+			CB_DUP((NODE), (CBSET)->dup, (CBDATA), ND_T0);	\
+			(DUPS)++;					\
 			NODE_INIT(ND_T0);				\
 			SET_CHILD((PARENT), ND_T0, SID((PARENT), (NODE)));	\
-			REFS_DEC((NODE));				\
 									\
 			ND_T1 = GET_CHILD((NODE), 0);			\
 			SET_CHILD(ND_T0, ND_T1, 0);			\
@@ -117,6 +129,16 @@ int PUBLIC(Tree_Init)(
 			ND_bal = GET_BAL((NODE));			\
 			SET_BAL(ND_T0, ND_bal);				\
 									\
+			/* Other owners may have let go while copying */	\
+			REFS_PUT((NODE), ND_last);			\
+			if (ND_last)					\
+				{					\
+				REFS_PUT(GET_CHILD(ND_T0, 0), ND_last);	\
+				REFS_PUT(GET_CHILD(ND_T0, 1), ND_last);	\
+				ND_release = (CBSET)->release;		\
+				CB_RELEASE((NODE), ND_release, (CBDATA));	\
+				}					\
+									\
 			(NODE) = ND_T0;					\
 			}						\
 		} while (0)
@@ -126,9 +148,11 @@ static int PRIVATE(tree_split)(
 		EAVLc_node_t**		rootp,
 		EAVLc_node_t**		targetp,
 		unsigned int		pathlen,
-		EAVLc_cbDup_t		dup,
+		EAVLc_cbset_t*		cbset,
 		EAVLc_cbPathe_t		cbpathe,
-		void*			cbdata
+		EAVLc_pathelement_t*	pathv,
+		void*			cbdata,
+		uintptr_t*		dupsp
 		)
 	{
 	if (pathlen && GET_REFS(*rootp))
@@ -138,7 +162,7 @@ static int PRIVATE(tree_split)(
 		NODE_INIT(&fakeroot);
 		SET_CHILD(&fakeroot, *rootp, DIR_LEFT);
 
-		NODE_DUP(*rootp, &fakeroot, dup, cbdata);
+		NODE_DUP(*rootp, &fakeroot, cbset, cbdata, *dupsp);
 		if (pathlen == 1)
 			{
 			*targetp = *rootp;
@@ -160,13 +184,13 @@ static int PRIVATE(tree_split)(
 			{
 			prev = curr;
 			PATHE_GET_SAFE(pathpos, cbpathe, cbdata, curr);
-			NODE_DUP(curr, prev, dup, cbdata);
+			NODE_DUP(curr, prev, cbset, cbdata, *dupsp);
 			PATHE_SET_SAFE(pathpos, cbpathe, cbdata, curr);
 			pathpos++;
 			}
 
 		prev = curr;
-		NODE_DUP(*targetp, prev, dup, cbdata);
+		NODE_DUP(*targetp, prev, cbset, cbdata, *dupsp);
 		}
 
 	return EAVL_OK;
@@ -179,21 +203,26 @@ int PUBLIC(Split)(
 		)
 	{
 	EAVLc_node_t*		target;
+	EAVLc_pathelement_t*	pathv;
 	int			result;
 
 	CHECK_PARAM_NON_NULL(context);
 
 	CHECK_STD_PRE(context, context->tree, 1);
 
+	PATHE_VECTOR(context, pathv);
+
 	target = context->recent;
 
 	result = PRIVATE(tree_split)(
 			&context->tree->root,
 			&target,
 			context->pathlen,
-			context->tree->cbset->dup,
+			context->tree->cbset,
 			context->cbpathe,
-			context->common.cbdata
+			pathv,
+			context->common.cbdata,
+			&context->tree->unique
 			);
 	if (result == EAVL_OK)
 		{
@@ -248,8 +277,13 @@ static int PRIVATE(cb_tree_clear)(
 
 	if (GET_REFS(node))
 		{
-		REFS_DEC(node);
-		return EAVL_CB_LIMIT;
+		unsigned int		last;
+
+		REFS_PUT(node, last);
+		if (!last)
+			{
+			return EAVL_CB_LIMIT;
+			}
 		}
 
 	if (cover & ORDER_MASK_POST)
@@ -264,49 +298,71 @@ static int PRIVATE(cb_tree_clear)(
 	}
 
 
-int PUBLIC(Clear)(
-		EAVLc_context_t*	context,
-		EAVLc_cbRelease_t	cbrelease
+int PRIVATE(tree_clear)(
+		EAVLc_node_t*		root,
+		EAVLc_cbRelease_t	cbrelease,
+		EAVLc_cbPathe_t		cbpathe,
+		void*			cbdata
 		)
 	{
 	tc_cbdata_t		tccbdata;
-	EAVLc_cbPathe_t		cbpathe;
 	unsigned int		i = 1;
 	int			result = EAVL_OK;
 
-	CHECK_PARAM_NON_NULL(context);
-	CHECK_STD_PRE(context, context->tree, 0);
-
-	CONTEXT_RESET_ALL(context);
-
-	if (!context->tree->root || !cbrelease)
-		{
-		context->tree->root = NULL;
-		CONTEXT_RESET(context, 0);
-		RESULT(EAVL_OK);
-		}
-
-	cbpathe = context->cbpathe;
 	tccbdata.cbrelease = cbrelease;
-	tccbdata.cbdata = context->common.cbdata;
+	tccbdata.cbdata = cbdata;
 
 	do
 		{
 		result = PRIVATE(traverse)(
-				context->tree->root,
+				root,
 				EAVL_DIR_LEFT,
 				ORDER_MASK_PRE | ORDER_MASK_POST,
 				i,
 				&PRIVATE(cb_tree_clear),
 				&tccbdata,
 				cbpathe,
-				context->common.cbdata
+				cbdata
 				);
 		} while (!result && i--);
 
+	return result;
+	}
+
+
+int PUBLIC(Clear)(
+		EAVLc_context_t*	context,
+		EAVLc_cbRelease_t	cbrelease
+		)
+	{
+	int			result = EAVL_OK;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	CONTEXT_RESET_ALL(context);
+
+	if (!context->tree->root || !cbrelease)
+		{
+		context->tree->root = NULL;
+		context->tree->count = 0;
+		context->tree->unique = 0;
+		CONTEXT_RESET(context, 0);
+		RESULT(EAVL_OK);
+		}
+
+	result = PRIVATE(tree_clear)(
+			context->tree->root,
+			cbrelease,
+			context->cbpathe,
+			context->common.cbdata
+			);
+
 	if (result != EAVL_CALLBACK)
 		{
 		context->tree->root = NULL;
+		context->tree->count = 0;
+		context->tree->unique = 0;
 		CONTEXT_RESET(context, 0);
 		}
 
@@ -335,6 +391,74 @@ int PUBLIC(Release)(
 	}
 
 
+static int PRIVATE(cb_tree_usage)(
+		EAVLc_node_t*		node,
+		order_mask_t		cover,
+		unsigned int		safe,
+		void*			cbdata
+		)
+	{
+	QUIET_UNUSED(cover);
+	QUIET_UNUSED(safe);
+
+	/* Everything at and below a shared node is shared */
+	if (GET_REFS(node))
+		{
+		return EAVL_CB_LIMIT;
+		}
+
+	(*(uintptr_t*)cbdata)++;
+
+	return EAVL_CB_OK;
+	}
+
+
+int PUBLIC(Usage)(
+		EAVLc_context_t*	context,
+		int			exact,
+		EAVLc_usage_t*		usage
+		)
+	{
+	uintptr_t		unique = 0;
+	int			result = EAVL_OK;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(usage);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (exact && context->tree->root)
+		{
+		result = PRIVATE(traverse)(
+				context->tree->root,
+				EAVL_DIR_LEFT,
+				ORDER_MASK_PRE,
+				1,
+				&PRIVATE(cb_tree_usage),
+				&unique,
+				context->cbpathe,
+				context->common.cbdata
+				);
+		CONTEXT_RESET(context, 0);
+
+		if (result != EAVL_OK)
+			{
+			RESULT(result);
+			}
+
+		context->tree->unique = unique;
+		}
+
+	usage->nodes = context->tree->count;
+	usage->unique = context->tree->unique;
+	usage->shared = context->tree->count - context->tree->unique;
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
 int PUBLIC(Context_Init)(
 		EAVLc_context_t*	context,
 		EAVLc_cbPathe_t		cbpathe,
@@ -348,13 +472,32 @@ int PUBLIC(Context_Init)(
 	context->common.self = &context->common;
 	context->cbpathe = cbpathe;
 	context->common.cbdata = cbdata;
+	context->common.generation = 0;
 	context->recent = NULL;
 	context->pathlen = 0;
+	context->vectored = 0;
 
 	return EAVL_OK;
 	}
 
 
+int PUBLIC(Context_Init_Vectored)(
+		EAVLc_context_t*	context,
+		EAVLc_cbPathe_t		cbpathe,
+		void*			cbdata
+		)
+	{
+	int			result;
+
+	if ((result = PUBLIC(Context_Init)(context, cbpathe, cbdata)) == EAVL_OK)
+		{
+		context->vectored = 1;
+		}
+
+	return result;
+	}
+
+
 int PUBLIC(Context_Associate)(
 		EAVLc_context_t*	context,
 		EAVLc_tree_t*		tree
@@ -371,7 +514,7 @@ int PUBLIC(Context_Associate)(
 		}
 
 	context->tree = tree;
-	tree->common.associations++;
+	(void) __atomic_add_fetch(&tree->common.associations, 1, __ATOMIC_RELAXED);
 
 	CONTEXT_RESET(context, 0);
 
@@ -397,7 +540,7 @@ int PUBLIC(Context_Disassociate)(
 	CONTEXT_RESET(context, 0);
 
 	context->tree = NULL;
-	tree->common.associations--;
+	(void) __atomic_sub_fetch(&tree->common.associations, 1, __ATOMIC_RELAXED);
 
 	CHECK_TREE(context, tree);
 
@@ -429,6 +572,7 @@ int PRIVATE(find)(
 		EAVL_rel_t		rel,
 		EAVLc_cbCompare_t	compare,
 		EAVLc_cbPathe_t		cbpathe,
+		EAVLc_pathelement_t*	pathv,
 		void*			cbdata,
 		void*			ref_value,
 		EAVLc_node_t*		ref_node,
@@ -502,6 +646,7 @@ int PUBLIC(Find)(
 		)
 	{
 	EAVLc_node_t*		node;
+	EAVLc_pathelement_t*	pathv;
 	unsigned int		pathlen;
 	int			result;
 
@@ -511,6 +656,8 @@ int PUBLIC(Find)(
 
 	CHECK_STD_PRE(context, context->tree, 0);
 
+	PATHE_VECTOR(context, pathv);
+
 	CONTEXT_RESET(context, 1);
 
 	if (!compare)
@@ -523,6 +670,7 @@ int PUBLIC(Find)(
 			rel,
 			compare,
 			context->cbpathe,
+			pathv,
 			context->common.cbdata,
 			ref_value,
 			ref_node,
@@ -546,6 +694,124 @@ int PUBLIC(Find)(
 	}
 
 
+/*
+** The part of the saved path still linked from the root is kept, so the
+** search for the recent node resumes from the deepest surviving node.
+** Links alone do not show that a kept node still has its old key, so a
+** search that misses below it is repeated from the root.
+*/
+int PUBLIC(Context_Reseek)(
+		EAVLc_context_t*	context
+		)
+	{
+	EAVLc_node_t*		recent;
+	EAVLc_node_t*		parent = NULL;
+	EAVLc_node_t*		node;
+	EAVLc_cbPathe_t		cbpathe;
+	EAVLc_pathelement_t*	pathv;
+	void*			cbdata;
+	EAVL_dir_t		cmp;
+	unsigned int		savedlen;
+	unsigned int		pathlen;
+	int			result = EAVL_OK;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	recent = context->recent;
+	if (!recent)
+		{
+		RESULT(EAVL_ERROR_CONTEXT);
+		}
+
+	if (context->common.generation == context->tree->common.generation)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	savedlen = context->pathlen;
+	cbpathe = context->cbpathe;
+	cbdata = context->common.cbdata;
+
+	PATHE_VECTOR(context, pathv);
+
+	CONTEXT_RESET(context, 1);
+
+	for (pathlen=1; pathlen<savedlen; pathlen++)
+		{
+		PATHE_GET_SAFE(pathlen, cbpathe, cbdata, node);
+
+		if (node != ((parent)
+				? GET_CHILD(parent, SID(parent, node))
+				: context->tree->root
+				))
+			{
+			break;
+			}
+
+		parent = node;
+		}
+
+	if (pathlen == savedlen && recent == ((parent)
+			? GET_CHILD(parent, SID(parent, recent))
+			: context->tree->root
+			))
+		{
+		CONTEXT_SET(context, recent, pathlen, 0);
+		RESULT(EAVL_OK);
+		}
+
+	if (parent)
+		{
+		node = parent;
+		pathlen--;
+		}
+	else
+		{
+		node = context->tree->root;
+		}
+
+	for (;;)
+		{
+		while (node)
+			{
+			CB_COMPARE(NULL, recent, node, context->tree->cbset->compare, cbdata, cmp);
+			if (cmp == EAVL_CMP_SAME)
+				{
+				break;
+				}
+
+			PATHE_SET_SAFE(pathlen++, cbpathe, cbdata, node);
+			node = GET_CHILD(node, (cmp == EAVL_CMP_LEFT) ? DIR_RIGHT : DIR_LEFT);
+			}
+
+		if (node || !parent)
+			{
+			break;
+			}
+
+		/* A kept node was reused under another key; search from the root */
+		parent = NULL;
+		pathlen = 1;
+		node = context->tree->root;
+		}
+
+	if (node)
+		{
+		CONTEXT_SET(context, node, pathlen, 0);
+		}
+	else
+		{
+		result = EAVL_NOTFOUND;
+		}
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
 int PUBLIC(First)(
 		EAVLc_context_t*	context,
 		EAVL_dir_t		dir,
@@ -556,6 +822,7 @@ int PUBLIC(First)(
 	EAVLc_node_t*		curr;
 	EAVLc_node_t*		next;
 	EAVLc_cbPathe_t		cbpathe;
+	EAVLc_pathelement_t*	pathv;
 	void*			cbdata;
 	unsigned int		pathlen = 0;
 	int			result = EAVL_OK;
@@ -567,6 +834,8 @@ int PUBLIC(First)(
 
 	CHECK_STD_PRE(context, context->tree, 0);
 
+	PATHE_VECTOR(context, pathv);
+
 	CONTEXT_RESET(context, 1);
 
 	cbpathe = context->cbpathe;
@@ -631,6 +900,7 @@ int PUBLIC(Next)(
 	EAVLc_node_t*		curr;
 	EAVLc_node_t*		prev;
 	EAVLc_cbPathe_t		cbpathe;
+	EAVLc_pathelement_t*	pathv;
 	void*			cbdata;
 	EAVL_dir_t		other = DIR_OTHER(dir);
 	unsigned int		pathlen;
@@ -643,6 +913,8 @@ int PUBLIC(Next)(
 
 	CHECK_STD_PRE(context, context->tree, 1);
 
+	PATHE_VECTOR(context, pathv);
+
 	curr = context->recent;
 	pathlen = context->pathlen;
 	cbpathe = context->cbpathe;
@@ -742,6 +1014,7 @@ int PUBLIC(Fixup)(
 	EAVLc_node_t*		curr;
 	EAVLc_cbFixup_t		fixup;
 	EAVLc_cbPathe_t		cbpathe;
+	EAVLc_pathelement_t*	pathv;
 	void*			cbdata;
 	unsigned int		pathlen;
 	int			result = EAVL_OK;
@@ -750,6 +1023,8 @@ int PUBLIC(Fixup)(
 
 	CHECK_CONTEXT(context, 1);
 
+	PATHE_VECTOR(context, pathv);
+
 	curr = context->recent;
 	pathlen = context->pathlen;
 	fixup = context->tree->cbset->fixup;
@@ -871,6 +1146,113 @@ int PUBLIC(Load)(
 	if (result == EAVL_OK)
 		{
 		context->tree->root = nodes[rootindex];
+		context->tree->count = count;
+		context->tree->unique = count;
+		}
+
+	CONTEXT_RESET_ALL(context);
+	CONTEXT_RESET(context, 0);
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+static void* PRIVATE(serialize_getchild)(
+		void*			node,
+		EAVL_dir_t		dir
+		)
+	{
+	return GET_CHILD((EAVLc_node_t*)node, dir);
+	}
+
+
+int PUBLIC(Serialize)(
+		EAVLc_context_t*	context,
+		unsigned int*		countp,
+		EAVLc_node_t**		nodes,
+		unsigned char*		shape
+		)
+	{
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(countp);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (*countp)
+		{
+		CHECK_PARAM_NON_NULL(nodes);
+		CHECK_PARAM_NON_NULL(shape);
+		}
+
+	result = FOREIGN(_, serialize)(
+			context->tree->root,
+			countp,
+			(void**)nodes,
+			shape,
+			&PRIVATE(serialize_getchild)
+			);
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+int PUBLIC(Deserialize)(
+		EAVLc_context_t*	context,
+		unsigned int		count,
+		EAVLc_node_t**		nodes,
+		unsigned char*		shape,
+		int			fixup
+		)
+	{
+	unsigned int		rootindex;
+	unsigned int		i;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+	if (context->tree->root)
+		{
+		RESULT(EAVL_ERROR_PARAMETER);
+		}
+
+	if (!count)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	CHECK_PARAM_NON_NULL(nodes);
+	CHECK_PARAM_NON_NULL(shape);
+	CHECK_NODES_ALIGN(count, nodes);
+
+	for (i=0; i<count; i++)
+		{
+		NODE_INIT(nodes[i]);
+		}
+
+	result = FOREIGN(_, deserialize)(
+			&rootindex,
+			count,
+			(void**)nodes,
+			shape,
+			&PRIVATE(load_cbset),
+			(fixup)
+				? (FOREIGN(_, load_cbFixup_t))context->tree->cbset->fixup
+				: NULL,
+			context->common.cbdata
+			);
+
+	if (result == EAVL_OK)
+		{
+		context->tree->root = nodes[rootindex];
+		context->tree->count = count;
+		context->tree->unique = count;
 		}
 
 	CONTEXT_RESET_ALL(context);
@@ -961,11 +1343,13 @@ static int PRIVATE(insert)(
 		EAVLc_node_t*		new_node,
 		EAVLc_cbCompare_t	compare,
 		EAVLc_cbFixup_t		fixup,
-		EAVLc_cbDup_t		dup,
+		EAVLc_cbset_t*		cbset,
 		EAVLc_cbPathe_t		cbpathe,
+		EAVLc_pathelement_t*	pathv,
 		void*			cbdata,
 		EAVLc_node_t**		resultp,
-		unsigned int*		pathlenp
+		unsigned int*		pathlenp,
+		uintptr_t*		dupsp
 		)
 	{
 	EAVLc_node_t*		curr = *rootp;
@@ -1010,9 +1394,11 @@ static int PRIVATE(insert)(
 			rootp,
 			&prev,
 			*pathlenp-1,
-			dup,
+			cbset,
 			cbpathe,
-			cbdata
+			pathv,
+			cbdata,
+			dupsp
 			);
 	if (result != EAVL_OK)
 		{
@@ -1130,6 +1516,7 @@ int PUBLIC(Insert)(
 		EAVLc_node_t**		resultp
 		)
 	{
+	EAVLc_pathelement_t*	pathv;
 	unsigned int		pathlen;
 	int			result;
 
@@ -1140,6 +1527,8 @@ int PUBLIC(Insert)(
 	CHECK_NODE_ALIGN(new_node);
 	CHECK_STD_PRE(context, context->tree, 0);
 
+	PATHE_VECTOR(context, pathv);
+
 	CONTEXT_RESET(context, 1);
 
 	result = PRIVATE(insert)(
@@ -1147,17 +1536,22 @@ int PUBLIC(Insert)(
 			new_node,
 			context->tree->cbset->compare,
 			context->tree->cbset->fixup,
-			context->tree->cbset->dup,
+			context->tree->cbset,
 			context->cbpathe,
+			pathv,
 			context->common.cbdata,
 			resultp,
-			&pathlen
+			&pathlen,
+			&context->tree->unique
 			);
 
 	if (result == EAVL_OK)
 		{
+		context->tree->count++;
+		context->tree->unique++;
 		CONTEXT_RESET_ALL(context);
 		CONTEXT_SET(context, *resultp, pathlen, 0);
+		CHECK_PATH(context, context->tree, *resultp);
 		}
 	else if (result == EAVL_EXISTS)
 		{
@@ -1210,9 +1604,11 @@ static int PRIVATE(remove_split)(
 		EAVLc_node_t**		rootp,
 		EAVLc_node_t**		delpointp,
 		unsigned int		pathlen,
-		EAVLc_cbDup_t		dup,
+		EAVLc_cbset_t*		cbset,
 		EAVLc_cbPathe_t		cbpathe,
-		void*			cbdata
+		EAVLc_pathelement_t*	pathv,
+		void*			cbdata,
+		uintptr_t*		dupsp
 		)
 	{
 	EAVLc_node_t*		curr;
@@ -1224,9 +1620,11 @@ static int PRIVATE(remove_split)(
 			rootp,
 			delpointp,
 			pathlen,
-			dup,
+			cbset,
 			cbpathe,
-			cbdata
+			pathv,
+			cbdata,
+			dupsp
 			);
 	if (result != EAVL_OK)
 		{
@@ -1265,20 +1663,20 @@ static int PRIVATE(remove_split)(
 
 			B = GET_CHILD(curr, other);
 			bal = GET_BAL(B);
-			NODE_DUP(B, curr, dup, cbdata);
+			NODE_DUP(B, curr, cbset, cbdata, *dupsp);
 			if (bal != dir)			// Cases: 3,4
 				{
 //				PRIVATE(rotate_single)(other, parent, curr, B);
-//				NODE_DUP(B, curr, dup, cbdata);
+//				NODE_DUP(B, curr, cbset, cbdata, *dupsp);
 				}
 			else				// Case: 5
 				{
 //				C = GET_CHILD(B, dir);
 //				PRIVATE(rotate_double)(other, parent, curr, B, C);
-//				NODE_DUP(B, curr, dup, cbdata);
+//				NODE_DUP(B, curr, cbset, cbdata, *dupsp);
 
 				C = GET_CHILD(B, dir);
-				NODE_DUP(C, B, dup, cbdata);
+				NODE_DUP(C, B, cbset, cbdata, *dupsp);
 				}
 
 			if (bal == DIR_NEITHER)		// Case: 4
@@ -1300,10 +1698,12 @@ static int PRIVATE(remove)(
 		EAVLc_node_t**		del_nodep,
 		unsigned int		pathlen,
 		EAVLc_cbFixup_t		fixup,
-		EAVLc_cbDup_t		dup,
+		EAVLc_cbset_t*		cbset,
 		EAVLc_cbPathe_t		cbpathe,
+		EAVLc_pathelement_t*	pathv,
 		void*			cbdata,
-		EAVLc_node_t**		nodep
+		EAVLc_node_t**		nodep,
+		uintptr_t*		dupsp
 		)
 	{
 	EAVLc_node_t*		prev;
@@ -1338,9 +1738,11 @@ static int PRIVATE(remove)(
 				rootp,
 				&swap_node,
 				pathlen,
-				dup,
+				cbset,
 				cbpathe,
-				cbdata
+				pathv,
+				cbdata,
+				dupsp
 				);
 		// Fix context->recent
 		PATHE_GET_SAFE(del_node_pathlen, cbpathe, cbdata, *del_nodep);
@@ -1369,9 +1771,11 @@ static int PRIVATE(remove)(
 				rootp,
 				del_nodep,
 				pathlen,
-				dup,
+				cbset,
 				cbpathe,
-				cbdata
+				pathv,
+				cbdata,
+				dupsp
 				);
 		if (result != EAVL_OK)
 			{
@@ -1502,29 +1906,51 @@ int PUBLIC(Remove)(
 		EAVLc_node_t**		nodep
 		)
 	{
+	EAVLc_node_t*		del_node;
+	EAVLc_pathelement_t*	pathv;
 	int			result;
 
 	CHECK_PARAM_NON_NULL(context);
 
 	CHECK_STD_PRE(context, context->tree, 1);
 
+	PATHE_VECTOR(context, pathv);
+
+	del_node = context->recent;
+
 	result = PRIVATE(remove)(
 			&context->tree->root,
 			&context->recent,
 			context->pathlen,
 			context->tree->cbset->fixup,
-			context->tree->cbset->dup,
+			context->tree->cbset,
 			context->cbpathe,
+			pathv,
 			context->common.cbdata,
-			nodep
+			nodep,
+			&context->tree->unique
 			);
 
+	if (result == EAVL_OK)
+		{
+		context->tree->count--;
+		if (context->tree->unique)
+			{
+			context->tree->unique--;
+			}
+		}
+
 	if (result != EAVL_CALLBACK)
 		{
 		CONTEXT_RESET_ALL(context);
 		CONTEXT_RESET(context, 0);
 		}
 
+	if (result == EAVL_OK)
+		{
+		CHECK_PATH(context, context->tree, del_node);
+		}
+
 	CHECK_STD_POST(context->tree, context);
 
 	RETURN;
@@ -84,17 +84,75 @@ int PRIVATE(Path_match)(
 
 #define GET_CHILD(NODE, DIR)		EAVLc_GET_CHILD((NODE), (DIR))
 #define GET_BAL(NODE)			EAVLc_GET_BAL((NODE))
-#define GET_REFS(NODE)			((NODE)->references|0x0)
 
 #define SET_CHILD(NODE, CHILD, DIR)	EAVL_SET_CHILD(&(NODE)->EAVLnode, (CHILD), (DIR))
 #define SET_BAL(NODE, BAL)		EAVL_SET_BAL(&(NODE)->EAVLnode, (BAL))
+
+#define SID(PARENT, CHILD)		((CHILD) == GET_CHILD((PARENT), DIR_RIGHT))
+
+/*
+** Reference counts are the number of owners beyond the first. REFS_PUT
+** drops one ownership and sets LAST if the caller was the final owner,
+** in which case the node is exclusively the caller's and its count is
+** left at zero. A GET_REFS of zero is also a test for exclusive ownership
+** before the node is changed or released, so it acquires.
+*/
+#if EAVLc_ATOMICS_AVAILABLE
+
+
+#define GET_REFS(NODE)							\
+	__atomic_load_n(&(NODE)->references, __ATOMIC_ACQUIRE)
+
 #define SET_REFS(NODE, REFS)						\
 	do								\
 		{							\
-		(NODE)->references = (REFS);				\
+		__atomic_store_n(					\
+				&(NODE)->references,			\
+				(REFS),					\
+				__ATOMIC_RELAXED			\
+				);					\
 		} while (0)
 
-#define SID(PARENT, CHILD)		((CHILD) == GET_CHILD((PARENT), DIR_RIGHT))
+#define REFS_INC(NODE)							\
+	do								\
+		{							\
+		if ((NODE))						\
+			{						\
+			(void) __atomic_fetch_add(			\
+					&(NODE)->references,		\
+					1,				\
+					__ATOMIC_RELAXED		\
+					);				\
+			}						\
+		} while (0)
+
+#define REFS_PUT(NODE, LAST)						\
+	do								\
+		{							\
+		(LAST) = 0;						\
+		if ((NODE) && !__atomic_fetch_sub(			\
+					&(NODE)->references,		\
+					1,				\
+					__ATOMIC_ACQ_REL		\
+					)				\
+				)					\
+			{						\
+			SET_REFS((NODE), 0);				\
+			(LAST) = 1;					\
+			}						\
+		} while (0)
+
+
+#else
+
+
+#define GET_REFS(NODE)			((NODE)->references|0x0)
+
+#define SET_REFS(NODE, REFS)						\
+	do								\
+		{							\
+		(NODE)->references = (REFS);				\
+		} while (0)
 
 #define REFS_INC(NODE)							\
 	do								\
@@ -105,15 +163,26 @@ int PRIVATE(Path_match)(
 			}						\
 		} while (0)
 
-#define REFS_DEC(NODE)							\
+#define REFS_PUT(NODE, LAST)						\
 	do								\
 		{							\
+		(LAST) = 0;						\
 		if ((NODE))						\
 			{						\
-			(NODE)->references--;				\
+			if ((NODE)->references)				\
+				{					\
+				(NODE)->references--;			\
+				}					\
+			else						\
+				{					\
+				(LAST) = 1;				\
+				}					\
 			}						\
 		} while (0)
 
+
+#endif	/* EAVLc_ATOMICS_AVAILABLE */
+
 #define INTREE(CONTEXT, RES)						\
 	do								\
 		{							\
@@ -131,7 +200,7 @@ int PRIVATE(Path_match)(
 		{							\
 		(CONTEXT)->recent = (NODE);				\
 		(CONTEXT)->pathlen = (POS);				\
-		if (!(NO_TRUNCATE))					\
+		if (!(NO_TRUNCATE) && !(CONTEXT)->vectored)		\
 			{						\
 			PATHE_TRUNCATE(					\
 					(POS),				\
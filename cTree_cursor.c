@@ -0,0 +1,295 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_cTree.h"
+
+#define CHECKS_AVAILABLE	EAVLc_CHECKS_AVAILABLE
+
+#include "cTree.h"
+#include "cTree_internal.h"
+
+#include "callback_internal.h"
+#include "checks_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** A cursor is a position in a tree that is not registered with the tree.
+** The ancestors of the recent node are kept in the cursor itself instead
+** of through a cbPathe callback. Writers never reset cursors; a cursor is
+** invalid after any change to its tree and must be set again by
+** Cursor_First or Cursor_Find.
+*/
+
+
+/*
+**				_cmp_
+**	Rel			0 2 1
+**	LT	0	000	0 1 1
+**	LE	1	001	0 2 1
+**	EQ	2	010	0 2 1
+**	GE	3	011	0 2 1
+**	GT	4	100	0 0 1
+*/
+#define CMP_REL_MAP(REL, CMP)						\
+		(((CMP) != EAVL_CMP_SAME || ((REL) & 0x03))		\
+				? (CMP)					\
+				: (((REL) == EAVL_FIND_LT)		\
+					? EAVL_CMP_RIGHT		\
+					: EAVL_CMP_LEFT			\
+					)				\
+				)
+
+
+int PUBLIC(Cursor_Init)(
+		EAVLc_cursor_t*		cursor,
+		EAVLc_tree_t*		tree,
+		void*			cbdata
+		)
+	{
+	CHECK_PARAM_NON_NULL(cursor);
+	CHECK_PARAM_NON_NULL(tree);
+
+	cursor->tree = tree;
+	cursor->recent = NULL;
+	cursor->cbdata = cbdata;
+	cursor->pathlen = 0;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Cursor_Find)(
+		EAVLc_cursor_t*		cursor,
+		EAVL_rel_t		rel,
+		EAVLc_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLc_node_t*		ref_node,
+		EAVLc_node_t**		resultp
+		)
+	{
+	EAVLc_node_t*		node;
+	EAVLc_node_t*		left = NULL;
+	EAVLc_node_t*		right = NULL;
+	EAVL_dir_t		cmp;
+	unsigned int		pathlen = 0;
+	unsigned int		pathlen_left = 0;
+	unsigned int		pathlen_right = 0;
+
+	CHECK_PARAM_NON_NULL(cursor);
+	CHECK_PARAM_NON_NULL(resultp);
+	CHECK_PARAM_REL(rel);
+
+	cursor->recent = NULL;
+
+	if (!compare)
+		{
+		compare = cursor->tree->cbset->compare;
+		}
+
+	node = cursor->tree->root;
+	while (node)
+		{
+		CB_COMPARE(ref_value, ref_node, node, compare, cursor->cbdata, cmp);
+		cmp = CMP_REL_MAP(rel, cmp);
+		switch (cmp)
+			{
+			case EAVL_CMP_SAME:
+				cursor->recent = node;
+				cursor->pathlen = pathlen;
+				*resultp = node;
+				return EAVL_OK;
+
+			case EAVL_CMP_LEFT:
+				left = node;
+				pathlen_left = pathlen;
+				break;
+
+			case EAVL_CMP_RIGHT:
+				right = node;
+				pathlen_right = pathlen;
+				break;
+			}
+
+		if (pathlen == HEIGHT_MAX)
+			{
+			return EAVL_ERROR_TREE;
+			}
+		cursor->path[pathlen++] = node;
+		node = GET_CHILD(node, (cmp == EAVL_CMP_LEFT) ? DIR_RIGHT : DIR_LEFT);
+		}
+
+	if (rel != EAVL_FIND_EQ)
+		{
+		if (rel < EAVL_FIND_EQ)
+			{
+			node = left;
+			pathlen = pathlen_left;
+			}
+		else
+			{
+			node = right;
+			pathlen = pathlen_right;
+			}
+		}
+
+	if (!node)
+		{
+		return EAVL_NOTFOUND;
+		}
+
+	cursor->recent = node;
+	cursor->pathlen = pathlen;
+	*resultp = node;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Cursor_First)(
+		EAVLc_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLc_node_t**		resultp
+		)
+	{
+	EAVLc_node_t*		curr;
+	EAVLc_node_t*		next;
+	unsigned int		pathlen = 0;
+
+	CHECK_PARAM_NON_NULL(cursor);
+	CHECK_PARAM_NON_NULL(resultp);
+	CHECK_PARAM_DIR(dir);
+
+	cursor->recent = NULL;
+
+	curr = cursor->tree->root;
+	if (!curr)
+		{
+		return EAVL_NOTFOUND;
+		}
+
+	/* find extreme node in direction opposit of motion */
+	dir = DIR_OTHER(dir);
+	while ((next = GET_CHILD(curr, dir)))
+		{
+		if (pathlen == HEIGHT_MAX)
+			{
+			return EAVL_ERROR_TREE;
+			}
+		cursor->path[pathlen++] = curr;
+		curr = next;
+		}
+
+	cursor->recent = curr;
+	cursor->pathlen = pathlen;
+	*resultp = curr;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Cursor_Next)(
+		EAVLc_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLc_node_t**		resultp
+		)
+	{
+	EAVLc_node_t*		curr;
+	EAVLc_node_t*		prev;
+	EAVL_dir_t		other = DIR_OTHER(dir);
+	unsigned int		pathlen;
+
+	CHECK_PARAM_NON_NULL(cursor);
+	CHECK_PARAM_NON_NULL(resultp);
+	CHECK_PARAM_DIR(dir);
+
+	curr = cursor->recent;
+	pathlen = cursor->pathlen;
+	if (!curr)
+		{
+		return EAVL_ERROR_CONTEXT;
+		}
+
+	cursor->recent = NULL;
+
+	/* try to move DIR */
+	prev = GET_CHILD(curr, dir);
+	if (prev)
+		{
+		/* find OTHER-most node */
+		do
+			{
+			if (pathlen == HEIGHT_MAX)
+				{
+				return EAVL_ERROR_TREE;
+				}
+			cursor->path[pathlen++] = curr;
+			curr = prev;
+			} while ((prev = GET_CHILD(curr, other)));
+		}
+	else
+		{
+		do
+			{
+			/* move UP */
+			prev = curr;
+			curr = (pathlen) ? cursor->path[--pathlen] : NULL;
+			} while (curr && prev != GET_CHILD(curr, other));
+		}
+
+	if (!curr)
+		{
+		return EAVL_NOTFOUND;
+		}
+
+	cursor->recent = curr;
+	cursor->pathlen = pathlen;
+	*resultp = curr;
+
+	return EAVL_OK;
+	}
+
+
+/* cTree_cursor.c */
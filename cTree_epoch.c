@@ -0,0 +1,241 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_cTree.h"
+
+#define CHECKS_AVAILABLE	EAVLc_CHECKS_AVAILABLE
+
+#include "cTree.h"
+#include "cTree_internal.h"
+
+#include "callback_internal.h"
+#include "checks_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** Epochs start at 1; a reader epoch of 0 is outside of any epoch. Nodes
+** retired in epoch E are linked, through their reference count, on
+** limbo[E % 3] and released when the global epoch advances to E+2, by
+** which time every reader has entered an epoch after their retirement.
+*/
+#define LIMBO(EPOCH)		((EPOCH) % 3)
+
+#define LIMBO_NEXT(NODE)		((EAVLc_node_t*)GET_REFS((NODE)))
+#define LIMBO_SET_NEXT(NODE, NEXT)	SET_REFS((NODE), (uintptr_t)(NEXT))
+
+
+int PUBLIC(Epoch_Init)(
+		EAVLc_epoch_t*		epoch
+		)
+	{
+	CHECK_PARAM_NON_NULL(epoch);
+
+	epoch->global = 1;
+	epoch->readers = NULL;
+	epoch->limbo[0] = NULL;
+	epoch->limbo[1] = NULL;
+	epoch->limbo[2] = NULL;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Epoch_Register)(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_epoch_reader_t*	reader
+		)
+	{
+	CHECK_PARAM_NON_NULL(epoch);
+	CHECK_PARAM_NON_NULL(reader);
+
+	reader->active = 0;
+	reader->next = __atomic_load_n(&epoch->readers, __ATOMIC_ACQUIRE);
+	while (!__atomic_compare_exchange_n(
+			&epoch->readers,
+			&reader->next,
+			reader,
+			1,
+			__ATOMIC_RELEASE,
+			__ATOMIC_ACQUIRE
+			))
+		{
+		/* reader->next was reloaded */
+		}
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Epoch_Unregister)(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_epoch_reader_t*	reader
+		)
+	{
+	EAVLc_epoch_reader_t*	expected = reader;
+	EAVLc_epoch_reader_t*	curr;
+
+	CHECK_PARAM_NON_NULL(epoch);
+	CHECK_PARAM_NON_NULL(reader);
+
+	/* Only the head may be changed by concurrent registrations */
+	if (__atomic_compare_exchange_n(
+			&epoch->readers,
+			&expected,
+			reader->next,
+			0,
+			__ATOMIC_ACQ_REL,
+			__ATOMIC_ACQUIRE
+			))
+		{
+		return EAVL_OK;
+		}
+
+	for (curr = expected; curr; curr = curr->next)
+		{
+		if (curr->next == reader)
+			{
+			curr->next = reader->next;
+			return EAVL_OK;
+			}
+		}
+
+	return EAVL_NOTFOUND;
+	}
+
+
+int PUBLIC(Epoch_Enter)(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_epoch_reader_t*	reader
+		)
+	{
+	CHECK_PARAM_NON_NULL(epoch);
+	CHECK_PARAM_NON_NULL(reader);
+
+	__atomic_store_n(
+			&reader->active,
+			__atomic_load_n(&epoch->global, __ATOMIC_RELAXED),
+			__ATOMIC_RELAXED
+			);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Epoch_Leave)(
+		EAVLc_epoch_reader_t*	reader
+		)
+	{
+	CHECK_PARAM_NON_NULL(reader);
+
+	__atomic_store_n(&reader->active, 0, __ATOMIC_RELEASE);
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Epoch_Retire)(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_node_t*		node
+		)
+	{
+	EAVLc_node_t**		limbop;
+
+	CHECK_PARAM_NON_NULL(epoch);
+	CHECK_PARAM_NON_NULL(node);
+
+	limbop = &epoch->limbo[LIMBO(epoch->global)];
+	LIMBO_SET_NEXT(node, *limbop);
+	*limbop = node;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Epoch_Reclaim)(
+		EAVLc_epoch_t*		epoch,
+		EAVLc_cbRelease_t	cbrelease,
+		void*			cbdata
+		)
+	{
+	EAVLc_epoch_reader_t*	reader;
+	EAVLc_node_t*		node;
+	EAVLc_node_t**		limbop;
+	uintptr_t		global;
+	uintptr_t		active;
+
+	CHECK_PARAM_NON_NULL(epoch);
+
+	global = epoch->global;
+
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	reader = __atomic_load_n(&epoch->readers, __ATOMIC_ACQUIRE);
+	while (reader)
+		{
+		active = __atomic_load_n(&reader->active, __ATOMIC_SEQ_CST);
+		if (active && active != global)
+			{
+			return EAVL_NOTFOUND;
+			}
+		reader = reader->next;
+		}
+
+	__atomic_store_n(&epoch->global, global+1, __ATOMIC_SEQ_CST);
+
+	/* Retired in global-1 */
+	limbop = &epoch->limbo[LIMBO(global+2)];
+	while ((node = *limbop))
+		{
+		*limbop = LIMBO_NEXT(node);
+		SET_REFS(node, 0);
+		CB_RELEASE(node, cbrelease, cbdata);
+		}
+
+	return EAVL_OK;
+	}
+
+
+/* cTree_epoch.c */
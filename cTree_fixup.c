@@ -0,0 +1,281 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_cTree.h"
+
+#define CHECKS_AVAILABLE	EAVLc_CHECKS_AVAILABLE
+
+#include "cTree.h"
+#include "cTree_internal.h"
+
+#include "callback_internal.h"
+#include "checks_internal.h"
+#include "context_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** Fixing up the whole tree visits every node once, children before
+** parents. The subtrees below a fixed depth are independent pieces that
+** jobs take in turn; the few nodes above them are done last, by the caller.
+*/
+#define PIECES_PER_THREAD	(4)
+#define PIECES_MAX		(128)
+
+#define FIXUP_ALL_NODE(NODE, FIXUP, CBDATA)				\
+	NODE_FIXUP((NODE), 1, (FIXUP), (CBDATA))
+
+typedef struct
+	{
+	EAVLc_node_t*		pieces[PIECES_MAX];
+	unsigned int		count;
+	uintptr_t		next;		/* Next piece to take		*/
+	uintptr_t		stop;
+	int			result;
+	EAVLc_cbFixup_t		fixup;
+	void*			cbdata;
+	}			fixup_all_t;
+
+
+static int PRIVATE(fixup_subtree)(
+		EAVLc_node_t*		node,
+		EAVLc_cbFixup_t		fixup,
+		void*			cbdata
+		)
+	{
+	int			result;
+
+	if (!node)
+		{
+		return EAVL_OK;
+		}
+
+	if ((result = PRIVATE(fixup_subtree)(GET_CHILD(node, DIR_LEFT), fixup, cbdata)) != EAVL_OK
+			|| (result = PRIVATE(fixup_subtree)(GET_CHILD(node, DIR_RIGHT), fixup, cbdata)) != EAVL_OK
+			)
+		{
+		return result;
+		}
+
+	FIXUP_ALL_NODE(node, fixup, cbdata);
+
+	return EAVL_OK;
+	}
+
+
+/*
+** Nodes at DEPTH are the roots of pieces; the nodes above are only fixed up
+** once all the pieces are done.
+*/
+static int PRIVATE(fixup_top)(
+		EAVLc_node_t*		node,
+		unsigned int		depth,
+		EAVLc_cbFixup_t		fixup,
+		void*			cbdata
+		)
+	{
+	int			result;
+
+	if (!node || !depth)
+		{
+		return EAVL_OK;
+		}
+
+	if ((result = PRIVATE(fixup_top)(GET_CHILD(node, DIR_LEFT), depth-1, fixup, cbdata)) != EAVL_OK
+			|| (result = PRIVATE(fixup_top)(GET_CHILD(node, DIR_RIGHT), depth-1, fixup, cbdata)) != EAVL_OK
+			)
+		{
+		return result;
+		}
+
+	FIXUP_ALL_NODE(node, fixup, cbdata);
+
+	return EAVL_OK;
+	}
+
+
+static void PRIVATE(fixup_pieces)(
+		fixup_all_t*		all,
+		EAVLc_node_t*		node,
+		unsigned int		depth
+		)
+	{
+	if (!node)
+		{
+		return;
+		}
+
+	if (!depth)
+		{
+		all->pieces[all->count++] = node;
+		return;
+		}
+
+	PRIVATE(fixup_pieces)(all, GET_CHILD(node, DIR_LEFT), depth-1);
+	PRIVATE(fixup_pieces)(all, GET_CHILD(node, DIR_RIGHT), depth-1);
+	}
+
+
+static void PRIVATE(fixup_stop)(
+		fixup_all_t*		all,
+		int			result
+		)
+	{
+	int			expected = EAVL_OK;
+
+	(void) __atomic_compare_exchange_n(
+			&all->result,
+			&expected,
+			result,
+			0,
+			__ATOMIC_RELAXED,
+			__ATOMIC_RELAXED
+			);
+	__atomic_store_n(&all->stop, 1, __ATOMIC_RELAXED);
+	}
+
+
+static int PRIVATE(fixup_job)(
+		unsigned int		index,
+		void*			jobdata
+		)
+	{
+	fixup_all_t*		all = jobdata;
+	uintptr_t		i;
+	int			result;
+
+	QUIET_UNUSED(index);
+
+	while (!__atomic_load_n(&all->stop, __ATOMIC_RELAXED)
+			&& (i = __atomic_fetch_add(&all->next, 1, __ATOMIC_RELAXED)) < all->count
+			)
+		{
+		if ((result = PRIVATE(fixup_subtree)(
+				all->pieces[i],
+				all->fixup,
+				all->cbdata
+				)) != EAVL_OK)
+			{
+			PRIVATE(fixup_stop)(all, result);
+			}
+		}
+
+	return EAVL_CB_OK;
+	}
+
+
+int PUBLIC(Fixup_All)(
+		EAVLc_context_t*	context,
+		unsigned int		nthreads,
+		EAVL_cbRun_t		cbrun
+		)
+	{
+	fixup_all_t		all;
+	unsigned int		depth = 0;
+	int			result = EAVL_OK;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_CONTEXT(context, 0);
+
+	if (!context->tree->root || !context->tree->cbset->fixup)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	if (!cbrun || !nthreads)
+		{
+		nthreads = 1;
+		}
+
+	while (nthreads > 1
+			&& (1u<<depth) < MIN(nthreads, PIECES_MAX) * PIECES_PER_THREAD
+			&& (2u<<depth) <= PIECES_MAX
+			)
+		{
+		depth++;
+		}
+
+	all.count = 0;
+	all.next = 0;
+	all.stop = 0;
+	all.result = EAVL_OK;
+	all.fixup = context->tree->cbset->fixup;
+	all.cbdata = context->common.cbdata;
+
+	PRIVATE(fixup_pieces)(&all, context->tree->root, depth);
+
+	if (!cbrun)
+		{
+		(void) PRIVATE(fixup_job)(0, &all);
+		}
+	else if ((*cbrun)(
+			MIN(nthreads, all.count),
+			&PRIVATE(fixup_job),
+			&all,
+			context->common.cbdata
+			) != EAVL_CB_OK)
+		{
+		PRIVATE(fixup_stop)(&all, EAVL_ERROR_CALLBACK);
+		}
+
+	result = all.result;
+	if (result == EAVL_OK)
+		{
+		result = PRIVATE(fixup_top)(
+				context->tree->root,
+				depth,
+				all.fixup,
+				all.cbdata
+				);
+		}
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+/* cTree_fixup.c */
@@ -54,6 +54,7 @@ int FOREIGN(c_, find)(
 		EAVL_rel_t		rel,
 		EAVLc_cbCompare_t	compare,
 		EAVLc_cbPathe_t		cbpathe,
+		EAVLc_pathelement_t*	pathv,
 		void*			cbdata,
 		void*			ref_value,
 		EAVLc_node_t*		ref_node,
@@ -61,5 +62,21 @@ int FOREIGN(c_, find)(
 		unsigned int*		rindexp
 		);
 
+int FOREIGN(c_, tree_clear)(
+		EAVLc_node_t*		root,
+		EAVLc_cbRelease_t	cbrelease,
+		EAVLc_cbPathe_t		cbpathe,
+		void*			cbdata
+		);
+
+int FOREIGN(c_, verify_tree)(
+		EAVLc_node_t*		root,
+		EAVLc_cbCompare_t	compare,
+		EAVLc_cbVerify_t	verify,
+		void*			cbdata,
+		EAVLc_node_t*		path[],
+		unsigned int*		pathlenp
+		);
+
 
 #endif	/* _CTREE_INTERNAL_H */
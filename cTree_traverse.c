@@ -53,6 +53,7 @@
 
 #include "callback_internal.h"
 #include "checks_internal.h"
+#include "context_internal.h"
 #include "eavl_internal.h"
 #include "naming_internal.h"
 #include "pathe_internal.h"
@@ -73,6 +74,7 @@ int PRIVATE(traverse)(
 	EAVLc_node_t*		prev;
 	EAVL_dir_t		other;
 	order_mask_t		coverage;
+	EAVLc_pathelement_t*	pathv = NULL;	/* traversals are not vectored */
 	unsigned int		pathlen = 0;
 	int			result = EAVL_OK;
 
@@ -140,4 +142,308 @@ int PRIVATE(traverse)(
 	}
 
 
+/*
+** Parallel traversal splits the tree into pieces: whole subtrees and the
+** lone nodes between them, kept in in-order sequence. The tallest subtree
+** is split until there are enough pieces for the threads; subtree heights
+** follow from the balance bits without visiting the subtree. Jobs take
+** pieces in turn, so a single job visits in the requested direction.
+*/
+#define PIECES_PER_THREAD	(4)
+#define PIECES_MAX		(128)
+
+
+typedef struct
+	{
+	EAVLc_node_t*		node;
+	unsigned int		height;		/* 0 for a lone node		*/
+	}			piece_t;
+
+typedef struct
+	{
+	piece_t			pieces[PIECES_MAX];
+	unsigned int		count;
+	uintptr_t		next;		/* Next piece to take		*/
+	uintptr_t		stop;
+	int			result;
+	EAVL_dir_t		dir;
+	order_mask_t		interests;
+	EAVLc_cbVisit_t		cbvisit;
+	void*			cbdata;
+	}			parallel_t;
+
+typedef struct
+	{
+	parallel_t*		parallel;
+	EAVLc_pathelement_t	path[HEIGHT_MAX];
+	}			worker_t;
+
+
+static unsigned int PRIVATE(height)(
+		EAVLc_node_t*		node
+		)
+	{
+	unsigned int		height = 0;
+
+	while (node)
+		{
+		height++;
+		node = EAVLc_GET_CHILD(node, (EAVLc_GET_BAL(node) == DIR_RIGHT) ? DIR_RIGHT : DIR_LEFT);
+		}
+
+	return height;
+	}
+
+
+static void PRIVATE(parallel_split)(
+		parallel_t*		parallel,
+		unsigned int		target
+		)
+	{
+	EAVLc_node_t*		node;
+	EAVLc_node_t*		child[2];
+	unsigned int		height[2];
+	unsigned int		tallest;
+	unsigned int		added;
+	unsigned int		i;
+	EAVL_dir_t		bal;
+
+	while (parallel->count < target && parallel->count+2 <= PIECES_MAX)
+		{
+		tallest = 0;
+		for (i=1; i<parallel->count; i++)
+			{
+			if (parallel->pieces[i].height > parallel->pieces[tallest].height)
+				{
+				tallest = i;
+				}
+			}
+
+		if (parallel->pieces[tallest].height < 2)
+			{
+			break;
+			}
+
+		node = parallel->pieces[tallest].node;
+		bal = EAVLc_GET_BAL(node);
+		for (i=DIR_LEFT; i<=DIR_RIGHT; i++)
+			{
+			child[i] = EAVLc_GET_CHILD(node, i);
+			height[i] = parallel->pieces[tallest].height
+					- ((bal == DIR_NEITHER || bal == i) ? 1 : 2);
+			}
+
+		/* Replace the subtree with its left subtree, root and right subtree */
+		added = (child[DIR_LEFT] ? 1u : 0u) + (child[DIR_RIGHT] ? 1u : 0u);
+		for (i=parallel->count; i-- > tallest+1; )
+			{
+			parallel->pieces[i+added] = parallel->pieces[i];
+			}
+		parallel->count += added;
+
+		i = tallest;
+		if (child[DIR_LEFT])
+			{
+			parallel->pieces[i].node = child[DIR_LEFT];
+			parallel->pieces[i++].height = height[DIR_LEFT];
+			}
+		parallel->pieces[i].node = node;
+		parallel->pieces[i++].height = 0;
+		if (child[DIR_RIGHT])
+			{
+			parallel->pieces[i].node = child[DIR_RIGHT];
+			parallel->pieces[i].height = height[DIR_RIGHT];
+			}
+		}
+	}
+
+
+static void PRIVATE(parallel_stop)(
+		parallel_t*		parallel,
+		int			result
+		)
+	{
+	int			expected = EAVL_OK;
+
+	(void) __atomic_compare_exchange_n(
+			&parallel->result,
+			&expected,
+			result,
+			0,
+			__ATOMIC_RELAXED,
+			__ATOMIC_RELAXED
+			);
+	__atomic_store_n(&parallel->stop, 1, __ATOMIC_RELAXED);
+	}
+
+
+static EAVLc_pathelement_t* PRIVATE(parallel_pathe)(
+		unsigned int		index,
+		unsigned int		param,
+		void*			cbdata
+		)
+	{
+	/* Subtree paths never outgrow the worker's fixed path */
+	if (param || index >= HEIGHT_MAX)
+		{
+		return NULL;
+		}
+
+	return &((worker_t*)cbdata)->path[index];
+	}
+
+
+static int PRIVATE(cb_parallel)(
+		EAVLc_node_t*		node,
+		order_mask_t		cover,
+		unsigned int		safe,
+		void*			cbdata
+		)
+	{
+	parallel_t*		parallel = ((worker_t*)cbdata)->parallel;
+	int			result;
+
+	QUIET_UNUSED(cover);
+	QUIET_UNUSED(safe);
+
+	if (__atomic_load_n(&parallel->stop, __ATOMIC_RELAXED))
+		{
+		return EAVL_CB_FINISHED;
+		}
+
+	switch ((*parallel->cbvisit)(node, parallel->cbdata))
+		{
+		case EAVL_CB_OK:
+			return EAVL_CB_OK;
+
+		case EAVL_CB_FINISHED:
+			result = EAVL_OK;
+			break;
+
+		case EAVL_CB_CALLBACK:
+			result = EAVL_CALLBACK;
+			break;
+
+		default:
+			result = EAVL_ERROR_CALLBACK;
+			break;
+		}
+
+	PRIVATE(parallel_stop)(parallel, result);
+
+	return EAVL_CB_FINISHED;
+	}
+
+
+static int PRIVATE(parallel_job)(
+		unsigned int		index,
+		void*			jobdata
+		)
+	{
+	worker_t		worker;
+	parallel_t*		parallel = jobdata;
+	piece_t*		piece;
+	uintptr_t		i;
+	int			result;
+
+	QUIET_UNUSED(index);
+
+	worker.parallel = parallel;
+
+	while (!__atomic_load_n(&parallel->stop, __ATOMIC_RELAXED)
+			&& (i = __atomic_fetch_add(&parallel->next, 1, __ATOMIC_RELAXED)) < parallel->count
+			)
+		{
+		piece = &parallel->pieces[(parallel->dir == DIR_RIGHT) ? i : parallel->count-1-i];
+
+		if (!piece->height)
+			{
+			(void) PRIVATE(cb_parallel)(piece->node, parallel->interests, 1, &worker);
+			}
+		else if ((result = PRIVATE(traverse)(
+				piece->node,
+				parallel->dir,
+				parallel->interests,
+				1,
+				&PRIVATE(cb_parallel),
+				&worker,
+				&PRIVATE(parallel_pathe),
+				&worker
+				)) != EAVL_OK)
+			{
+			PRIVATE(parallel_stop)(parallel, result);
+			}
+		}
+
+	return EAVL_CB_OK;
+	}
+
+
+int PUBLIC(Traverse_Parallel)(
+		EAVLc_context_t*	context,
+		EAVL_dir_t		dir,
+		EAVL_order_t		order,
+		unsigned int		nthreads,
+		EAVLc_cbVisit_t		cbvisit,
+		EAVL_cbRun_t		cbrun
+		)
+	{
+	parallel_t		parallel;
+	int			result = EAVL_OK;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(cbvisit);
+	CHECK_PARAM_DIR(dir);
+	CHECK_PARAM_ORDER(order);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (!context->tree->root)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	if (!cbrun || !nthreads)
+		{
+		nthreads = 1;
+		}
+
+	parallel.pieces[0].node = context->tree->root;
+	parallel.pieces[0].height = PRIVATE(height)(context->tree->root);
+	parallel.count = 1;
+	parallel.next = 0;
+	parallel.stop = 0;
+	parallel.result = EAVL_OK;
+	parallel.dir = dir;
+	parallel.interests = 1u<<order;
+	parallel.cbvisit = cbvisit;
+	parallel.cbdata = context->common.cbdata;
+
+	if (nthreads > 1)
+		{
+		PRIVATE(parallel_split)(&parallel, MIN(nthreads, PIECES_MAX) * PIECES_PER_THREAD);
+		}
+
+	if (!cbrun)
+		{
+		(void) PRIVATE(parallel_job)(0, &parallel);
+		}
+	else if ((*cbrun)(
+			MIN(nthreads, parallel.count),
+			&PRIVATE(parallel_job),
+			&parallel,
+			context->common.cbdata
+			) != EAVL_CB_OK)
+		{
+		PRIVATE(parallel_stop)(&parallel, EAVL_ERROR_CALLBACK);
+		}
+
+	result = parallel.result;
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
 /* cTree_traverse.c */
@@ -0,0 +1,538 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL.h"
+#include "EAVL_cTree.h"
+
+#define CHECKS_AVAILABLE	EAVLc_CHECKS_AVAILABLE
+
+#include "cTree_internal.h"
+
+#include "callback_internal.h"
+#include "checks_internal.h"
+#include "context_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+#include "cTree.h"
+
+
+/*
+** Verification walks the tree in post-order with an explicit stack of
+** at most HEIGHT_MAX frames, checking order at each in-order step and
+** balance and cbVerify once both subtrees are done.
+**
+** To spread the work, the subtrees rooted at depth CUT are verified by
+** the jobs first; a walk of the levels above the cut then takes their
+** heights and end nodes as if it had verified them itself. A failure in
+** the lowest numbered subtree, in order, is reported.
+*/
+#define VERIFY_CUT_MAX		(7)
+#define VERIFY_PIECES_MAX	(1u<<VERIFY_CUT_MAX)
+#define VERIFY_NO_CUT		(-1u)
+
+
+typedef struct
+	{
+	EAVLc_node_t*		node;
+	unsigned int		height[2];
+	unsigned int		state;		/* Next child to walk		*/
+	}			vframe_t;
+
+typedef struct
+	{
+	EAVLc_node_t*		node;		/* Subtree root at the cut	*/
+	EAVLc_node_t*		first;
+	EAVLc_node_t*		last;
+	unsigned int		height;
+	}			vpiece_t;
+
+typedef struct
+	{
+	vpiece_t		pieces[VERIFY_PIECES_MAX];
+	unsigned int		count;
+	unsigned int		cut;
+	uintptr_t		next;		/* Next piece to take		*/
+	uintptr_t		lock;
+	unsigned int		failed;		/* Lowest failed piece		*/
+	int			result;
+	EAVLc_cbCompare_t	compare;
+	EAVLc_cbVerify_t	verify;
+	void*			cbdata;
+	EAVLc_node_t**		path;
+	unsigned int		pathlen;
+	}			verify_t;
+
+
+static int PRIVATE(verify_order)(
+		EAVLc_node_t*		prev,
+		EAVLc_node_t*		node,
+		EAVLc_cbCompare_t	compare,
+		void*			cbdata
+		)
+	{
+	EAVL_dir_t		cmp;
+
+	if (prev)
+		{
+		CB_COMPARE(NULL, prev, node, compare, cbdata, cmp);
+		if (cmp != DIR_RIGHT)
+			{
+			return EAVL_ERROR_COMPARE;
+			}
+		}
+
+	return EAVL_OK;
+	}
+
+
+static int PRIVATE(verify_node)(
+		vframe_t*		frame,
+		EAVLc_cbVerify_t*	verifyp,
+		void*			cbdata
+		)
+	{
+	EAVLc_node_t*		node = frame->node;
+	unsigned int		left = frame->height[DIR_LEFT];
+	unsigned int		right = frame->height[DIR_RIGHT];
+	EAVL_dir_t		bal_height;
+
+	bal_height = (left == right)
+			? DIR_NEITHER
+			: ((left > right)
+				? DIR_LEFT
+				: DIR_RIGHT
+			);
+
+	if (bal_height != GET_BAL(node) || MAX(left, right) - MIN(left, right) > 1)
+		{
+		return EAVL_ERROR_TREE;
+		}
+
+	CB_VERIFY(
+			node,
+			GET_CHILD(node, DIR_LEFT),
+			GET_CHILD(node, DIR_RIGHT),
+			*verifyp,
+			cbdata
+			);
+
+	return EAVL_OK;
+	}
+
+
+static void PRIVATE(verify_path)(
+		vframe_t		frames[],
+		unsigned int		depth,
+		EAVLc_node_t*		last,
+		EAVLc_node_t*		path[],
+		unsigned int*		pathlenp
+		)
+	{
+	unsigned int		i;
+
+	if (!path)
+		{
+		return;
+		}
+
+	for (i=0; i<depth; i++)
+		{
+		path[i] = frames[i].node;
+		}
+
+	if (last && depth < HEIGHT_MAX)
+		{
+		path[depth++] = last;
+		}
+
+	*pathlenp = depth;
+	}
+
+
+static int PRIVATE(verify_walk)(
+		EAVLc_node_t*		root,
+		unsigned int		cut,
+		vpiece_t		pieces[],
+		EAVLc_node_t**		prevp,
+		unsigned int*		heightp,
+		EAVLc_cbCompare_t	compare,
+		EAVLc_cbVerify_t*	verifyp,
+		void*			cbdata,
+		EAVLc_node_t*		path[],
+		unsigned int*		pathlenp
+		)
+	{
+	vframe_t		frames[HEIGHT_MAX];
+	vframe_t*		frame;
+	EAVLc_node_t*		child;
+	vpiece_t*		piece;
+	unsigned int		depth = 1;
+	unsigned int		height;
+	EAVL_dir_t		dir;
+	int			result;
+
+	frames[0].node = root;
+	frames[0].height[DIR_LEFT] = 0;
+	frames[0].height[DIR_RIGHT] = 0;
+	frames[0].state = DIR_LEFT;
+
+	while (depth)
+		{
+		frame = &frames[depth-1];
+
+		if (frame->state <= DIR_RIGHT)
+			{
+			dir = frame->state++;
+
+			if (dir == DIR_RIGHT)
+				{
+				if ((result = PRIVATE(verify_order)(*prevp, frame->node, compare, cbdata)) != EAVL_OK)
+					{
+					PRIVATE(verify_path)(frames, depth, NULL, path, pathlenp);
+					return result;
+					}
+				*prevp = frame->node;
+				}
+
+			if (!(child = GET_CHILD(frame->node, dir)))
+				{
+				continue;
+				}
+
+			if (depth == cut)
+				{
+				/* Already verified by a job */
+				piece = pieces++;
+				if ((result = PRIVATE(verify_order)(*prevp, piece->first, compare, cbdata)) != EAVL_OK)
+					{
+					PRIVATE(verify_path)(frames, depth, child, path, pathlenp);
+					return result;
+					}
+				*prevp = piece->last;
+				frame->height[dir] = piece->height;
+				continue;
+				}
+
+			if (depth == HEIGHT_MAX)
+				{
+				/* Taller than any tree; a cycle */
+				PRIVATE(verify_path)(frames, depth, NULL, path, pathlenp);
+				return EAVL_ERROR_TREE;
+				}
+
+			frames[depth].node = child;
+			frames[depth].height[DIR_LEFT] = 0;
+			frames[depth].height[DIR_RIGHT] = 0;
+			frames[depth].state = DIR_LEFT;
+			depth++;
+			continue;
+			}
+
+		if ((result = PRIVATE(verify_node)(frame, verifyp, cbdata)) != EAVL_OK)
+			{
+			PRIVATE(verify_path)(frames, depth, NULL, path, pathlenp);
+			return result;
+			}
+
+		height = MAX(frame->height[DIR_LEFT], frame->height[DIR_RIGHT]) + 1;
+		if (--depth)
+			{
+			frames[depth-1].height[frames[depth-1].state-1] = height;
+			}
+		else
+			{
+			*heightp = height;
+			}
+		}
+
+	return EAVL_OK;
+	}
+
+
+static unsigned int PRIVATE(verify_cut)(
+		EAVLc_node_t*		root,
+		unsigned int		cut,
+		vpiece_t		pieces[],
+		unsigned int		stop,
+		EAVLc_node_t*		path[]
+		)
+	{
+	EAVLc_node_t*		stack[VERIFY_CUT_MAX];
+	unsigned int		state[VERIFY_CUT_MAX];
+	EAVLc_node_t*		child;
+	unsigned int		depth = 1;
+	unsigned int		count = 0;
+	unsigned int		i;
+
+	/* Collect the subtrees at the cut, in order; or the path to one */
+	stack[0] = root;
+	state[0] = DIR_LEFT;
+	while (depth)
+		{
+		if (state[depth-1] > DIR_RIGHT)
+			{
+			depth--;
+			continue;
+			}
+
+		if (!(child = GET_CHILD(stack[depth-1], state[depth-1]++)))
+			{
+			continue;
+			}
+
+		if (depth < cut)
+			{
+			stack[depth] = child;
+			state[depth++] = DIR_LEFT;
+			continue;
+			}
+
+		if (count == stop)
+			{
+			for (i=0; i<cut; i++)
+				{
+				path[i] = stack[i];
+				}
+			break;
+			}
+
+		pieces[count++].node = child;
+		}
+
+	return count;
+	}
+
+
+static int PRIVATE(verify_job)(
+		unsigned int		index,
+		void*			jobdata
+		)
+	{
+	EAVLc_node_t*		path[HEIGHT_MAX];
+	verify_t*		verify = jobdata;
+	EAVLc_cbVerify_t	cbverify = verify->verify;
+	vpiece_t*		piece;
+	EAVLc_node_t*		node;
+	unsigned int		pathlen = 0;
+	unsigned int		depth;
+	uintptr_t		i;
+	int			result;
+
+	QUIET_UNUSED(index);
+
+	while ((i = __atomic_fetch_add(&verify->next, 1, __ATOMIC_RELAXED)) < verify->count
+			&& i < __atomic_load_n(&verify->failed, __ATOMIC_RELAXED)
+			)
+		{
+		piece = &verify->pieces[i];
+
+		for (node = piece->node, depth = 0; GET_CHILD(node, DIR_LEFT) && depth < HEIGHT_MAX; depth++)
+			{
+			node = GET_CHILD(node, DIR_LEFT);
+			}
+		piece->first = node;
+		piece->last = NULL;
+
+		if ((result = PRIVATE(verify_walk)(
+				piece->node,
+				VERIFY_NO_CUT,
+				NULL,
+				&piece->last,
+				&piece->height,
+				verify->compare,
+				&cbverify,
+				verify->cbdata,
+				path,
+				&pathlen
+				)) != EAVL_OK)
+			{
+			SPIN_LOCK(&verify->lock);
+			if (i < verify->failed)
+				{
+				__atomic_store_n(&verify->failed, (unsigned int)i, __ATOMIC_RELAXED);
+				verify->result = result;
+				verify->pathlen = MIN(verify->cut + pathlen, HEIGHT_MAX);
+				if (verify->path)
+					{
+					for (depth=verify->cut; depth<verify->pathlen; depth++)
+						{
+						verify->path[depth] = path[depth-verify->cut];
+						}
+					}
+				}
+			SPIN_UNLOCK(&verify->lock);
+			}
+		}
+
+	return EAVL_CB_OK;
+	}
+
+
+int PRIVATE(verify_tree)(
+		EAVLc_node_t*		root,
+		EAVLc_cbCompare_t	compare,
+		EAVLc_cbVerify_t	verify,
+		void*			cbdata,
+		EAVLc_node_t*		path[],
+		unsigned int*		pathlenp
+		)
+	{
+	EAVLc_node_t*		prev = NULL;
+	unsigned int		height;
+
+	if (!root)
+		{
+		return EAVL_OK;
+		}
+
+	return PRIVATE(verify_walk)(
+			root,
+			VERIFY_NO_CUT,
+			NULL,
+			&prev,
+			&height,
+			compare,
+			&verify,
+			cbdata,
+			path,
+			pathlenp
+			);
+	}
+
+
+int PUBLIC(Verify)(
+		EAVLc_context_t*	context,
+		unsigned int		nthreads,
+		EAVL_cbRun_t		cbrun,
+		EAVLc_node_t*		path[],
+		unsigned int*		pathlenp
+		)
+	{
+	verify_t		verify;
+	EAVLc_cbVerify_t	cbverify;
+	EAVLc_node_t*		root;
+	EAVLc_node_t*		prev = NULL;
+	unsigned int		height;
+	unsigned int		pathlen = 0;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_CONTEXT(context, 0);
+
+	if (path && !pathlenp)
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	root = context->tree->root;
+	verify.compare = context->tree->cbset->compare;
+	verify.verify = context->tree->cbset->verify;
+	verify.cbdata = context->common.cbdata;
+
+	if (!root || !cbrun || nthreads < 2)
+		{
+		return PRIVATE(verify_tree)(
+				root,
+				verify.compare,
+				verify.verify,
+				verify.cbdata,
+				path,
+				pathlenp
+				);
+		}
+
+	/* Enough subtrees below the cut for each job to take several */
+	for (verify.cut = 1; verify.cut < VERIFY_CUT_MAX && (1u<<verify.cut) < nthreads*4; verify.cut++)
+		{
+		/* Deeper */
+		}
+
+	verify.count = PRIVATE(verify_cut)(root, verify.cut, verify.pieces, -1u, NULL);
+	verify.next = 0;
+	verify.lock = 0;
+	verify.failed = -1u;
+	verify.result = EAVL_OK;
+	verify.path = path;
+	verify.pathlen = 0;
+
+	if ((*cbrun)(MIN(nthreads, verify.count), &PRIVATE(verify_job), &verify, verify.cbdata) != EAVL_CB_OK)
+		{
+		return EAVL_ERROR_CALLBACK;
+		}
+
+	if (verify.failed != -1u)
+		{
+		if (path)
+			{
+			(void) PRIVATE(verify_cut)(root, verify.cut, verify.pieces, verify.failed, path);
+			*pathlenp = verify.pathlen;
+			}
+		return verify.result;
+		}
+
+	cbverify = verify.verify;
+	result = PRIVATE(verify_walk)(
+			root,
+			verify.cut,
+			verify.pieces,
+			&prev,
+			&height,
+			verify.compare,
+			&cbverify,
+			verify.cbdata,
+			path,
+			&pathlen
+			);
+
+	if (result != EAVL_OK && path)
+		{
+		*pathlenp = pathlen;
+		}
+
+	return result;
+	}
+
+
+/* cTree_verify.c */
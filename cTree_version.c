@@ -0,0 +1,255 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_cTree.h"
+
+#define CHECKS_AVAILABLE	EAVLc_CHECKS_AVAILABLE
+
+#include "cTree.h"
+#include "cTree_internal.h"
+
+#include "checks_internal.h"
+#include "context_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+#include "pathe_internal.h"
+
+
+/*
+** The published root holds one reference. Readers pin it by taking
+** another reference between entering and leaving a reader slot; the
+** writer flips the slot phase after publishing and waits for the old
+** slot to drain before dropping its reference to the old root. A reader
+** that entered the old slot after the flip may already see a later root
+** that the next publish drops without waiting on that slot, so readers
+** check the phase again after entering and retry if it moved. The
+** sequence is odd while the root and count are being replaced.
+*/
+
+
+int PUBLIC(Version_Init)(
+		EAVLc_version_t*	version,
+		EAVLc_cbset_t*		cbset
+		)
+	{
+	int			result;
+
+	CHECK_PARAM_NON_NULL(version);
+
+	/* Readers and the writer share reference counts */
+	if (!EAVLc_ATOMICS_AVAILABLE)
+		{
+		return EAVL_ERROR_BUILD;
+		}
+
+	if ((result = PUBLIC(Tree_Init)(&version->tree, NULL, cbset)) != EAVL_OK)
+		{
+		return result;
+		}
+
+	version->published = NULL;
+	version->count = 0;
+	version->sequence = 0;
+	version->readers[0] = 0;
+	version->readers[1] = 0;
+	version->phase = 0;
+
+	return EAVL_OK;
+	}
+
+
+/*
+** Without a release callback the old version's nodes are still let go of,
+** so the nodes it shares with other cTrees stop counting it as an owner.
+*/
+static int PRIVATE(release_none)(
+		EAVLc_node_t*		node,
+		void*			cbdata
+		)
+	{
+	QUIET_UNUSED(node);
+	QUIET_UNUSED(cbdata);
+
+	return EAVL_CB_OK;
+	}
+
+
+int PUBLIC(Version_Publish)(
+		EAVLc_version_t*	version,
+		EAVLc_context_t*	context,
+		EAVLc_cbRelease_t	cbrelease
+		)
+	{
+	EAVLc_node_t*		root;
+	EAVLc_node_t*		old;
+	unsigned int		phase;
+	int			result = EAVL_OK;
+
+	CHECK_PARAM_NON_NULL(version);
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (context->tree != &version->tree)
+		{
+		RESULT(EAVL_ERROR_CONTEXT);
+		}
+
+	root = version->tree.root;
+	if (root == version->published)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	REFS_INC(root);
+
+	(void) __atomic_fetch_add(&version->sequence, 1, __ATOMIC_SEQ_CST);
+	old = __atomic_exchange_n(&version->published, root, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&version->count, version->tree.count, __ATOMIC_SEQ_CST);
+	(void) __atomic_fetch_add(&version->sequence, 1, __ATOMIC_SEQ_CST);
+
+	/* Every node of the working version is now also in the published one */
+	version->tree.unique = 0;
+
+	phase = __atomic_fetch_add(&version->phase, 1, __ATOMIC_SEQ_CST) & 0x1;
+	while (__atomic_load_n(&version->readers[phase], __ATOMIC_SEQ_CST))
+		{
+		/* Pinning readers are only a few instructions from leaving */
+		}
+
+	if (old)
+		{
+		result = PRIVATE(tree_clear)(
+				old,
+				(cbrelease) ? cbrelease : &PRIVATE(release_none),
+				context->cbpathe,
+				context->common.cbdata
+				);
+		CONTEXT_RESET(context, 0);
+		}
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+static void PRIVATE(version_load)(
+		EAVLc_version_t*	version,
+		EAVLc_tree_t*		tree
+		)
+	{
+	EAVLc_node_t*		root;
+	uintptr_t		count;
+	uintptr_t		sequence;
+
+	do
+		{
+		sequence = __atomic_load_n(&version->sequence, __ATOMIC_SEQ_CST);
+		root = __atomic_load_n(&version->published, __ATOMIC_SEQ_CST);
+		count = __atomic_load_n(&version->count, __ATOMIC_SEQ_CST);
+		} while ((sequence & 0x1)
+				|| sequence != __atomic_load_n(
+						&version->sequence,
+						__ATOMIC_SEQ_CST
+						)
+				);
+
+	tree->root = root;
+	tree->cbset = version->tree.cbset;
+	tree->count = count;
+	tree->unique = 0;
+	CONTEXTS_INIT(tree);
+	tree->common.associations = 0;
+	tree->common.checks = version->tree.common.checks;
+	}
+
+
+int PUBLIC(Version_Pin)(
+		EAVLc_version_t*	version,
+		EAVLc_tree_t*		tree
+		)
+	{
+	unsigned int		phase;
+
+	CHECK_PARAM_NON_NULL(version);
+	CHECK_PARAM_NON_NULL(tree);
+
+	while (1)
+		{
+		phase = __atomic_load_n(&version->phase, __ATOMIC_SEQ_CST) & 0x1;
+		(void) __atomic_fetch_add(&version->readers[phase], 1, __ATOMIC_SEQ_CST);
+
+		if (phase == (__atomic_load_n(&version->phase, __ATOMIC_SEQ_CST) & 0x1))
+			{
+			break;
+			}
+
+		(void) __atomic_fetch_sub(&version->readers[phase], 1, __ATOMIC_RELEASE);
+		}
+
+	PRIVATE(version_load)(version, tree);
+	REFS_INC(tree->root);
+
+	(void) __atomic_fetch_sub(&version->readers[phase], 1, __ATOMIC_RELEASE);
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Version_Read)(
+		EAVLc_version_t*	version,
+		EAVLc_tree_t*		tree
+		)
+	{
+	CHECK_PARAM_NON_NULL(version);
+	CHECK_PARAM_NON_NULL(tree);
+
+	/* Borrowed; only valid while the caller's epoch is entered */
+	PRIVATE(version_load)(version, tree);
+
+	return EAVL_OK;
+	}
+
+
+/* cTree_version.c */
@@ -236,6 +236,19 @@
 #endif	/* CHECKS_AVAILABLE & EAVL_CHECK_CALLBACK */
 
 
+/*
+** cbPathe vector request; a NULL vector is always a retryable failure:
+*/
+#define CB_PATHE_VECTOR(NEEDED, CB, CBDATA, VAR)			\
+	do								\
+		{							\
+		if (!((VAR) = (*(CB))(EAVL_PATHE_VECTOR, (NEEDED), (CBDATA))))	\
+			{						\
+			return EAVL_CALLBACK;				\
+			}						\
+		} while (0)
+
+
 /*
 ** cbRelease:
 */
@@ -48,6 +48,41 @@
 #include "naming_internal.h"
 
 
+/*
+** The checks for a tree are those enabled for its type and allowed for
+** the tree.
+*/
+#define CHECKS_ENABLED(TREE)						\
+	(PUBLIC(Checks_Enabled)						\
+		& ((TREE) ? (TREE)->common.checks : EAVL_CHECK_ALL)	\
+		)
+
+
+/*
+** The expensive checks may be run on only one in every
+** Checks_Interval[] of their uses; an interval of 0 or 1 runs them
+** every time.
+*/
+#define CHECKS_SAMPLED							\
+	(EAVL_CHECK_TREE | EAVL_CHECK_CONTEXT | EAVL_CHECK_ORDER | EAVL_CHECK_PATH)
+
+extern unsigned int	PRIVATE(Checks_Interval)[EAVL_CHECK_COUNT];
+extern uintptr_t	PRIVATE(Checks_Count)[EAVL_CHECK_COUNT];
+
+#define CHECK_SAMPLED(TREE, CHECK)					\
+	((CHECKS_ENABLED((TREE)) & (CHECK))				\
+		&& (PRIVATE(Checks_Interval)[__builtin_ctz((CHECK))] < 2	\
+			|| !(__atomic_add_fetch(			\
+					&PRIVATE(Checks_Count)[__builtin_ctz((CHECK))],	\
+					1,				\
+					__ATOMIC_RELAXED		\
+					)				\
+				% PRIVATE(Checks_Interval)[__builtin_ctz((CHECK))]	\
+				)					\
+			)						\
+		)
+
+
 #define CHECK_STD_PRE(CONTEXT, TREE, REQ)				\
 	do								\
 		{							\
@@ -184,7 +219,7 @@ int PRIVATE(Validate_Tree)(
 #define CHECK_TREE(CONTEXT, TREE)					\
 	do								\
 		{							\
-		if (PUBLIC(Checks_Enabled) & EAVL_CHECK_TREE)		\
+		if (CHECK_SAMPLED((TREE), EAVL_CHECK_TREE))		\
 			{						\
 			int		check_error;			\
 									\
@@ -216,13 +251,47 @@ int PRIVATE(Validate_Tree)(
 #endif	/* CHECKS_AVAILABLE & EAVL_CHECK_TREE */
 
 
+#if CHECKS_AVAILABLE & EAVL_CHECK_PATH
+
+
+int PRIVATE(Validate_Path)(
+		PUBLIC(context_t)*	context,
+		PUBLIC(tree_t)*		tree,
+		PUBLIC(node_t)*		node
+		);
+
+#define CHECK_PATH(CONTEXT, TREE, NODE)					\
+	do								\
+		{							\
+		if (CHECK_SAMPLED((TREE), EAVL_CHECK_PATH))		\
+			{						\
+			int		check_error;			\
+									\
+			check_error = PRIVATE(Validate_Path)(CONTEXT, TREE, NODE);	\
+			if (check_error)				\
+				{					\
+				return check_error;			\
+				}					\
+			}						\
+		} while (0)
+
+
+#else
+
+
+#define CHECK_PATH(CONTEXT, TREE, NODE)	((void)(NODE))
+
+
+#endif	/* CHECKS_AVAILABLE & EAVL_CHECK_PATH */
+
+
 #if CHECKS_AVAILABLE & EAVL_CHECK_ORDER
 
 
 #define CHECK_NODES_ORDER(CONTEXT, COUNT, NODES)			\
 	do								\
 		{							\
-		if (PUBLIC(Checks_Enabled) & EAVL_CHECK_ORDER)		\
+		if (CHECK_SAMPLED((CONTEXT)->tree, EAVL_CHECK_ORDER))	\
 			{						\
 			PUBLIC(cbCompare_t)	compare;		\
 			void*			cbdata;			\
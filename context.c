@@ -79,7 +79,22 @@ static EAVL_dir_t FOREIGN(context_, node_cmp)(
 	}
 
 
-int FOREIGN(context_, find)(
+/*
+** The registry is split by context address so that contexts used by
+** different threads seldom contend for the same lock.
+*/
+static EAVL_context_shard_t* FOREIGN(context_, shard)(
+		EAVL_tree_common_t*	common,
+		EAVL_context_node_t*	node
+		)
+	{
+	uintptr_t	nodev = (uintptr_t)node;
+
+	return &common->contexts[((nodev >> 4) ^ (nodev >> 10)) % EAVL_CONTEXT_SHARDS];
+	}
+
+
+static int FOREIGN(context_, find_locked)(
 		EAVL_context_node_t*	root,
 		EAVL_context_node_t*	node
 		)
@@ -98,35 +113,64 @@ int FOREIGN(context_, find)(
 	}
 
 
+int FOREIGN(context_, find)(
+		EAVL_tree_common_t*	common,
+		EAVL_context_node_t*	node
+		)
+	{
+	EAVL_context_shard_t*	shard;
+	int			result;
+
+	shard = FOREIGN(context_, shard)(common, node);
+
+	SPIN_LOCK(&shard->lock);
+	result = FOREIGN(context_, find_locked)(shard->contexts, node);
+	SPIN_UNLOCK(&shard->lock);
+
+	return result;
+	}
+
+
 void FOREIGN(context_, insert)(
-		EAVL_context_node_t**		rootp,
-		EAVL_context_node_t*		context
+		EAVL_tree_common_t*	common,
+		EAVL_context_node_t*	context
 		)
 	{
+	EAVL_context_shard_t*	shard;
 	EAVL_pnode_t*		dummy;
 
+	shard = FOREIGN(context_, shard)(common, context);
+
+	SPIN_LOCK(&shard->lock);
 	(void) FOREIGN(p_, insert)(
-			rootp,
+			&shard->contexts,
 			context,
 			&FOREIGN(context_, node_cmp),
 			NULL,
 			NULL,
 			&dummy
 			);
+	SPIN_UNLOCK(&shard->lock);
 
 	return;
 	}
 
 
 void FOREIGN(context_, remove)(
-		EAVL_context_node_t**	rootp,
+		EAVL_tree_common_t*	common,
 		EAVL_context_node_t*	context
 		)
 	{
-	if (EAVL_OK == FOREIGN(context_, find)(*rootp, context))
+	EAVL_context_shard_t*	shard;
+
+	shard = FOREIGN(context_, shard)(common, context);
+
+	SPIN_LOCK(&shard->lock);
+	if (EAVL_OK == FOREIGN(context_, find_locked)(shard->contexts, context))
 		{
-		(void) FOREIGN(p_, remove)(rootp, context, NULL, NULL, NULL);
+		(void) FOREIGN(p_, remove)(&shard->contexts, context, NULL, NULL, NULL);
 		}
+	SPIN_UNLOCK(&shard->lock);
 
 	return;
 	}
@@ -45,24 +45,68 @@
 
 #include "EAVL.h"
 
+#include "eavl_internal.h"
 #include "naming_internal.h"
 
 
+/*
+** A context holding a node is current while the tree's generation is
+** the one it saw when the node was set; tree generations are odd.
+*/
+#define GENERATION_SET(CONTEXT, NODE)					\
+	do								\
+		{							\
+		(CONTEXT)->common.generation = (NODE)			\
+				? (CONTEXT)->tree->common.generation	\
+				: 0;					\
+		} while (0)
+
+
+#if CHECKS_AVAILABLE & EAVL_CHECK_GENERATION
+
+
+#define CHECK_GENERATION(CONTEXT, REQ)					\
+	do								\
+		{							\
+		if (CHECKS_ENABLED((CONTEXT)->tree) & EAVL_CHECK_GENERATION)	\
+			{						\
+			if (&(CONTEXT)->common != (CONTEXT)->common.self	\
+					|| !(CONTEXT)->tree		\
+					|| ((REQ) && (CONTEXT)->common.generation	\
+						!= (CONTEXT)->tree->common.generation	\
+						)			\
+					)				\
+				{					\
+				return EAVL_ERROR_CONTEXT;		\
+				}					\
+			}						\
+		} while (0)
+
+
+#else
+
+
+#define CHECK_GENERATION(CONTEXT, REQ)	((void)0)
+
+
+#endif	/* CHECKS_AVAILABLE & EAVL_CHECK_GENERATION */
+
+
 #if CHECKS_AVAILABLE & EAVL_CHECK_CONTEXT
 
 
 int FOREIGN(context_, find)(
-		EAVL_context_node_t*	root,
+		EAVL_tree_common_t*	common,
 		EAVL_context_node_t*	node
 		);
 
 void FOREIGN(context_, insert)(
-		EAVL_context_node_t**	rootp,
+		EAVL_tree_common_t*	common,
 		EAVL_context_node_t*	context
 		);
 
 void FOREIGN(context_, remove)(
-		EAVL_context_node_t**	rootp,
+		EAVL_tree_common_t*	common,
 		EAVL_context_node_t*	context
 		);
 
@@ -70,30 +114,31 @@ void FOREIGN(context_, remove)(
 #define CONTEXT_SET(CONTEXT, NODE, POS, NO_TRUNCATE)			\
 	do								\
 		{							\
-		if (PUBLIC(Checks_Enabled) & EAVL_CHECK_CONTEXT)	\
+		if (CHECKS_ENABLED((CONTEXT)->tree) & EAVL_CHECK_CONTEXT)	\
 			{						\
 			if ((NODE))					\
 				{					\
 				FOREIGN(context_, insert)(		\
-					&(CONTEXT)->tree->common.contexts,	\
+					&(CONTEXT)->tree->common,	\
 					&(CONTEXT)->common.node		\
 					);				\
 				}					\
 			else						\
 				{					\
 				FOREIGN(context_, remove)(		\
-					&(CONTEXT)->tree->common.contexts,	\
+					&(CONTEXT)->tree->common,	\
 					&(CONTEXT)->common.node		\
 					);				\
 				}					\
 			}						\
 		RECENT_SET((CONTEXT), (NODE), (POS), (NO_TRUNCATE));	\
+		GENERATION_SET((CONTEXT), (NODE));			\
 		} while (0)
 
 #define CHECK_CONTEXT(CONTEXT, REQ)					\
 	do								\
 		{							\
-		if (PUBLIC(Checks_Enabled) & EAVL_CHECK_CONTEXT)	\
+		if (CHECK_SAMPLED((CONTEXT)->tree, EAVL_CHECK_CONTEXT))	\
 			{						\
 			int		inTree = 0;			\
 			int		isLinked;			\
@@ -107,7 +152,7 @@ void FOREIGN(context_, remove)(
 				}					\
 									\
 			isLinked = (EAVL_OK == FOREIGN(context_, find)(	\
-					context->tree->common.contexts,	\
+					&context->tree->common,		\
 					&context->common.node		\
 					));				\
 									\
@@ -126,6 +171,7 @@ void FOREIGN(context_, remove)(
 				return EAVL_ERROR_CONTEXT;		\
 				}					\
 			}						\
+		CHECK_GENERATION((CONTEXT), (REQ));			\
 		} while (0)
 
 
@@ -133,9 +179,13 @@ void FOREIGN(context_, remove)(
 
 
 #define CONTEXT_SET(CONTEXT, NODE, POS, NO_TRUNCATE)			\
-	RECENT_SET((CONTEXT), (NODE), (POS), (NO_TRUNCATE));
+	do								\
+		{							\
+		RECENT_SET((CONTEXT), (NODE), (POS), (NO_TRUNCATE));	\
+		GENERATION_SET((CONTEXT), (NODE));			\
+		} while (0)
 
-#define CHECK_CONTEXT(CONTEXT, REQ)	((void)0)
+#define CHECK_CONTEXT(CONTEXT, REQ)	CHECK_GENERATION((CONTEXT), (REQ))
 
 
 #endif	/* CHECKS_AVAILABLE & EAVL_CHECK_CONTEXT */
@@ -144,11 +194,58 @@ void FOREIGN(context_, remove)(
 #define CONTEXT_RESET(CONTEXT, NO_TRUNCATE)				\
 	CONTEXT_SET((CONTEXT), NULL, 0, (NO_TRUNCATE))
 
+#define CONTEXTS_INIT(TREE)						\
+	do								\
+		{							\
+		unsigned int	shard_i;				\
+									\
+		for (shard_i=0; shard_i<EAVL_CONTEXT_SHARDS; shard_i++)	\
+			{						\
+			(TREE)->common.contexts[shard_i].contexts = NULL;	\
+			(TREE)->common.contexts[shard_i].lock = 0;	\
+			}						\
+		(TREE)->common.generation = 1;				\
+		} while (0)
+
+/*
+** Moving the generation on is enough to retire every other context;
+** the registry only needs emptying when context checks keep one.
+*/
+#if CHECKS_AVAILABLE & EAVL_CHECK_CONTEXT
+
+
+#define CONTEXT_RESET_ALL(CONTEXT)					\
+	do								\
+		{							\
+		EAVL_context_shard_t*	shard_s;			\
+		unsigned int		shard_i;			\
+									\
+		(CONTEXT)->tree->common.generation += 2;		\
+									\
+		if (CHECKS_ENABLED((CONTEXT)->tree) & EAVL_CHECK_CONTEXT)	\
+			{						\
+			for (shard_i=0; shard_i<EAVL_CONTEXT_SHARDS; shard_i++)	\
+				{					\
+				shard_s = &(CONTEXT)->tree->common.contexts[shard_i];	\
+				SPIN_LOCK(&shard_s->lock);		\
+				shard_s->contexts = NULL;		\
+				SPIN_UNLOCK(&shard_s->lock);		\
+				}					\
+			}						\
+		} while (0)
+
+
+#else
+
+
 #define CONTEXT_RESET_ALL(CONTEXT)					\
 	do								\
 		{							\
-		(CONTEXT)->tree->common.contexts = NULL;		\
+		(CONTEXT)->tree->common.generation += 2;		\
 		} while (0)
 
 
+#endif	/* CHECKS_AVAILABLE & EAVL_CHECK_CONTEXT */
+
+
 #endif	/* _CONTEXT_INTERNAL_H */
@@ -61,6 +61,38 @@
 #define DIR_OTHER(DIR)		EAVL_DIR_OTHER(DIR)
 
 
+/*
+** AVL height is under 1.44*log2(n+2); no tree that fits in the address
+** space can be taller than 1.5 levels per address bit.
+*/
+#define HEIGHT_MAX		EAVL_HEIGHT_MAX
+
+
+/*
+** Spin locks on a uintptr_t; 0 is unlocked.
+*/
+#define SPIN_TRYLOCK(LOCK)						\
+	(!__atomic_exchange_n((LOCK), 1, __ATOMIC_ACQUIRE))
+
+#define SPIN_LOCK(LOCK)							\
+	do								\
+		{							\
+		while (!SPIN_TRYLOCK((LOCK)))				\
+			{						\
+			while (__atomic_load_n((LOCK), __ATOMIC_RELAXED))	\
+				{					\
+				/* Lock held */				\
+				}					\
+			}						\
+		} while (0)
+
+#define SPIN_UNLOCK(LOCK)						\
+	do								\
+		{							\
+		__atomic_store_n((LOCK), 0, __ATOMIC_RELEASE);		\
+		} while (0)
+
+
 #define MAX(A, B)		( ((A) >= (B)) ? (A) : (B) )
 #define MIN(A, B)		( ((A) <= (B)) ? (A) : (B) )
 
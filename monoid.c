@@ -0,0 +1,101 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL.h"
+
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** Sums wrap modulo 2^64 rather than overflow; unlike saturation this
+** keeps the combination associative.
+*/
+static EAVL_aug_value_t PRIVATE(monoid_sum)(
+		EAVL_aug_value_t	left,
+		EAVL_aug_value_t	right
+		)
+	{
+	return (EAVL_aug_value_t)((uint64_t)left + (uint64_t)right);
+	}
+
+
+static EAVL_aug_value_t PRIVATE(monoid_min)(
+		EAVL_aug_value_t	left,
+		EAVL_aug_value_t	right
+		)
+	{
+	return (right < left) ? right : left;
+	}
+
+
+static EAVL_aug_value_t PRIVATE(monoid_max)(
+		EAVL_aug_value_t	left,
+		EAVL_aug_value_t	right
+		)
+	{
+	return (right > left) ? right : left;
+	}
+
+
+const EAVL_monoid_t PUBLIC(Monoid_Sum) =
+	{
+	&PRIVATE(monoid_sum),
+	0
+	};
+
+const EAVL_monoid_t PUBLIC(Monoid_Min) =
+	{
+	&PRIVATE(monoid_min),
+	INT64_MAX
+	};
+
+const EAVL_monoid_t PUBLIC(Monoid_Max) =
+	{
+	&PRIVATE(monoid_max),
+	INT64_MIN
+	};
+
+
+/* monoid.c */
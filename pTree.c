@@ -54,6 +54,7 @@
 #include "context_internal.h"
 #include "eavl_internal.h"
 #include "naming_internal.h"
+#include "serialize_internal.h"
 #include "treeload_internal.h"
 
 
@@ -81,8 +82,10 @@ int PUBLIC(Tree_Init)(
 		}
 
 	tree->root = NULL;
-	tree->common.contexts = NULL;
+	CONTEXTS_INIT(tree);
 	tree->common.associations = 0;
+	tree->common.checks = EAVL_CHECK_ALL;
+	tree->deferred = 0;
 
 	return EAVL_OK;
 	}
@@ -179,6 +182,7 @@ int PUBLIC(Context_Init)(
 	context->tree = NULL;
 	context->common.self = &context->common;
 	context->common.cbdata = cbdata;
+	context->common.generation = 0;
 	context->recent = NULL;
 
 	return EAVL_OK;
@@ -201,7 +205,7 @@ int PUBLIC(Context_Associate)(
 		}
 
 	context->tree = tree;
-	tree->common.associations++;
+	(void) __atomic_add_fetch(&tree->common.associations, 1, __ATOMIC_RELAXED);
 
 	CONTEXT_RESET(context, 0);
 
@@ -227,7 +231,7 @@ int PUBLIC(Context_Disassociate)(
 	CONTEXT_RESET(context, 0);
 
 	context->tree = NULL;
-	tree->common.associations--;
+	(void) __atomic_sub_fetch(&tree->common.associations, 1, __ATOMIC_RELAXED);
 
 	CHECK_TREE(context, tree);
 
@@ -267,9 +271,16 @@ int PRIVATE(find)(
 	EAVLp_node_t*		left = NULL;
 	EAVLp_node_t*		right = NULL;
 	EAVL_dir_t		cmp;
+	unsigned int		depth = HEIGHT_MAX;
 
 	while (node)
 		{
+		if (!depth--)
+			{
+			/* A cycle; or the tree changed under an optimistic reader */
+			return EAVL_ERROR_TREE;
+			}
+
 		CB_COMPARE(ref_value, ref_node, node, compare, cbdata, cmp);
 		switch (CMP_REL_MAP(rel, cmp))
 			{
@@ -356,6 +367,56 @@ int PUBLIC(Find)(
 	}
 
 
+/*
+** Without a saved path, a context that is no longer current is re-sought
+** from the root.
+*/
+int PUBLIC(Context_Reseek)(
+		EAVLp_context_t*	context
+		)
+	{
+	EAVLp_node_t*		recent;
+	EAVLp_node_t*		node;
+	int			result = EAVL_OK;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	recent = context->recent;
+	if (!recent)
+		{
+		RESULT(EAVL_ERROR_CONTEXT);
+		}
+
+	if (context->common.generation == context->tree->common.generation)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	CONTEXT_RESET(context, 0);
+
+	result = PRIVATE(find)(
+			context->tree->root,
+			EAVL_FIND_EQ,
+			context->tree->cbset->compare,
+			context->common.cbdata,
+			NULL,
+			recent,
+			&node
+			);
+
+	if (result == EAVL_OK)
+		{
+		CONTEXT_SET(context, node, 0, 0);
+		}
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
 int PUBLIC(First)(
 		EAVLp_context_t*	context,
 		EAVL_dir_t		dir,
@@ -522,6 +583,80 @@ int PUBLIC(Next)(
 	}
 
 
+/*
+** The fixup callback used while a tree defers its fixups; it only marks the
+** nodes that the real callback would have been called for.
+*/
+static int PRIVATE(fixup_mark)(
+		EAVLp_node_t*		node,
+		EAVLp_node_t*		childL,
+		EAVLp_node_t*		childR,
+		void*			cbdata
+		)
+	{
+	QUIET_UNUSED(childL);
+	QUIET_UNUSED(childR);
+	QUIET_UNUSED(cbdata);
+
+	if (IS_DIRTY(node))
+		{
+		return EAVL_CB_FINISHED;
+		}
+
+	SET_DIRTY(node);
+
+	return EAVL_CB_OK;
+	}
+
+
+#define TREE_FIXUP(TREE)						\
+		(((TREE)->deferred && (TREE)->cbset->fixup)		\
+				? &PRIVATE(fixup_mark)			\
+				: (TREE)->cbset->fixup			\
+				)
+
+
+/*
+** Fixup every marked node, children before parents. The marked nodes are
+** the union of the paths from the changed nodes to the root, so each one is
+** visited once.
+*/
+int PRIVATE(fixup_dirty)(
+		EAVLp_node_t*		node,
+		EAVLp_cbFixup_t		fixup,
+		void*			cbdata
+		)
+	{
+	EAVLp_node_t*		T;
+
+	if (!node || !IS_DIRTY(node))
+		{
+		return EAVL_OK;
+		}
+
+	while (node)
+		{
+		if ((T = GET_CHILD(node, DIR_LEFT)) && IS_DIRTY(T))
+			{
+			node = T;
+			continue;
+			}
+
+		if ((T = GET_CHILD(node, DIR_RIGHT)) && IS_DIRTY(T))
+			{
+			node = T;
+			continue;
+			}
+
+		CLEAR_DIRTY(node);
+		NODE_FIXUP(node, 1, fixup, cbdata);
+		node = GET_PARENT(node);
+		}
+
+	return EAVL_OK;
+	}
+
+
 int PUBLIC(Fixup)(
 		EAVLp_context_t*	context
 		)
@@ -539,6 +674,17 @@ int PUBLIC(Fixup)(
 	fixup = context->tree->cbset->fixup;
 	cbdata = context->common.cbdata;
 
+	if (fixup && context->tree->deferred)
+		{
+		while (curr && !IS_DIRTY(curr))
+			{
+			SET_DIRTY(curr);
+			curr = GET_PARENT(curr);
+			}
+
+		RESULT(PRIVATE(fixup_dirty)(context->tree->root, fixup, cbdata));
+		}
+
 	while (fixup && curr)
 		{
 		NODE_FIXUP(curr, 0, fixup, cbdata);
@@ -551,6 +697,33 @@ int PUBLIC(Fixup)(
 	}
 
 
+int PUBLIC(Fixup_Deferred)(
+		EAVLp_context_t*	context,
+		unsigned int		deferred
+		)
+	{
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	result = PRIVATE(fixup_dirty)(
+			context->tree->root,
+			context->tree->cbset->fixup,
+			context->common.cbdata
+			);
+	if (result == EAVL_OK)
+		{
+		context->tree->deferred = (deferred) ? 1 : 0;
+		}
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
 static void PRIVATE(load_setchild)(
 		void**			nodep,
 		unsigned int		parentindex,
@@ -665,6 +838,109 @@ int PUBLIC(Load)(
 	}
 
 
+static void* PRIVATE(serialize_getchild)(
+		void*			node,
+		EAVL_dir_t		dir
+		)
+	{
+	return GET_CHILD((EAVLp_node_t*)node, dir);
+	}
+
+
+int PUBLIC(Serialize)(
+		EAVLp_context_t*	context,
+		unsigned int*		countp,
+		EAVLp_node_t**		nodes,
+		unsigned char*		shape
+		)
+	{
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(countp);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (*countp)
+		{
+		CHECK_PARAM_NON_NULL(nodes);
+		CHECK_PARAM_NON_NULL(shape);
+		}
+
+	result = FOREIGN(_, serialize)(
+			context->tree->root,
+			countp,
+			(void**)nodes,
+			shape,
+			&PRIVATE(serialize_getchild)
+			);
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+int PUBLIC(Deserialize)(
+		EAVLp_context_t*	context,
+		unsigned int		count,
+		EAVLp_node_t**		nodes,
+		unsigned char*		shape,
+		int			fixup
+		)
+	{
+	unsigned int		rootindex;
+	unsigned int		i;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+	if (context->tree->root)
+		{
+		RESULT(EAVL_ERROR_PARAMETER);
+		}
+
+	if (!count)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	CHECK_PARAM_NON_NULL(nodes);
+	CHECK_PARAM_NON_NULL(shape);
+	CHECK_NODES_ALIGN(count, nodes);
+
+	for (i=0; i<count; i++)
+		{
+		NODE_INIT(nodes[i]);
+		}
+
+	result = FOREIGN(_, deserialize)(
+			&rootindex,
+			count,
+			(void**)nodes,
+			shape,
+			&PRIVATE(load_cbset),
+			(fixup)
+				? (FOREIGN(_, load_cbFixup_t))context->tree->cbset->fixup
+				: NULL,
+			context->common.cbdata
+			);
+
+	if (result == EAVL_OK)
+		{
+		context->tree->root = nodes[rootindex];
+		}
+
+	CONTEXT_RESET_ALL(context);
+	CONTEXT_RESET(context, 0);
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
 static void PRIVATE(rotate_single)(
 		EAVL_dir_t		dir,
 		EAVLp_node_t*		P,	// Never NULL
@@ -879,7 +1155,7 @@ int PUBLIC(Insert)(
 			&context->tree->root,
 			new_node,
 			context->tree->cbset->compare,
-			context->tree->cbset->fixup,
+			TREE_FIXUP(context->tree),
 			context->common.cbdata,
 			resultp
 			);
@@ -888,6 +1164,7 @@ int PUBLIC(Insert)(
 		{
 		CONTEXT_RESET_ALL(context);
 		CONTEXT_SET(context, *resultp, 0, 0);
+		CHECK_PATH(context, context->tree, *resultp);
 		}
 	else if (result == EAVL_EXISTS)
 		{
@@ -1107,16 +1384,19 @@ int PUBLIC(Remove)(
 		EAVLp_node_t**		nodep
 		)
 	{
+	EAVLp_node_t*		del_node;
 	int			result;
 
 	CHECK_PARAM_NON_NULL(context);
 
 	CHECK_STD_PRE(context, context->tree, 1);
 
+	del_node = context->recent;
+
 	result = PRIVATE(remove)(
 			&context->tree->root,
 			context->recent,
-			context->tree->cbset->fixup,
+			TREE_FIXUP(context->tree),
 			context->common.cbdata,
 			nodep
 			);
@@ -1124,6 +1404,11 @@ int PUBLIC(Remove)(
 	CONTEXT_RESET_ALL(context);
 	CONTEXT_RESET(context, 0);
 
+	if (result == EAVL_OK)
+		{
+		CHECK_PATH(context, context->tree, del_node);
+		}
+
 	CHECK_STD_POST(context->tree, context);
 
 	RETURN;
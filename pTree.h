@@ -90,7 +90,27 @@
 #define SET_PARENTONLY(NODE, PARENT)					\
 	do								\
 		{							\
-		(NODE)->parent = (PARENT);				\
+		(NODE)->parent = (EAVLp_node_t*)((uintptr_t)(PARENT)	\
+				| EAVL_GET_LOW((NODE)->parent));	\
+		} while (0)
+
+/*
+** A node waiting for a deferred fixup has the low bit of its parent link
+** set. The ancestors of such a node are always also waiting.
+*/
+#define IS_DIRTY(NODE)			EAVL_GET_LOW((NODE)->parent)
+
+#define SET_DIRTY(NODE)							\
+	do								\
+		{							\
+		(NODE)->parent = (EAVLp_node_t*)((uintptr_t)(NODE)->parent	\
+				| 0x1u);				\
+		} while (0)
+
+#define CLEAR_DIRTY(NODE)						\
+	do								\
+		{							\
+		(NODE)->parent = GET_PARENT((NODE));			\
 		} while (0)
 
 #define SET_CHILD(PARENT, CHILD, DIR)					\
@@ -41,7 +41,6 @@
 
 
 #include <stddef.h>
-#include <stdlib.h>
 
 #include "EAVL.h"
 #include "EAVL_pTree.h"
@@ -59,138 +58,422 @@
 unsigned int	PUBLIC(Checks_Available) = EAVLp_CHECKS_AVAILABLE & EAVL_CHECK_ALL;
 unsigned int	PUBLIC(Checks_Enabled) = 0;
 
+unsigned int	PRIVATE(Checks_Interval)[EAVL_CHECK_COUNT];
+uintptr_t	PRIVATE(Checks_Count)[EAVL_CHECK_COUNT];
+
+
+int PUBLIC(Checks_Sample)(
+		unsigned int		checks,
+		unsigned int		interval
+		)
+	{
+	unsigned int		i;
+
+	if (checks & ~CHECKS_SAMPLED)
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	for (i=0; i<EAVL_CHECK_COUNT; i++)
+		{
+		if (checks & (1u<<i))
+			{
+			PRIVATE(Checks_Interval)[i] = interval;
+			__atomic_store_n(&PRIVATE(Checks_Count)[i], 0, __ATOMIC_RELAXED);
+			}
+		}
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Tree_Checks)(
+		EAVLp_tree_t*		tree,
+		unsigned int		checks
+		)
+	{
+	if (!tree || (checks & ~EAVL_CHECK_ALL))
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	/* The record of associated contexts would be incomplete */
+	if (tree->common.associations
+			&& ((tree->common.checks ^ checks) & EAVL_CHECK_CONTEXT)
+			)
+		{
+		return EAVL_ERROR_CONTEXT;
+		}
+
+	tree->common.checks = checks;
+
+	return EAVL_OK;
+	}
+
 
 #if CHECKS_AVAILABLE & EAVL_CHECK_TREE
 
 
-static int PRIVATE(validate_tree_recurse)(
-		EAVLp_node_t*		node,
-		EAVLp_node_t*		parent,
-		EAVL_dir_t		dir,
-		int*			heightp,
-		EAVLp_node_t**		leftp,
-		EAVLp_cbCompare_t	compare,
+/*
+** The tree is walked in post-order with an explicit stack of at most
+** HEIGHT_MAX frames, checking order at each in-order step and balance
+** and cbVerify once both subtrees are done; a cycle fails the check
+** instead of overflowing the stack.
+*/
+typedef struct
+	{
+	EAVLp_node_t*		node;
+	unsigned int		height[2];
+	unsigned int		state;		/* Next child to walk		*/
+	}			vframe_t;
+
+
+static int PRIVATE(validate_node)(
+		vframe_t*		frame,
 		EAVLp_cbVerify_t*	verifyp,
 		void*			cbdata
 		)
 	{
-	int			result;
-	int			height[2] = {0, 0};
-	EAVL_dir_t		bal_node;
+	EAVLp_node_t*		node = frame->node;
+	unsigned int		left = frame->height[DIR_LEFT];
+	unsigned int		right = frame->height[DIR_RIGHT];
 	EAVL_dir_t		bal_height;
-	EAVLp_node_t*		T;
-	EAVL_dir_t		cmp;
 
-	if (GET_PARENT(node) != parent || (parent && GET_CHILD(parent, dir) != node))
+	bal_height = (left == right)
+			? DIR_NEITHER
+			: ((left > right)
+				? DIR_LEFT
+				: DIR_RIGHT
+			);
+
+	if (bal_height != GET_BAL(node) || MAX(left, right) - MIN(left, right) > 1)
 		{
 		return EAVL_ERROR_TREE;
 		}
 
-	T = GET_CHILD(node, DIR_LEFT);
-	if (T)
+	/* A node waiting for a deferred fixup is expected to be stale */
+	if (!IS_DIRTY(node))
 		{
-		result = PRIVATE(validate_tree_recurse)(
-				T,
+		CB_VERIFY(
 				node,
-				DIR_LEFT,
-				&height[DIR_LEFT],
-				leftp,
-				compare,
-				verifyp,
+				GET_CHILD(node, DIR_LEFT),
+				GET_CHILD(node, DIR_RIGHT),
+				*verifyp,
 				cbdata
 				);
-		if (result != EAVL_OK)
+		}
+
+	return EAVL_OK;
+	}
+
+
+static int PRIVATE(validate_tree_walk)(
+		EAVLp_node_t*		root,
+		EAVLp_cbCompare_t	compare,
+		EAVLp_cbVerify_t*	verifyp,
+		void*			cbdata
+		)
+	{
+	vframe_t		frames[HEIGHT_MAX];
+	vframe_t*		frame;
+	EAVLp_node_t*		child;
+	EAVLp_node_t*		prev = NULL;
+	unsigned int		depth = 1;
+	EAVL_dir_t		dir;
+	EAVL_dir_t		cmp;
+	int			result;
+
+	if (GET_PARENT(root))
+		{
+		return EAVL_ERROR_TREE;
+		}
+
+	frames[0].node = root;
+	frames[0].height[DIR_LEFT] = 0;
+	frames[0].height[DIR_RIGHT] = 0;
+	frames[0].state = DIR_LEFT;
+
+	while (depth)
+		{
+		frame = &frames[depth-1];
+
+		if (frame->state <= DIR_RIGHT)
+			{
+			dir = frame->state++;
+
+			if (dir == DIR_RIGHT)
+				{
+				if (prev)
+					{
+					CB_COMPARE(NULL, prev, frame->node, compare, cbdata, cmp);
+					if (cmp != DIR_RIGHT)
+						{
+						return EAVL_ERROR_COMPARE;
+						}
+					}
+				prev = frame->node;
+				}
+
+			if (!(child = GET_CHILD(frame->node, dir)))
+				{
+				continue;
+				}
+
+			if (GET_PARENT(child) != frame->node)
+				{
+				return EAVL_ERROR_TREE;
+				}
+
+			if (depth == HEIGHT_MAX)
+				{
+				/* Taller than any tree; a cycle */
+				return EAVL_ERROR_TREE;
+				}
+
+			frames[depth].node = child;
+			frames[depth].height[DIR_LEFT] = 0;
+			frames[depth].height[DIR_RIGHT] = 0;
+			frames[depth].state = DIR_LEFT;
+			depth++;
+			continue;
+			}
+
+		if ((result = PRIVATE(validate_node)(frame, verifyp, cbdata)) != EAVL_OK)
 			{
 			return result;
 			}
-		}
 
-	if (*leftp)
-		{
-		CB_COMPARE(NULL, *leftp, node, compare, cbdata, cmp);
-		if (cmp != DIR_RIGHT)
+		if (--depth)
 			{
-			return EAVL_ERROR_COMPARE;
+			frames[depth-1].height[frames[depth-1].state-1]
+					= MAX(frame->height[DIR_LEFT], frame->height[DIR_RIGHT]) + 1;
 			}
 		}
 
-	*leftp = node;
+	return EAVL_OK;
+	}
+
+
+int PRIVATE(Validate_Tree)(
+		EAVLp_context_t*	context,
+		EAVLp_tree_t*		tree
+		)
+	{
+	int			result = EAVL_OK;
+	EAVLp_cbVerify_t	verify = tree->cbset->verify;
 
-	T = GET_CHILD(node, DIR_RIGHT);
-	if (T)
+	if (tree->root)
 		{
-		result = PRIVATE(validate_tree_recurse)(
-				T,
-				node,
-				DIR_RIGHT,
-				&height[DIR_RIGHT],
-				leftp,
-				compare,
-				verifyp,
-				cbdata
+		result = PRIVATE(validate_tree_walk)(
+				tree->root,
+				tree->cbset->compare,
+				&verify,
+				context->common.cbdata
 				);
-		if (result != EAVL_OK)
+		}
+
+	return result;
+	}
+
+
+#endif	/* EAVLp_CHECKS_AVAILABLE & EAVL_CHECK_TREE */
+
+
+#if CHECKS_AVAILABLE & EAVL_CHECK_PATH
+
+
+static unsigned int PRIVATE(path_height)(
+		EAVLp_node_t*		node
+		)
+	{
+	unsigned int		height = 0;
+
+	/* Below the checked nodes the balance information is trusted */
+	while (node && height < HEIGHT_MAX)
+		{
+		height++;
+		node = GET_CHILD(node, (GET_BAL(node) == DIR_RIGHT) ? DIR_RIGHT : DIR_LEFT);
+		}
+
+	return height;
+	}
+
+
+static int PRIVATE(path_check_node)(
+		EAVLp_node_t*		node,
+		EAVLp_cbCompare_t	compare,
+		EAVLp_cbVerify_t*	verifyp,
+		void*			cbdata
+		)
+	{
+	EAVLp_node_t*		T;
+	unsigned int		height[2];
+	unsigned int		depth;
+	EAVL_dir_t		bal_height;
+	EAVL_dir_t		dir;
+	EAVL_dir_t		cmp;
+
+	for (dir=DIR_LEFT; dir<=DIR_RIGHT; dir++)
+		{
+		T = GET_CHILD(node, dir);
+		height[dir] = PRIVATE(path_height)(T);
+
+		if (!T)
 			{
-			return result;
+			continue;
+			}
+
+		/* The in-order neighbour on this side */
+		for (depth=0; GET_CHILD(T, DIR_OTHER(dir)); depth++)
+			{
+			if (depth == HEIGHT_MAX)
+				{
+				return EAVL_ERROR_TREE;
+				}
+			T = GET_CHILD(T, DIR_OTHER(dir));
+			}
+
+		CB_COMPARE(NULL, node, T, compare, cbdata, cmp);
+		if (cmp != dir)
+			{
+			return EAVL_ERROR_COMPARE;
 			}
 		}
 
-	bal_height = (height[0] == height[1])
+	bal_height = (height[DIR_LEFT] == height[DIR_RIGHT])
 			? DIR_NEITHER
-			: ((height[0] > height[1])
+			: ((height[DIR_LEFT] > height[DIR_RIGHT])
 				? DIR_LEFT
 				: DIR_RIGHT
 			);
-	bal_node = GET_BAL(node);
 
-	if (bal_height != bal_node || abs(height[0]-height[1]) > 1)
+	if (bal_height != GET_BAL(node)
+			|| MAX(height[DIR_LEFT], height[DIR_RIGHT])
+				- MIN(height[DIR_LEFT], height[DIR_RIGHT]) > 1
+			)
 		{
 		return EAVL_ERROR_TREE;
 		}
 
-	*heightp = MAX(height[0], height[1])+1;
+	/* A node waiting for a deferred fixup is expected to be stale */
+	if (!IS_DIRTY(node))
+		{
+		CB_VERIFY(
+				node,
+				GET_CHILD(node, DIR_LEFT),
+				GET_CHILD(node, DIR_RIGHT),
+				*verifyp,
+				cbdata
+				);
+		}
+
+	return EAVL_OK;
+	}
 
-	CB_VERIFY(
-			node,
-			GET_CHILD(node, DIR_LEFT),
-			GET_CHILD(node, DIR_RIGHT),
-			*verifyp,
-			cbdata
-			);
+
+static int PRIVATE(path_check)(
+		EAVLp_node_t*		node,
+		EAVLp_cbCompare_t	compare,
+		EAVLp_cbVerify_t*	verifyp,
+		void*			cbdata
+		)
+	{
+	EAVLp_node_t*		T;
+	EAVL_dir_t		dir;
+	int			result;
+
+	/* Rotations leave changed nodes beside the path too */
+	if ((result = PRIVATE(path_check_node)(node, compare, verifyp, cbdata)) != EAVL_OK)
+		{
+		return result;
+		}
+
+	for (dir=DIR_LEFT; dir<=DIR_RIGHT; dir++)
+		{
+		if ((T = GET_CHILD(node, dir))
+				&& (result = PRIVATE(path_check_node)(T, compare, verifyp, cbdata)) != EAVL_OK
+				)
+			{
+			return result;
+			}
+		}
 
 	return EAVL_OK;
 	}
 
 
-int PRIVATE(Validate_Tree)(
+int PRIVATE(Validate_Path)(
 		EAVLp_context_t*	context,
-		EAVLp_tree_t*		tree
+		EAVLp_tree_t*		tree,
+		EAVLp_node_t*		node
 		)
 	{
-	int			result = EAVL_OK;
-	int			height;
+	EAVLp_cbCompare_t	compare = tree->cbset->compare;
 	EAVLp_cbVerify_t	verify = tree->cbset->verify;
-	EAVLp_node_t*		left = NULL;
+	void*			cbdata = context->common.cbdata;
+	EAVLp_node_t*		nearest[2] = {NULL, NULL};
+	EAVLp_node_t*		curr;
+	unsigned int		depth = 0;
+	EAVL_dir_t		dir;
+	EAVL_dir_t		cmp = DIR_NEITHER;
+	int			result;
 
-	if (tree->root)
+	/* The path to where the node is, or was */
+	for (curr = tree->root; curr; curr = GET_CHILD(curr, DIR_OTHER(cmp)))
 		{
-		result = PRIVATE(validate_tree_recurse)(
-				tree->root,
-				NULL,
-				0,
-				&height,
-				&left,
-				tree->cbset->compare,
-				&verify,
-				context->common.cbdata
-				);
+		if (depth++ == HEIGHT_MAX)
+			{
+			return EAVL_ERROR_TREE;
+			}
+
+		if ((result = PRIVATE(path_check)(curr, compare, &verify, cbdata)) != EAVL_OK)
+			{
+			return result;
+			}
+
+		CB_COMPARE(NULL, node, curr, compare, cbdata, cmp);
+		if (cmp == EAVL_CMP_SAME)
+			{
+			return EAVL_OK;
+			}
+
+		nearest[cmp] = curr;
 		}
 
-	return result;
+	/*
+	** A removed node with two children was replaced by one of its
+	** in-order neighbours, taken from the far end of the subtree on
+	** the neighbour's other side.
+	*/
+	for (dir=DIR_LEFT; dir<=DIR_RIGHT; dir++)
+		{
+		if (!nearest[dir])
+			{
+			continue;
+			}
+
+		for (curr = GET_CHILD(nearest[dir], dir), depth = 0;
+				curr;
+				curr = GET_CHILD(curr, DIR_OTHER(dir))
+				)
+			{
+			if (depth++ == HEIGHT_MAX)
+				{
+				return EAVL_ERROR_TREE;
+				}
+
+			if ((result = PRIVATE(path_check)(curr, compare, &verify, cbdata)) != EAVL_OK)
+				{
+				return result;
+				}
+			}
+		}
+
+	return EAVL_OK;
 	}
 
 
-#endif	/* EAVLp_CHECKS_AVAILABLE & EAVL_CHECK_TREE */
+#endif	/* EAVLp_CHECKS_AVAILABLE & EAVL_CHECK_PATH */
 
 
 /* pTree_check.c */
@@ -0,0 +1,288 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_pTree.h"
+
+#define CHECKS_AVAILABLE	EAVLp_CHECKS_AVAILABLE
+
+#include "pTree.h"
+#include "pTree_internal.h"
+
+#include "checks_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** A thread publishes its request in its slot and then either waits for
+** the request to be done or, if it gets the lock, combines: it collects
+** every published request, sorts them by key so consecutive descents
+** share a path, and applies them with one context. Clearing pending,
+** with release ordering, hands the result back to the slot owner.
+*/
+#define COMBINE_INSERT		(0)
+#define COMBINE_REMOVE		(1)
+
+
+static void PRIVATE(combine)(
+		EAVLp_combiner_t*	combiner
+		)
+	{
+	EAVLp_cbCompare_t	compare = combiner->tree.cbset->compare;
+	EAVLp_context_t		context;
+	EAVLp_combiner_slot_t*	slot;
+	EAVLp_combiner_slot_t*	batch = NULL;
+	EAVLp_combiner_slot_t**	pos;
+	EAVLp_combiner_slot_t*	next;
+	EAVLp_node_t*		node;
+	int			result;
+
+	/* Batches hold at most one request per slot; insertion sort them */
+	for (slot = __atomic_load_n(&combiner->slots, __ATOMIC_ACQUIRE); slot; slot = slot->next)
+		{
+		if (!__atomic_load_n(&slot->pending, __ATOMIC_ACQUIRE))
+			{
+			continue;
+			}
+
+		for (pos = &batch; *pos; pos = &(*pos)->batch)
+			{
+			if ((*compare)(NULL, slot->node, (*pos)->node, combiner->cbdata) == EAVL_CMP_RIGHT)
+				{
+				break;
+				}
+			}
+
+		slot->batch = *pos;
+		*pos = slot;
+		}
+
+	if ((result = PUBLIC(Context_Init)(&context, combiner->cbdata)) == EAVL_OK)
+		{
+		result = PUBLIC(Context_Associate)(&context, &combiner->tree);
+		}
+
+	for (slot = batch; slot; slot = next)
+		{
+		next = slot->batch;
+		node = NULL;
+
+		if (result != EAVL_OK)
+			{
+			slot->result = result;
+			}
+		else if (slot->op == COMBINE_INSERT)
+			{
+			slot->result = PUBLIC(Insert)(&context, slot->node, &node);
+			}
+		else if ((slot->result = PUBLIC(Find)(&context, EAVL_FIND_EQ, NULL, NULL, slot->node, &node)) == EAVL_OK)
+			{
+			slot->result = PUBLIC(Remove)(&context, &node);
+			}
+
+		slot->resultnode = node;
+		__atomic_store_n(&slot->pending, 0, __ATOMIC_RELEASE);
+		}
+
+	if (result == EAVL_OK)
+		{
+		(void) PUBLIC(Context_Disassociate)(&context);
+		}
+	}
+
+
+static int PRIVATE(combiner_request)(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot,
+		unsigned int		op,
+		EAVLp_node_t*		node,
+		EAVLp_node_t**		resultp
+		)
+	{
+	slot->op = op;
+	slot->node = node;
+	__atomic_store_n(&slot->pending, 1, __ATOMIC_RELEASE);
+
+	while (__atomic_load_n(&slot->pending, __ATOMIC_ACQUIRE))
+		{
+		if (!__atomic_load_n(&combiner->lock, __ATOMIC_RELAXED)
+				&& SPIN_TRYLOCK(&combiner->lock)
+				)
+			{
+			PRIVATE(combine)(combiner);
+			SPIN_UNLOCK(&combiner->lock);
+			}
+		}
+
+	if (slot->result == EAVL_OK || slot->result == EAVL_EXISTS)
+		{
+		*resultp = slot->resultnode;
+		}
+
+	return slot->result;
+	}
+
+
+int PUBLIC(Combiner_Init)(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_cbset_t*		cbset,
+		void*			cbdata
+		)
+	{
+	CHECK_PARAM_NON_NULL(combiner);
+
+	combiner->cbdata = cbdata;
+	combiner->slots = NULL;
+	combiner->lock = 0;
+
+	return PUBLIC(Tree_Init)(&combiner->tree, NULL, cbset);
+	}
+
+
+int PUBLIC(Combiner_Register)(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot
+		)
+	{
+	CHECK_PARAM_NON_NULL(combiner);
+	CHECK_PARAM_NON_NULL(slot);
+
+	slot->pending = 0;
+	slot->batch = NULL;
+	slot->next = __atomic_load_n(&combiner->slots, __ATOMIC_ACQUIRE);
+	while (!__atomic_compare_exchange_n(
+			&combiner->slots,
+			&slot->next,
+			slot,
+			1,
+			__ATOMIC_RELEASE,
+			__ATOMIC_ACQUIRE
+			))
+		{
+		/* slot->next was reloaded */
+		}
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Combiner_Unregister)(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot
+		)
+	{
+	EAVLp_combiner_slot_t*	expected = slot;
+	EAVLp_combiner_slot_t*	curr;
+	int			result = EAVL_NOTFOUND;
+
+	CHECK_PARAM_NON_NULL(combiner);
+	CHECK_PARAM_NON_NULL(slot);
+
+	/* Combiners walk the slots with the lock held */
+	SPIN_LOCK(&combiner->lock);
+
+	/* Only the head may be changed by concurrent registrations */
+	if (__atomic_compare_exchange_n(
+			&combiner->slots,
+			&expected,
+			slot->next,
+			0,
+			__ATOMIC_ACQ_REL,
+			__ATOMIC_ACQUIRE
+			))
+		{
+		result = EAVL_OK;
+		}
+	else
+		{
+		for (curr = expected; curr; curr = curr->next)
+			{
+			if (curr->next == slot)
+				{
+				curr->next = slot->next;
+				result = EAVL_OK;
+				break;
+				}
+			}
+		}
+
+	SPIN_UNLOCK(&combiner->lock);
+
+	return result;
+	}
+
+
+int PUBLIC(Combiner_Insert)(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot,
+		EAVLp_node_t*		node,
+		EAVLp_node_t**		resultp
+		)
+	{
+	CHECK_PARAM_NON_NULL(combiner);
+	CHECK_PARAM_NON_NULL(slot);
+	CHECK_PARAM_NON_NULL(node);
+	CHECK_PARAM_NON_NULL(resultp);
+
+	return PRIVATE(combiner_request)(combiner, slot, COMBINE_INSERT, node, resultp);
+	}
+
+
+int PUBLIC(Combiner_Remove)(
+		EAVLp_combiner_t*	combiner,
+		EAVLp_combiner_slot_t*	slot,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		nodep
+		)
+	{
+	CHECK_PARAM_NON_NULL(combiner);
+	CHECK_PARAM_NON_NULL(slot);
+	CHECK_PARAM_NON_NULL(ref_node);
+	CHECK_PARAM_NON_NULL(nodep);
+
+	return PRIVATE(combiner_request)(combiner, slot, COMBINE_REMOVE, ref_node, nodep);
+	}
+
+
+/* pTree_combine.c */
@@ -76,5 +76,11 @@ int FOREIGN(p_, remove)(
 		EAVLp_node_t**		nodep
 		);
 
+int FOREIGN(p_, fixup_dirty)(
+		EAVLp_node_t*		node,
+		EAVLp_cbFixup_t		fixup,
+		void*			cbdata
+		);
+
 
 #endif	/* _PTREE_INTERNAL_H */
@@ -0,0 +1,273 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_pTree.h"
+
+#define CHECKS_AVAILABLE	EAVLp_CHECKS_AVAILABLE
+
+#include "pTree.h"
+#include "pTree_internal.h"
+
+#include "callback_internal.h"
+#include "checks_internal.h"
+#include "context_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** Intervals are ordered by start, then end, then address, and keep the
+** greatest end in their subtree. A subtree whose greatest end is before a
+** query holds no overlap, and nothing right of a node that starts after the
+** query can overlap it.
+*/
+
+
+#define INTERVAL(NODE)		EAVLp_INTERVAL((NODE))
+
+#define MAX_END(NODE, END)						\
+	(((NODE) && INTERVAL((NODE))->max_end > (END))			\
+		? INTERVAL((NODE))->max_end				\
+		: (END)							\
+		)
+
+
+int PUBLIC(Interval_Init)(
+		EAVLp_interval_t*	interval,
+		EAVL_aug_value_t	start,
+		EAVL_aug_value_t	end
+		)
+	{
+	CHECK_PARAM_NON_NULL(interval);
+
+	interval->start = start;
+	interval->end = end;
+	interval->max_end = end;
+
+	return EAVL_OK;
+	}
+
+
+EAVL_dir_t PUBLIC(Interval_Compare)(
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t*		node,
+		void*			cbdata
+		)
+	{
+	EAVLp_interval_t*	ref = (EAVLp_interval_t*)ref_value;
+	EAVLp_interval_t*	curr = INTERVAL(node);
+
+	QUIET_UNUSED(cbdata);
+
+	if (ref_node)
+		{
+		ref = INTERVAL(ref_node);
+		}
+
+	if (curr->start != ref->start)
+		{
+		return (curr->start < ref->start) ? EAVL_CMP_LEFT : EAVL_CMP_RIGHT;
+		}
+
+	if (curr->end != ref->end)
+		{
+		return (curr->end < ref->end) ? EAVL_CMP_LEFT : EAVL_CMP_RIGHT;
+		}
+
+	if (!ref_node || curr == ref)
+		{
+		return EAVL_CMP_SAME;
+		}
+
+	return ((uintptr_t)curr < (uintptr_t)ref) ? EAVL_CMP_LEFT : EAVL_CMP_RIGHT;
+	}
+
+
+int PUBLIC(Interval_Fixup)(
+		EAVLp_node_t*		node,
+		EAVLp_node_t*		childL,
+		EAVLp_node_t*		childR,
+		void*			cbdata
+		)
+	{
+	EAVLp_interval_t*	interval = INTERVAL(node);
+	EAVL_aug_value_t	max_end;
+
+	QUIET_UNUSED(cbdata);
+
+	max_end = MAX_END(childR, MAX_END(childL, interval->end));
+
+	if (interval->max_end == max_end)
+		{
+		return EAVL_CB_FINISHED;
+		}
+
+	interval->max_end = max_end;
+
+	return EAVL_CB_OK;
+	}
+
+
+int PUBLIC(Interval_Verify)(
+		EAVLp_node_t*		node,
+		EAVLp_node_t*		childL,
+		EAVLp_node_t*		childR,
+		void*			cbdata
+		)
+	{
+	EAVLp_interval_t*	interval = INTERVAL(node);
+
+	QUIET_UNUSED(cbdata);
+
+	if (interval->max_end != MAX_END(childR, MAX_END(childL, interval->end)))
+		{
+		return EAVL_CB_ERROR;
+		}
+
+	return EAVL_CB_OK;
+	}
+
+
+/*
+** Visits the overlapping intervals of the subtree in order. Only left
+** subtrees are recursed into, so the recursion is no deeper than the tree.
+*/
+static int PRIVATE(interval_overlap)(
+		EAVLp_node_t*		node,
+		EAVL_aug_value_t	lo,
+		EAVL_aug_value_t	hi,
+		EAVLp_cbVisit_t		cbvisit,
+		void*			cbdata
+		)
+	{
+	int			result;
+
+	while (node && INTERVAL(node)->max_end >= lo)
+		{
+		result = PRIVATE(interval_overlap)(
+				GET_CHILD(node, DIR_LEFT),
+				lo,
+				hi,
+				cbvisit,
+				cbdata
+				);
+		if (result != EAVL_CB_OK)
+			{
+			return result;
+			}
+
+		if (INTERVAL(node)->start > hi)
+			{
+			break;
+			}
+
+		if (INTERVAL(node)->end >= lo
+				&& (result = (*cbvisit)(node, cbdata)) != EAVL_CB_OK
+				)
+			{
+			return result;
+			}
+
+		node = GET_CHILD(node, DIR_RIGHT);
+		}
+
+	return EAVL_CB_OK;
+	}
+
+
+int PUBLIC(Interval_Overlap)(
+		EAVLp_context_t*	context,
+		EAVL_aug_value_t	lo,
+		EAVL_aug_value_t	hi,
+		EAVLp_cbVisit_t		cbvisit
+		)
+	{
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(cbvisit);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	/* The greatest ends are only current once the deferred fixups are done */
+	result = PRIVATE(fixup_dirty)(
+			context->tree->root,
+			context->tree->cbset->fixup,
+			context->common.cbdata
+			);
+	if (result != EAVL_OK)
+		{
+		RESULT(result);
+		}
+
+	switch (PRIVATE(interval_overlap)(
+			context->tree->root,
+			lo,
+			hi,
+			cbvisit,
+			context->common.cbdata
+			))
+		{
+		case EAVL_CB_OK:
+		case EAVL_CB_FINISHED:
+			result = EAVL_OK;
+			break;
+
+		case EAVL_CB_CALLBACK:
+			result = EAVL_CALLBACK;
+			break;
+
+		default:
+			result = EAVL_ERROR_CALLBACK;
+			break;
+		}
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+/* pTree_interval.c */
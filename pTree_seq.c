@@ -0,0 +1,155 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_pTree.h"
+
+#define CHECKS_AVAILABLE	EAVLp_CHECKS_AVAILABLE
+
+#include "pTree.h"
+#include "pTree_internal.h"
+
+#include "checks_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** The sequence is odd while a writer is modifying the tree. A reader
+** that saw the same even sequence before and after its search saw no
+** modification. Searches of a changing tree are bounded by find's depth
+** limit, so a torn path can only cost a retry.
+*/
+
+
+int PUBLIC(Seq_Init)(
+		EAVLp_seq_t*		seq,
+		EAVLp_cbset_t*		cbset
+		)
+	{
+	CHECK_PARAM_NON_NULL(seq);
+
+	seq->sequence = 0;
+
+	return PUBLIC(Tree_Init)(&seq->tree, NULL, cbset);
+	}
+
+
+int PUBLIC(Seq_Write_Begin)(
+		EAVLp_seq_t*		seq
+		)
+	{
+	CHECK_PARAM_NON_NULL(seq);
+
+	__atomic_store_n(&seq->sequence, seq->sequence+1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Seq_Write_End)(
+		EAVLp_seq_t*		seq
+		)
+	{
+	CHECK_PARAM_NON_NULL(seq);
+
+	__atomic_store_n(&seq->sequence, seq->sequence+1, __ATOMIC_RELEASE);
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Seq_Find)(
+		EAVLp_seq_t*		seq,
+		EAVL_rel_t		rel,
+		EAVLp_cbCompare_t	compare,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		resultp
+		)
+	{
+	EAVLp_node_t*		node = NULL;
+	uintptr_t		sequence;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(seq);
+	CHECK_PARAM_NON_NULL(resultp);
+	CHECK_PARAM_REL(rel);
+
+	if (!compare)
+		{
+		compare = seq->tree.cbset->compare;
+		}
+
+	do
+		{
+		while ((sequence = __atomic_load_n(&seq->sequence, __ATOMIC_ACQUIRE)) & 0x1)
+			{
+			/* Writer active */
+			}
+
+		result = PRIVATE(find)(
+				__atomic_load_n(&seq->tree.root, __ATOMIC_RELAXED),
+				rel,
+				compare,
+				cbdata,
+				ref_value,
+				ref_node,
+				&node
+				);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		} while (sequence != __atomic_load_n(&seq->sequence, __ATOMIC_RELAXED));
+
+	if (result == EAVL_OK)
+		{
+		*resultp = node;
+		}
+
+	return result;
+	}
+
+
+/* pTree_seq.c */
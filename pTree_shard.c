@@ -0,0 +1,579 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_pTree.h"
+
+#define CHECKS_AVAILABLE	EAVLp_CHECKS_AVAILABLE
+
+#include "pTree.h"
+#include "pTree_internal.h"
+
+#include "callback_internal.h"
+#include "checks_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** Shard i holds the nodes not less than its bound and less than the
+** bound of shard i+1. A bound only changes with the locks of both
+** shards it separates held, so a route that is still valid once the
+** shard lock is taken stays valid until the lock is released.
+**
+** Locks are taken in ascending shard order; a descending step may only
+** try the lock and must start over if it is busy.
+*/
+
+
+#define SHARD_TRYLOCK(SHARD)		SPIN_TRYLOCK(&(SHARD)->lock)
+#define SHARD_LOCK(SHARD)		SPIN_LOCK(&(SHARD)->lock)
+#define SHARD_UNLOCK(SHARD)		SPIN_UNLOCK(&(SHARD)->lock)
+
+#define SHARD_BOUND(SHARD)						\
+	__atomic_load_n(&(SHARD)->bound, __ATOMIC_RELAXED)
+
+
+static int PRIVATE(shards_route)(
+		EAVLp_shards_t*		shards,
+		EAVLp_cbCompare_t	compare,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		unsigned int*		indexp
+		)
+	{
+	unsigned int		low = 0;
+	unsigned int		high = shards->count;
+	unsigned int		mid;
+	EAVL_dir_t		cmp;
+
+	while (high - low > 1)
+		{
+		mid = low + (high - low) / 2;
+
+		CB_COMPARE(ref_value, ref_node, SHARD_BOUND(&shards->shard[mid]), compare, cbdata, cmp);
+		if (cmp == EAVL_CMP_RIGHT)
+			{
+			high = mid;
+			}
+		else
+			{
+			low = mid;
+			}
+		}
+
+	*indexp = low;
+
+	return EAVL_OK;
+	}
+
+
+static int PRIVATE(shards_lock)(
+		EAVLp_shards_t*		shards,
+		EAVLp_cbCompare_t	compare,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		unsigned int*		indexp
+		)
+	{
+	unsigned int		index;
+	unsigned int		check;
+	int			result;
+
+	if ((result = PRIVATE(shards_route)(shards, compare, cbdata, ref_value, ref_node, &index)) != EAVL_OK)
+		{
+		return result;
+		}
+
+	for (;;)
+		{
+		SHARD_LOCK(&shards->shard[index]);
+
+		if ((result = PRIVATE(shards_route)(shards, compare, cbdata, ref_value, ref_node, &check)) != EAVL_OK)
+			{
+			SHARD_UNLOCK(&shards->shard[index]);
+			return result;
+			}
+
+		if (check == index)
+			{
+			*indexp = index;
+			return EAVL_OK;
+			}
+
+		/* A bound moved before the lock was taken */
+		SHARD_UNLOCK(&shards->shard[index]);
+		index = check;
+		}
+	}
+
+
+static int PRIVATE(shard_open)(
+		EAVLp_shard_t*		shard,
+		EAVLp_context_t*	context,
+		void*			cbdata
+		)
+	{
+	int			result;
+
+	if ((result = PUBLIC(Context_Init)(context, cbdata)) != EAVL_OK)
+		{
+		return result;
+		}
+
+	return PUBLIC(Context_Associate)(context, &shard->tree);
+	}
+
+
+static int PRIVATE(shards_compare)(
+		EAVLp_shards_t*		shards,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t*		node,
+		void*			cbdata,
+		EAVL_dir_t*		cmpp
+		)
+	{
+	EAVL_dir_t		cmp;
+
+	CB_COMPARE(NULL, ref_node, node, shards->shard[0].tree.cbset->compare, cbdata, cmp);
+	*cmpp = cmp;
+
+	return EAVL_OK;
+	}
+
+
+static int PRIVATE(shards_between)(
+		EAVLp_shards_t*		shards,
+		unsigned int		index,
+		EAVLp_node_t*		bound,
+		void*			cbdata
+		)
+	{
+	EAVL_dir_t		cmp;
+	int			result;
+
+	if (index > 1)
+		{
+		if ((result = PRIVATE(shards_compare)(shards, bound, shards->shard[index-1].bound, cbdata, &cmp)) != EAVL_OK)
+			{
+			return result;
+			}
+		if (cmp != EAVL_CMP_LEFT)
+			{
+			return EAVL_ERROR_PARAMETER;
+			}
+		}
+
+	if (index+1 < shards->count)
+		{
+		if ((result = PRIVATE(shards_compare)(shards, bound, shards->shard[index+1].bound, cbdata, &cmp)) != EAVL_OK)
+			{
+			return result;
+			}
+		if (cmp != EAVL_CMP_RIGHT)
+			{
+			return EAVL_ERROR_PARAMETER;
+			}
+		}
+
+	return EAVL_OK;
+	}
+
+
+static int PRIVATE(shard_move)(
+		EAVLp_shard_t*		from,
+		EAVLp_shard_t*		to,
+		EAVL_rel_t		rel,
+		EAVLp_node_t*		bound,
+		void*			cbdata
+		)
+	{
+	EAVLp_context_t		fcontext;
+	EAVLp_context_t		tcontext;
+	EAVLp_node_t*		node;
+	EAVLp_node_t*		dummy;
+	int			result;
+
+	if ((result = PRIVATE(shard_open)(from, &fcontext, cbdata)) != EAVL_OK)
+		{
+		return result;
+		}
+
+	if ((result = PRIVATE(shard_open)(to, &tcontext, cbdata)) != EAVL_OK)
+		{
+		(void) PUBLIC(Context_Disassociate)(&fcontext);
+		return result;
+		}
+
+	while ((result = PUBLIC(Find)(&fcontext, rel, NULL, NULL, bound, &node)) == EAVL_OK)
+		{
+		if ((result = PUBLIC(Remove)(&fcontext, &node)) != EAVL_OK)
+			{
+			break;
+			}
+
+		if ((result = PUBLIC(Insert)(&tcontext, node, &dummy)) != EAVL_OK)
+			{
+			/* Put it back; the shards are as they were for this node */
+			(void) PUBLIC(Insert)(&fcontext, node, &dummy);
+			break;
+			}
+
+		from->count--;
+		to->count++;
+		}
+
+	if (result == EAVL_NOTFOUND)
+		{
+		result = EAVL_OK;
+		}
+
+	(void) PUBLIC(Context_Disassociate)(&tcontext);
+	(void) PUBLIC(Context_Disassociate)(&fcontext);
+
+	return result;
+	}
+
+
+int PUBLIC(Shards_Init)(
+		EAVLp_shards_t*		shards,
+		unsigned int		count,
+		EAVLp_shard_t		shard[],
+		EAVLp_node_t*		bounds[],
+		EAVLp_cbset_t*		cbset
+		)
+	{
+	unsigned int		i;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(shards);
+	CHECK_PARAM_NON_NULL(shard);
+	CHECK_PARAM_NON_NULL(cbset);
+	CHECK_PARAM_NON_NULL(cbset->compare);
+
+	if (!count || (count > 1 && !bounds))
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if ((result = PUBLIC(Tree_Init)(&shard[i].tree, NULL, cbset)) != EAVL_OK)
+			{
+			return result;
+			}
+
+		shard[i].bound = NULL;
+		shard[i].count = 0;
+		shard[i].lock = 0;
+
+		if (i)
+			{
+			if (!bounds[i-1])
+				{
+				return EAVL_ERROR_PARAMETER;
+				}
+
+			shard[i].bound = bounds[i-1];
+			}
+		}
+
+	shards->shard = shard;
+	shards->count = count;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Shards_Insert)(
+		EAVLp_shards_t*		shards,
+		void*			cbdata,
+		EAVLp_node_t*		node,
+		EAVLp_node_t**		resultp
+		)
+	{
+	EAVLp_context_t		context;
+	EAVLp_shard_t*		shard;
+	unsigned int		index;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(shards);
+	CHECK_PARAM_NON_NULL(node);
+	CHECK_PARAM_NON_NULL(resultp);
+
+	if ((result = PRIVATE(shards_lock)(
+			shards,
+			shards->shard[0].tree.cbset->compare,
+			cbdata,
+			NULL,
+			node,
+			&index
+			)) != EAVL_OK)
+		{
+		return result;
+		}
+
+	shard = &shards->shard[index];
+
+	if ((result = PRIVATE(shard_open)(shard, &context, cbdata)) == EAVL_OK)
+		{
+		if ((result = PUBLIC(Insert)(&context, node, resultp)) == EAVL_OK)
+			{
+			shard->count++;
+			}
+
+		(void) PUBLIC(Context_Disassociate)(&context);
+		}
+
+	SHARD_UNLOCK(shard);
+
+	return result;
+	}
+
+
+int PUBLIC(Shards_Remove)(
+		EAVLp_shards_t*		shards,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		nodep
+		)
+	{
+	EAVLp_context_t		context;
+	EAVLp_shard_t*		shard;
+	EAVLp_node_t*		node;
+	unsigned int		index;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(shards);
+
+	if ((result = PRIVATE(shards_lock)(
+			shards,
+			shards->shard[0].tree.cbset->compare,
+			cbdata,
+			ref_value,
+			ref_node,
+			&index
+			)) != EAVL_OK)
+		{
+		return result;
+		}
+
+	shard = &shards->shard[index];
+
+	if ((result = PRIVATE(shard_open)(shard, &context, cbdata)) == EAVL_OK)
+		{
+		if ((result = PUBLIC(Find)(&context, EAVL_FIND_EQ, NULL, ref_value, ref_node, &node)) == EAVL_OK
+				&& (result = PUBLIC(Remove)(&context, nodep)) == EAVL_OK
+				)
+			{
+			shard->count--;
+			}
+
+		(void) PUBLIC(Context_Disassociate)(&context);
+		}
+
+	SHARD_UNLOCK(shard);
+
+	return result;
+	}
+
+
+int PUBLIC(Shards_Find)(
+		EAVLp_shards_t*		shards,
+		EAVL_rel_t		rel,
+		EAVLp_cbCompare_t	compare,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t**		resultp
+		)
+	{
+	EAVLp_context_t		context;
+	EAVLp_node_t*		node = NULL;
+	unsigned int		index;
+	unsigned int		next;
+	int			retry;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(shards);
+	CHECK_PARAM_NON_NULL(resultp);
+	CHECK_PARAM_REL(rel);
+
+	if (!compare)
+		{
+		compare = shards->shard[0].tree.cbset->compare;
+		}
+
+	do
+		{
+		retry = 0;
+
+		if ((result = PRIVATE(shards_lock)(shards, compare, cbdata, ref_value, ref_node, &index)) != EAVL_OK)
+			{
+			return result;
+			}
+
+		if ((result = PRIVATE(shard_open)(&shards->shard[index], &context, cbdata)) == EAVL_OK)
+			{
+			result = PUBLIC(Find)(&context, rel, compare, ref_value, ref_node, &node);
+			(void) PUBLIC(Context_Disassociate)(&context);
+			}
+
+		/* Nearest node is in a neighbouring shard, if any */
+		while (result == EAVL_NOTFOUND && rel != EAVL_FIND_EQ)
+			{
+			if (rel > EAVL_FIND_EQ)
+				{
+				if (index+1 == shards->count)
+					{
+					break;
+					}
+
+				next = index+1;
+				SHARD_LOCK(&shards->shard[next]);
+				}
+			else
+				{
+				if (!index)
+					{
+					break;
+					}
+
+				next = index-1;
+				if (!SHARD_TRYLOCK(&shards->shard[next]))
+					{
+					/* Out of lock order; start over */
+					retry = 1;
+					break;
+					}
+				}
+
+			SHARD_UNLOCK(&shards->shard[index]);
+			index = next;
+
+			if ((result = PRIVATE(shard_open)(&shards->shard[index], &context, cbdata)) == EAVL_OK)
+				{
+				result = PUBLIC(First)(
+						&context,
+						(rel > EAVL_FIND_EQ) ? EAVL_DIR_RIGHT : EAVL_DIR_LEFT,
+						EAVL_ORDER_IN,
+						&node
+						);
+				(void) PUBLIC(Context_Disassociate)(&context);
+				}
+			}
+
+		SHARD_UNLOCK(&shards->shard[index]);
+		} while (retry);
+
+	if (result == EAVL_OK)
+		{
+		*resultp = node;
+		}
+
+	return result;
+	}
+
+
+int PUBLIC(Shards_Rebalance)(
+		EAVLp_shards_t*		shards,
+		void*			cbdata,
+		unsigned int		index,
+		EAVLp_node_t*		bound,
+		EAVLp_node_t**		oldp
+		)
+	{
+	EAVLp_shard_t*		left;
+	EAVLp_shard_t*		right;
+	EAVL_dir_t		cmp;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(shards);
+	CHECK_PARAM_NON_NULL(bound);
+	CHECK_PARAM_NON_NULL(oldp);
+
+	if (!index || index >= shards->count)
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	left = &shards->shard[index-1];
+	right = &shards->shard[index];
+
+	SHARD_LOCK(left);
+	SHARD_LOCK(right);
+
+	/* The new bound must stay between the neighbouring bounds */
+	if ((result = PRIVATE(shards_between)(shards, index, bound, cbdata)) == EAVL_OK
+			&& (result = PRIVATE(shards_compare)(shards, bound, right->bound, cbdata, &cmp)) == EAVL_OK
+			)
+		{
+		if (cmp == EAVL_CMP_RIGHT)
+			{
+			/* Bound moves left; the top of the left shard moves right */
+			result = PRIVATE(shard_move)(left, right, EAVL_FIND_GE, bound, cbdata);
+			}
+		else if (cmp == EAVL_CMP_LEFT)
+			{
+			/* Bound moves right; the bottom of the right shard moves left */
+			result = PRIVATE(shard_move)(right, left, EAVL_FIND_LT, bound, cbdata);
+			}
+
+		if (result == EAVL_OK)
+			{
+			*oldp = right->bound;
+			__atomic_store_n(&right->bound, bound, __ATOMIC_RELAXED);
+			}
+		}
+
+	SHARD_UNLOCK(right);
+	SHARD_UNLOCK(left);
+
+	return result;
+	}
+
+
+/* pTree_shard.c */
@@ -48,12 +48,53 @@
 #include "naming_internal.h"
 
 
+/*
+** The path macros index "pathv", which every user of them declares, when
+** the context's cbPathe callback has handed out a vector for the current
+** operation; otherwise they call the callback for each element.
+*/
+#define PATHE_VECTOR(CONTEXT, VAR)					\
+	do								\
+		{							\
+		(VAR) = NULL;						\
+		if ((CONTEXT)->vectored)				\
+			{						\
+			CB_PATHE_VECTOR(				\
+					EAVL_PATHE_VECTOR_SIZE,		\
+					(CONTEXT)->cbpathe,		\
+					(CONTEXT)->common.cbdata,	\
+					(VAR)				\
+					);				\
+			}						\
+		} while (0)
+
+
+#define PATHE_ADDR(INDEX, CB, CBDATA, ERROR, VAR)			\
+	do								\
+		{							\
+		if (pathv)						\
+			{						\
+			unsigned int	PE_index = (INDEX);		\
+									\
+			if (PE_index >= EAVL_PATHE_VECTOR_SIZE)		\
+				{					\
+				return (ERROR);				\
+				}					\
+			(VAR) = &pathv[PE_index];			\
+			}						\
+		else							\
+			{						\
+			CB_PATHE_ADDR((INDEX), (CB), (CBDATA), (ERROR), (VAR));	\
+			}						\
+		} while (0)
+
+
 #define PATHE_GET_SAFE(INDEX, CB, CBDATA, VAR)				\
 	do								\
 		{							\
 		PUBLIC(pathelement_t)*		TPE;			\
 									\
-		CB_PATHE_ADDR((INDEX), (CB), (CBDATA), EAVL_CALLBACK, TPE);	\
+		PATHE_ADDR((INDEX), (CB), (CBDATA), EAVL_CALLBACK, TPE);	\
 		(VAR) = *TPE;						\
 		} while (0)
 
@@ -63,7 +104,7 @@
 		{							\
 		PUBLIC(pathelement_t)*		TPE;			\
 									\
-		CB_PATHE_ADDR((INDEX), (CB), (CBDATA), EAVL_CALLBACK, TPE);	\
+		PATHE_ADDR((INDEX), (CB), (CBDATA), EAVL_CALLBACK, TPE);	\
 		*TPE = (VAL);						\
 		} while (0)
 
@@ -73,7 +114,7 @@
 		{							\
 		PUBLIC(pathelement_t)*		TPE;			\
 									\
-		CB_PATHE_ADDR((INDEX), (CB), (CBDATA), EAVL_ERROR_CALLBACK, TPE);	\
+		PATHE_ADDR((INDEX), (CB), (CBDATA), EAVL_ERROR_CALLBACK, TPE);	\
 		(VAR) = *TPE;						\
 		} while (0)
 
@@ -83,7 +124,7 @@
 		{							\
 		PUBLIC(pathelement_t)*		TPE;			\
 									\
-		CB_PATHE_ADDR((INDEX), (CB), (CBDATA), EAVL_ERROR_CALLBACK, TPE);	\
+		PATHE_ADDR((INDEX), (CB), (CBDATA), EAVL_ERROR_CALLBACK, TPE);	\
 		*TPE = (VAL);						\
 		} while (0)
 
@@ -117,7 +158,22 @@
 
 
 #define PATHE_SHIFT(INDEX, PARAM, CB, CBDATA)				\
-	CB_PATHE_NULL((INDEX), (PARAM), (CB), (CBDATA))
+	do								\
+		{							\
+		if (pathv)						\
+			{						\
+			unsigned int	PE_i;				\
+									\
+			for (PE_i=(INDEX); PE_i<=(PARAM); PE_i++)	\
+				{					\
+				pathv[PE_i-1] = pathv[PE_i];		\
+				}					\
+			}						\
+		else							\
+			{						\
+			CB_PATHE_NULL((INDEX), (PARAM), (CB), (CBDATA));	\
+			}						\
+		} while (0)
 
 
 #define PATHE_TRUNCATE(SIZE, CB, CBDATA)				\
@@ -0,0 +1,212 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_rTree.h"
+
+#define CHECKS_AVAILABLE	EAVLr_CHECKS_AVAILABLE
+
+#include "rTree.h"
+#include "rTree_internal.h"
+
+#include "callback_internal.h"
+#include "checks_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** A cursor is a position in a tree that is not registered with the tree.
+** Writers never reset cursors; a cursor is invalid after any change to
+** its tree and must be set again by Cursor_First or Cursor_Find.
+*/
+
+
+int PUBLIC(Cursor_Init)(
+		EAVLr_cursor_t*		cursor,
+		EAVLr_tree_t*		tree,
+		void*			cbdata
+		)
+	{
+	CHECK_PARAM_NON_NULL(cursor);
+	CHECK_PARAM_NON_NULL(tree);
+
+	cursor->tree = tree;
+	cursor->recent = NULL;
+	cursor->cbdata = cbdata;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Cursor_Find)(
+		EAVLr_cursor_t*		cursor,
+		EAVL_rel_t		rel,
+		EAVLr_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLr_node_t*		ref_node,
+		EAVLr_node_t**		resultp
+		)
+	{
+	EAVLr_node_t*		node;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(cursor);
+	CHECK_PARAM_NON_NULL(resultp);
+	CHECK_PARAM_REL(rel);
+
+	cursor->recent = NULL;
+
+	if (!compare)
+		{
+		compare = cursor->tree->cbset->compare;
+		}
+
+	result = PRIVATE(find)(
+			GET_ROOT(cursor->tree->root),
+			rel,
+			compare,
+			cursor->cbdata,
+			ref_value,
+			ref_node,
+			&node
+			);
+
+	if (result == EAVL_OK)
+		{
+		cursor->recent = node;
+		*resultp = node;
+		}
+
+	return result;
+	}
+
+
+int PUBLIC(Cursor_First)(
+		EAVLr_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLr_node_t**		resultp
+		)
+	{
+	EAVLr_node_t*		curr;
+	EAVLr_node_t*		next;
+
+	CHECK_PARAM_NON_NULL(cursor);
+	CHECK_PARAM_NON_NULL(resultp);
+	CHECK_PARAM_DIR(dir);
+
+	curr = GET_ROOT(cursor->tree->root);
+	if (!curr)
+		{
+		cursor->recent = NULL;
+		return EAVL_NOTFOUND;
+		}
+
+	/* find extreme node in direction opposit of motion */
+	dir = DIR_OTHER(dir);
+	while ((next = GET_CHILD(curr, dir)))
+		{
+		curr = next;
+		}
+
+	cursor->recent = curr;
+	*resultp = curr;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Cursor_Next)(
+		EAVLr_cursor_t*		cursor,
+		EAVL_dir_t		dir,
+		EAVLr_node_t**		resultp
+		)
+	{
+	EAVLr_node_t*		curr;
+	EAVLr_node_t*		prev;
+	EAVL_dir_t		other = DIR_OTHER(dir);
+
+	CHECK_PARAM_NON_NULL(cursor);
+	CHECK_PARAM_NON_NULL(resultp);
+	CHECK_PARAM_DIR(dir);
+
+	curr = cursor->recent;
+	if (!curr)
+		{
+		return EAVL_ERROR_CONTEXT;
+		}
+
+	/* try to move DIR */
+	prev = GET_CHILD(curr, dir);
+	if (prev)
+		{
+		/* find OTHER-most node */
+		curr = prev;
+		while ((prev = GET_CHILD(curr, other)))
+			{
+			curr = prev;
+			}
+		}
+	else
+		{
+		do
+			{
+			/* move UP */
+			prev = curr;
+			curr = GET_PARENT(curr);
+			} while (curr && prev != GET_CHILD(curr, other));
+		}
+
+	cursor->recent = curr;
+	if (!curr)
+		{
+		return EAVL_NOTFOUND;
+		}
+
+	*resultp = curr;
+
+	return EAVL_OK;
+	}
+
+
+/* rTree_cursor.c */
@@ -0,0 +1,500 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+#include <string.h>
+
+#include "EAVL_rTree.h"
+
+#define CHECKS_AVAILABLE	EAVLr_CHECKS_AVAILABLE
+
+#include "rTree_internal.h"
+
+#include "checks_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+/*
+** Image layout:
+**
+**	+---------------------------+ 0
+**	| EAVLr_image_t             |
+**	|   mark[marks] (dirty)     |
+**	|   mark[marks] (stale)     |
+**	+---------------------------+ copy[0] (multiple of block)
+**	| EAVLr_image_copy_t        |
+**	|   blockcrc[blocks]        |
+**	+---------------------------+ copy[1] (multiple of block)
+**	| EAVLr_image_copy_t        |
+**	|   blockcrc[blocks]        |
+**	+---------------------------+ header (multiple of block)
+**	| data region: nodes        |
+**	|   block 0 .. blocks-1     |
+**	+---------------------------+ size
+**
+** The root links are relative to the address of the live root link; all
+** other links are node relative, so the image may be mapped at any address.
+**
+** Only the copies are checksummed. A sync writes the marked data blocks and
+** then the older copy, which becomes the newest; the live root link and the
+** bitmaps may reach the disk at any time without harm. A block is dirty if
+** it was written since the last sync and stale if its checksums in the two
+** copies may differ.
+*/
+
+
+#define IMAGE_COPY(IMAGE, INDEX)					\
+	((EAVLr_image_copy_t*)((char*)(IMAGE) + (IMAGE)->copy[(INDEX)]))
+
+#define COPY_SIZE(BLOCKS)						\
+	(offsetof(EAVLr_image_copy_t, blockcrc)				\
+		+ (uint64_t)(BLOCKS) * sizeof(uint32_t))
+
+
+/*
+** CRC-32 (IEEE 802.3, reflected), half-byte table.
+*/
+static uint32_t PRIVATE(crc32)(
+		const void*		data,
+		size_t			length,
+		uint32_t		previous
+		)
+	{
+	static const uint32_t	lut[16] =
+			{
+			0x00000000,0x1DB71064,0x3B6E20C8,0x26D930AC,
+			0x76DC4190,0x6B6B51F4,0x4DB26158,0x5005713C,
+			0xEDB88320,0xF00F9344,0xD6D6A3E8,0xCB61B38C,
+			0x9B64C2B0,0x86D3D2D4,0xA00AE278,0xBDBDF21C
+			};
+	const unsigned char*	current = (const unsigned char*)data;
+	uint32_t		crc = ~previous;
+
+	while (length--)
+		{
+		crc = lut[(crc ^  *current      ) & 0x0F] ^ (crc >> 4);
+		crc = lut[(crc ^ (*current >> 4)) & 0x0F] ^ (crc >> 4);
+		current++;
+		}
+
+	return ~crc;
+	}
+
+
+static uint32_t PRIVATE(copy_crc)(
+		EAVLr_image_t*		image,
+		EAVLr_image_copy_t*	copy
+		)
+	{
+	uint32_t		crc;
+
+	/* the fixed header and everything in the copy but its crc member */
+	crc = PRIVATE(crc32)(image, offsetof(EAVLr_image_t, current), 0);
+	crc = PRIVATE(crc32)(copy, offsetof(EAVLr_image_copy_t, crc), crc);
+	crc = PRIVATE(crc32)(
+			copy->blockcrc,
+			image->blocks * sizeof(copy->blockcrc[0]),
+			crc
+			);
+
+	return crc;
+	}
+
+
+static uint32_t PRIVATE(block_crc)(
+		EAVLr_image_t*		image,
+		uint32_t		index,
+		char**			addrp,
+		size_t*			lengthp
+		)
+	{
+	uint64_t		offset = image->header + (uint64_t)index * image->block;
+	uint64_t		length = image->size - offset;
+
+	if (length > image->block)
+		{
+		length = image->block;
+		}
+
+	*addrp = (char*)image + offset;
+	*lengthp = (size_t)length;
+
+	return PRIVATE(crc32)(*addrp, (size_t)length, 0);
+	}
+
+
+static void PRIVATE(mark)(
+		EAVLr_image_t*		image,
+		uintptr_t		addr,
+		uintptr_t		length
+		)
+	{
+	uintptr_t		base = (uintptr_t)image + (uintptr_t)image->header;
+	uintptr_t		end = (uintptr_t)image + (uintptr_t)image->size;
+	uintptr_t		i;
+	uintptr_t		last;
+
+	/* clip to the data region */
+	if (addr < base)
+		{
+		if (length <= base - addr)
+			{
+			return;
+			}
+		length -= base - addr;
+		addr = base;
+		}
+	if (!length || addr >= end)
+		{
+		return;
+		}
+	if (length > end - addr)
+		{
+		length = end - addr;
+		}
+
+	last = (addr - base + length - 1) / image->block;
+	for (i = (addr - base) / image->block; i <= last; i++)
+		{
+		image->mark[i >> 3] |= (unsigned char)(1u << (i & 0x7));
+		}
+	}
+
+
+void FOREIGN(r_, image_node)(
+		EAVLr_tree_t*		tree,
+		EAVLr_node_t*		node
+		)
+	{
+	PRIVATE(mark)(
+			tree->image,
+			(uintptr_t)node - (uintptr_t)tree->nodeoffset,
+			(uintptr_t)tree->nodesize
+			);
+	}
+
+
+int PUBLIC(Image_Init)(
+		EAVLr_image_t*		image,
+		size_t			size,
+		size_t			block
+		)
+	{
+	uint64_t		marks;
+	uint64_t		copysize;
+	uint64_t		header;
+	uint64_t		blocks;
+	EAVLr_image_copy_t*	copy;
+	uint32_t		i;
+	char*			addr;
+	size_t			length;
+
+	CHECK_PARAM_NON_NULL(image);
+	CHECK_NODE_ALIGN(image);
+
+	if (!block || block > UINT32_MAX || block % sizeof(uint64_t)
+			|| size <= sizeof(EAVLr_image_t)
+			)
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	/* size the bitmaps and checksum tables for the whole image; slightly generous */
+	blocks = ((uint64_t)size + block - 1) / block;
+	if (blocks > UINT32_MAX)
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+	marks = (blocks + 7) / 8;
+	header = offsetof(EAVLr_image_t, mark) + 2 * marks;
+	header = (header + block - 1) / block * block;
+	copysize = (COPY_SIZE(blocks) + block - 1) / block * block;
+	if (header + 2 * copysize >= size)
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	memset(image, 0, (size_t)(header + 2 * copysize));
+	memcpy(image->magic, EAVLr_IMAGE_MAGIC, sizeof(image->magic));
+	image->version = EAVLr_IMAGE_VERSION;
+	image->byteorder = EAVLr_IMAGE_BYTEORDER;
+	image->linksize = sizeof(EAVL_node_spec_t);
+	image->block = (uint32_t)block;
+	image->size = size;
+	image->marks = (uint32_t)marks;
+	image->copy[0] = header;
+	image->copy[1] = header + copysize;
+	image->header = header + 2 * copysize;
+	image->blocks = (uint32_t)((size - image->header + block - 1) / block);
+	EAVLr_ROOT_INIT(&image->root);
+
+	copy = IMAGE_COPY(image, 0);
+	for (i=0; i<image->blocks; i++)
+		{
+		copy->blockcrc[i] = PRIVATE(block_crc)(image, i, &addr, &length);
+		}
+	copy->crc = PRIVATE(copy_crc)(image, copy);
+
+	/* both copies describe the empty tree; copy 1 is the newer */
+	memcpy(IMAGE_COPY(image, 1), copy, (size_t)COPY_SIZE(image->blocks));
+	copy = IMAGE_COPY(image, 1);
+	copy->sequence = 1;
+	copy->crc = PRIVATE(copy_crc)(image, copy);
+	image->current = 1;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Image_Open)(
+		EAVLr_image_t*		image,
+		size_t			size,
+		int			verify
+		)
+	{
+	EAVLr_image_copy_t*	copy;
+	EAVLr_image_copy_t*	newest = NULL;
+	EAVL_node_spec_t	link;
+	uint64_t		copysize;
+	uint32_t		current = 0;
+	uint32_t		i;
+	char*			addr;
+	size_t			length;
+
+	CHECK_PARAM_NON_NULL(image);
+	CHECK_NODE_ALIGN(image);
+
+	if (size < sizeof(EAVLr_image_t)
+			|| memcmp(image->magic, EAVLr_IMAGE_MAGIC, sizeof(image->magic))
+			)
+		{
+		return EAVL_ERROR_TREE;
+		}
+
+	if (image->version != EAVLr_IMAGE_VERSION
+			|| image->byteorder != EAVLr_IMAGE_BYTEORDER
+			|| image->linksize != sizeof(EAVL_node_spec_t)
+			)
+		{
+		return EAVL_ERROR_BUILD;
+		}
+
+	copysize = COPY_SIZE(image->blocks);
+	if (image->size != size
+			|| !image->block
+			|| image->block % sizeof(uint64_t)
+			|| image->header >= image->size
+			|| image->blocks != (image->size - image->header + image->block - 1)
+				/ image->block
+			|| (uint64_t)image->marks * 8 < image->blocks
+			|| image->copy[0] % image->block
+			|| image->copy[1] % image->block
+			|| image->copy[0] < offsetof(EAVLr_image_t, mark) + 2 * (uint64_t)image->marks
+			|| image->copy[1] < image->copy[0] + copysize
+			|| image->header < image->copy[1] + copysize
+			)
+		{
+		return EAVL_ERROR_TREE;
+		}
+
+	/* the newest copy with a good checksum and a root node in the data region */
+	for (i=0; i<2; i++)
+		{
+		copy = IMAGE_COPY(image, i);
+		link = EAVL_ADDR(copy->root);
+		if (copy->crc != PRIVATE(copy_crc)(image, copy)
+				|| (link
+					&& (link < image->header - offsetof(EAVLr_image_t, root)
+						|| link >= image->size - offsetof(EAVLr_image_t, root)
+						)
+					)
+				)
+			{
+			continue;
+			}
+
+		if (!newest || copy->sequence > newest->sequence)
+			{
+			newest = copy;
+			current = i;
+			}
+		}
+
+	if (!newest)
+		{
+		return EAVL_ERROR_TREE;
+		}
+
+	if (verify)
+		{
+		for (i=0; i<image->blocks; i++)
+			{
+			if (newest->blockcrc[i] != PRIVATE(block_crc)(image, i, &addr, &length))
+				{
+				return EAVL_ERROR_TREE;
+				}
+			}
+		}
+
+	/* the other copy's checksums are unknown; refresh them all on the next sync */
+	image->current = current;
+	image->root.link = newest->root;
+	memset(image->mark + image->marks, 0xFF, image->marks);
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Image_Sync)(
+		EAVLr_image_t*		image,
+		EAVLr_cbSync_t		cbsync,
+		void*			cbdata
+		)
+	{
+	EAVLr_image_copy_t*	current;
+	EAVLr_image_copy_t*	next;
+	unsigned char*		dirty;
+	unsigned char*		stale;
+	unsigned int		bit;
+	uint32_t		i;
+	uint32_t		j;
+	char*			addr;
+	size_t			length;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(image);
+
+	current = IMAGE_COPY(image, image->current);
+	next = IMAGE_COPY(image, image->current ^ 1);
+	dirty = image->mark;
+	stale = image->mark + image->marks;
+
+	/* data blocks first so that a copy never describes unsynced data */
+	for (j=0; j<image->marks; j++)
+		{
+		if (!(dirty[j] | stale[j]))
+			{
+			continue;
+			}
+
+		for (i=j*8; i<j*8+8 && i<image->blocks; i++)
+			{
+			bit = 1u << (i & 0x7);
+			if (dirty[j] & bit)
+				{
+				next->blockcrc[i] = PRIVATE(block_crc)(image, i, &addr, &length);
+
+				if (cbsync && (result = (*cbsync)(addr, length, cbdata)) != EAVL_CB_OK)
+					{
+					return (result == EAVL_CB_CALLBACK) ? EAVL_CALLBACK : EAVL_ERROR_CALLBACK;
+					}
+				}
+			else if (stale[j] & bit)
+				{
+				next->blockcrc[i] = current->blockcrc[i];
+				}
+			}
+		}
+
+	/* the commit point */
+	next->sequence = current->sequence + 1;
+	next->root = image->root.link;
+	next->crc = PRIVATE(copy_crc)(image, next);
+
+	if (cbsync && (result = (*cbsync)(next, (size_t)COPY_SIZE(image->blocks), cbdata)) != EAVL_CB_OK)
+		{
+		return (result == EAVL_CB_CALLBACK) ? EAVL_CALLBACK : EAVL_ERROR_CALLBACK;
+		}
+
+	image->current ^= 1;
+	for (j=0; j<image->marks; j++)
+		{
+		stale[j] = dirty[j];
+		dirty[j] = 0;
+		}
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Image_Track)(
+		EAVLr_image_t*		image,
+		EAVLr_tree_t*		tree,
+		size_t			nodeoffset,
+		size_t			nodesize
+		)
+	{
+	CHECK_PARAM_NON_NULL(image);
+	CHECK_PARAM_NON_NULL(tree);
+
+	if (tree->root != &image->root
+			|| nodesize < sizeof(EAVLr_node_t)
+			|| nodeoffset > nodesize - sizeof(EAVLr_node_t)
+			)
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	tree->image = image;
+	tree->nodeoffset = nodeoffset;
+	tree->nodesize = nodesize;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Image_Dirty)(
+		EAVLr_image_t*		image,
+		void*			addr,
+		size_t			length
+		)
+	{
+	CHECK_PARAM_NON_NULL(image);
+
+	PRIVATE(mark)(image, (uintptr_t)addr, (uintptr_t)length);
+
+	return EAVL_OK;
+	}
+
+
+/* rTree_image.c */
@@ -55,6 +55,7 @@
 #include "eavl_internal.h"
 #include "naming_internal.h"
 #include "pathe_internal.h"
+#include "serialize_internal.h"
 #include "treeload_internal.h"
 
 
@@ -82,8 +83,9 @@ int PUBLIC(Tree_Init)(
 		}
 
 	tree->root = NULL;
-	tree->common.contexts = NULL;
+	CONTEXTS_INIT(tree);
 	tree->common.associations = 0;
+	tree->common.checks = EAVL_CHECK_ALL;
 
 	return EAVL_OK;
 	}
@@ -98,6 +100,7 @@ int PUBLIC(Clear)(
 	EAVLs_node_t*		prev;
 	EAVLs_node_t*		node;
 	EAVLs_cbPathe_t		cbpathe;
+	EAVLs_pathelement_t*	pathv;
 	void*			cbdata;
 	unsigned int		pathlen = 0;
 	unsigned int		i;
@@ -106,6 +109,8 @@ int PUBLIC(Clear)(
 	CHECK_PARAM_NON_NULL(context);
 	CHECK_STD_PRE(context, context->tree, 0);
 
+	PATHE_VECTOR(context, pathv);
+
 	cbpathe = context->cbpathe;
 	cbdata = context->common.cbdata;
 
@@ -204,13 +209,32 @@ int PUBLIC(Context_Init)(
 	context->common.self = &context->common;
 	context->cbpathe = cbpathe;
 	context->common.cbdata = cbdata;
+	context->common.generation = 0;
 	context->recent = NULL;
 	context->pathlen = 0;
+	context->vectored = 0;
 
 	return EAVL_OK;
 	}
 
 
+int PUBLIC(Context_Init_Vectored)(
+		EAVLs_context_t*	context,
+		EAVLs_cbPathe_t		cbpathe,
+		void*			cbdata
+		)
+	{
+	int			result;
+
+	if ((result = PUBLIC(Context_Init)(context, cbpathe, cbdata)) == EAVL_OK)
+		{
+		context->vectored = 1;
+		}
+
+	return result;
+	}
+
+
 int PUBLIC(Context_Associate)(
 		EAVLs_context_t*	context,
 		EAVLs_tree_t*		tree
@@ -227,7 +251,7 @@ int PUBLIC(Context_Associate)(
 		}
 
 	context->tree = tree;
-	tree->common.associations++;
+	(void) __atomic_add_fetch(&tree->common.associations, 1, __ATOMIC_RELAXED);
 
 	CONTEXT_RESET(context, 0);
 
@@ -253,7 +277,7 @@ int PUBLIC(Context_Disassociate)(
 	CONTEXT_RESET(context, 0);
 
 	context->tree = NULL;
-	tree->common.associations--;
+	(void) __atomic_sub_fetch(&tree->common.associations, 1, __ATOMIC_RELAXED);
 
 	CHECK_TREE(context, tree);
 
@@ -285,6 +309,7 @@ int PRIVATE(find)(
 		EAVL_rel_t		rel,
 		EAVLs_cbCompare_t	compare,
 		EAVLs_cbPathe_t		cbpathe,
+		EAVLs_pathelement_t*	pathv,
 		void*			cbdata,
 		void*			ref_value,
 		EAVLs_node_t*		ref_node,
@@ -358,6 +383,7 @@ int PUBLIC(Find)(
 		)
 	{
 	EAVLs_node_t*		node;
+	EAVLs_pathelement_t*	pathv;
 	unsigned int		pathlen;
 	int			result;
 
@@ -367,6 +393,8 @@ int PUBLIC(Find)(
 
 	CHECK_STD_PRE(context, context->tree, 0);
 
+	PATHE_VECTOR(context, pathv);
+
 	CONTEXT_RESET(context, 1);
 
 	if (!compare)
@@ -379,6 +407,7 @@ int PUBLIC(Find)(
 			rel,
 			compare,
 			context->cbpathe,
+			pathv,
 			context->common.cbdata,
 			ref_value,
 			ref_node,
@@ -402,6 +431,124 @@ int PUBLIC(Find)(
 	}
 
 
+/*
+** The part of the saved path still linked from the root is kept, so the
+** search for the recent node resumes from the deepest surviving node.
+** Links alone do not show that a kept node still has its old key, so a
+** search that misses below it is repeated from the root.
+*/
+int PUBLIC(Context_Reseek)(
+		EAVLs_context_t*	context
+		)
+	{
+	EAVLs_node_t*		recent;
+	EAVLs_node_t*		parent = NULL;
+	EAVLs_node_t*		node;
+	EAVLs_cbPathe_t		cbpathe;
+	EAVLs_pathelement_t*	pathv;
+	void*			cbdata;
+	EAVL_dir_t		cmp;
+	unsigned int		savedlen;
+	unsigned int		pathlen;
+	int			result = EAVL_OK;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	recent = context->recent;
+	if (!recent)
+		{
+		RESULT(EAVL_ERROR_CONTEXT);
+		}
+
+	if (context->common.generation == context->tree->common.generation)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	savedlen = context->pathlen;
+	cbpathe = context->cbpathe;
+	cbdata = context->common.cbdata;
+
+	PATHE_VECTOR(context, pathv);
+
+	CONTEXT_RESET(context, 1);
+
+	for (pathlen=1; pathlen<savedlen; pathlen++)
+		{
+		PATHE_GET_SAFE(pathlen, cbpathe, cbdata, node);
+
+		if (node != ((parent)
+				? GET_CHILD(parent, SID(parent, node))
+				: context->tree->root
+				))
+			{
+			break;
+			}
+
+		parent = node;
+		}
+
+	if (pathlen == savedlen && recent == ((parent)
+			? GET_CHILD(parent, SID(parent, recent))
+			: context->tree->root
+			))
+		{
+		CONTEXT_SET(context, recent, pathlen, 0);
+		RESULT(EAVL_OK);
+		}
+
+	if (parent)
+		{
+		node = parent;
+		pathlen--;
+		}
+	else
+		{
+		node = context->tree->root;
+		}
+
+	for (;;)
+		{
+		while (node)
+			{
+			CB_COMPARE(NULL, recent, node, context->tree->cbset->compare, cbdata, cmp);
+			if (cmp == EAVL_CMP_SAME)
+				{
+				break;
+				}
+
+			PATHE_SET_SAFE(pathlen++, cbpathe, cbdata, node);
+			node = GET_CHILD(node, (cmp == EAVL_CMP_LEFT) ? DIR_RIGHT : DIR_LEFT);
+			}
+
+		if (node || !parent)
+			{
+			break;
+			}
+
+		/* A kept node was reused under another key; search from the root */
+		parent = NULL;
+		pathlen = 1;
+		node = context->tree->root;
+		}
+
+	if (node)
+		{
+		CONTEXT_SET(context, node, pathlen, 0);
+		}
+	else
+		{
+		result = EAVL_NOTFOUND;
+		}
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
 int PUBLIC(First)(
 		EAVLs_context_t*	context,
 		EAVL_dir_t		dir,
@@ -412,6 +559,7 @@ int PUBLIC(First)(
 	EAVLs_node_t*		curr;
 	EAVLs_node_t*		next;
 	EAVLs_cbPathe_t		cbpathe;
+	EAVLs_pathelement_t*	pathv;
 	void*			cbdata;
 	unsigned int		pathlen = 0;
 	int			result = EAVL_OK;
@@ -423,6 +571,8 @@ int PUBLIC(First)(
 
 	CHECK_STD_PRE(context, context->tree, 0);
 
+	PATHE_VECTOR(context, pathv);
+
 	CONTEXT_RESET(context, 1);
 
 	cbpathe = context->cbpathe;
@@ -487,6 +637,7 @@ int PUBLIC(Next)(
 	EAVLs_node_t*		curr;
 	EAVLs_node_t*		prev;
 	EAVLs_cbPathe_t		cbpathe;
+	EAVLs_pathelement_t*	pathv;
 	void*			cbdata;
 	EAVL_dir_t		other = DIR_OTHER(dir);
 	unsigned int		pathlen;
@@ -499,6 +650,8 @@ int PUBLIC(Next)(
 
 	CHECK_STD_PRE(context, context->tree, 1);
 
+	PATHE_VECTOR(context, pathv);
+
 	curr = context->recent;
 	pathlen = context->pathlen;
 	cbpathe = context->cbpathe;
@@ -598,6 +751,7 @@ int PUBLIC(Fixup)(
 	EAVLs_node_t*		curr;
 	EAVLs_cbFixup_t		fixup;
 	EAVLs_cbPathe_t		cbpathe;
+	EAVLs_pathelement_t*	pathv;
 	void*			cbdata;
 	unsigned int		pathlen;
 	int			result = EAVL_OK;
@@ -606,6 +760,8 @@ int PUBLIC(Fixup)(
 
 	CHECK_CONTEXT(context, 1);
 
+	PATHE_VECTOR(context, pathv);
+
 	curr = context->recent;
 	pathlen = context->pathlen;
 	fixup = context->tree->cbset->fixup;
@@ -738,6 +894,109 @@ int PUBLIC(Load)(
 	}
 
 
+static void* PRIVATE(serialize_getchild)(
+		void*			node,
+		EAVL_dir_t		dir
+		)
+	{
+	return GET_CHILD((EAVLs_node_t*)node, dir);
+	}
+
+
+int PUBLIC(Serialize)(
+		EAVLs_context_t*	context,
+		unsigned int*		countp,
+		EAVLs_node_t**		nodes,
+		unsigned char*		shape
+		)
+	{
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(countp);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (*countp)
+		{
+		CHECK_PARAM_NON_NULL(nodes);
+		CHECK_PARAM_NON_NULL(shape);
+		}
+
+	result = FOREIGN(_, serialize)(
+			context->tree->root,
+			countp,
+			(void**)nodes,
+			shape,
+			&PRIVATE(serialize_getchild)
+			);
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+int PUBLIC(Deserialize)(
+		EAVLs_context_t*	context,
+		unsigned int		count,
+		EAVLs_node_t**		nodes,
+		unsigned char*		shape,
+		int			fixup
+		)
+	{
+	unsigned int		rootindex;
+	unsigned int		i;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+	if (context->tree->root)
+		{
+		RESULT(EAVL_ERROR_PARAMETER);
+		}
+
+	if (!count)
+		{
+		RESULT(EAVL_OK);
+		}
+
+	CHECK_PARAM_NON_NULL(nodes);
+	CHECK_PARAM_NON_NULL(shape);
+	CHECK_NODES_ALIGN(count, nodes);
+
+	for (i=0; i<count; i++)
+		{
+		NODE_INIT(nodes[i]);
+		}
+
+	result = FOREIGN(_, deserialize)(
+			&rootindex,
+			count,
+			(void**)nodes,
+			shape,
+			&PRIVATE(load_cbset),
+			(fixup)
+				? (FOREIGN(_, load_cbFixup_t))context->tree->cbset->fixup
+				: NULL,
+			context->common.cbdata
+			);
+
+	if (result == EAVL_OK)
+		{
+		context->tree->root = nodes[rootindex];
+		}
+
+	CONTEXT_RESET_ALL(context);
+	CONTEXT_RESET(context, 0);
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
 static void PRIVATE(rotate_single)(
 		EAVL_dir_t		dir,
 		EAVLs_node_t*		P,	// Never NULL
@@ -818,6 +1077,7 @@ static int PRIVATE(insert)(
 		EAVLs_cbCompare_t	compare,
 		EAVLs_cbFixup_t		fixup,
 		EAVLs_cbPathe_t		cbpathe,
+		EAVLs_pathelement_t*	pathv,
 		void*			cbdata,
 		EAVLs_node_t**		resultp,
 		unsigned int*		pathlenp
@@ -971,6 +1231,7 @@ int PUBLIC(Insert)(
 		EAVLs_node_t**		resultp
 		)
 	{
+	EAVLs_pathelement_t*	pathv;
 	unsigned int		pathlen;
 	int			result;
 
@@ -981,6 +1242,8 @@ int PUBLIC(Insert)(
 	CHECK_NODE_ALIGN(new_node);
 	CHECK_STD_PRE(context, context->tree, 0);
 
+	PATHE_VECTOR(context, pathv);
+
 	CONTEXT_RESET(context, 1);
 
 	result = PRIVATE(insert)(
@@ -989,6 +1252,7 @@ int PUBLIC(Insert)(
 			context->tree->cbset->compare,
 			context->tree->cbset->fixup,
 			context->cbpathe,
+			pathv,
 			context->common.cbdata,
 			resultp,
 			&pathlen
@@ -998,6 +1262,7 @@ int PUBLIC(Insert)(
 		{
 		CONTEXT_RESET_ALL(context);
 		CONTEXT_SET(context, *resultp, pathlen, 0);
+		CHECK_PATH(context, context->tree, *resultp);
 		}
 	else if (result == EAVL_EXISTS)
 		{
@@ -1052,6 +1317,7 @@ static int PRIVATE(remove)(
 		unsigned int		pathlen,
 		EAVLs_cbFixup_t		fixup,
 		EAVLs_cbPathe_t		cbpathe,
+		EAVLs_pathelement_t*	pathv,
 		void*			cbdata,
 		EAVLs_node_t**		nodep
 		)
@@ -1223,18 +1489,25 @@ int PUBLIC(Remove)(
 		EAVLs_node_t**		nodep
 		)
 	{
+	EAVLs_node_t*		del_node;
+	EAVLs_pathelement_t*	pathv;
 	int			result;
 
 	CHECK_PARAM_NON_NULL(context);
 
 	CHECK_STD_PRE(context, context->tree, 1);
 
+	PATHE_VECTOR(context, pathv);
+
+	del_node = context->recent;
+
 	result = PRIVATE(remove)(
 			&context->tree->root,
 			context->recent,
 			context->pathlen,
 			context->tree->cbset->fixup,
 			context->cbpathe,
+			pathv,
 			context->common.cbdata,
 			nodep
 			);
@@ -1245,6 +1518,11 @@ int PUBLIC(Remove)(
 		CONTEXT_RESET(context, 0);
 		}
 
+	if (result == EAVL_OK)
+		{
+		CHECK_PATH(context, context->tree, del_node);
+		}
+
 	CHECK_STD_POST(context->tree, context);
 
 	RETURN;
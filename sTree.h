@@ -105,7 +105,7 @@ int PRIVATE(Path_match)(
 		{							\
 		(CONTEXT)->recent = (NODE);				\
 		(CONTEXT)->pathlen = (POS);				\
-		if (!(NO_TRUNCATE))					\
+		if (!(NO_TRUNCATE) && !(CONTEXT)->vectored)		\
 			{						\
 			PATHE_TRUNCATE(					\
 					(POS),				\
@@ -0,0 +1,524 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+#include <stddef.h>
+
+#include "EAVL_sTree.h"
+
+#define CHECKS_AVAILABLE	EAVLs_CHECKS_AVAILABLE
+
+#include "sTree.h"
+#include "sTree_internal.h"
+
+#include "callback_internal.h"
+#include "checks_internal.h"
+#include "context_internal.h"
+#include "eavl_internal.h"
+#include "naming_internal.h"
+#include "pathe_internal.h"
+
+
+/*
+** Augmented nodes keep the node count and the monoid total of their
+** subtree. The totals are combined in key order, so a monoid need not be
+** commutative. All the nodes of a tree must use the same monoid.
+*/
+
+
+#define AUG(NODE)		EAVLs_AUG((NODE))
+
+#define AUG_COUNT(NODE)		((NODE) ? AUG((NODE))->count : 0)
+#define AUG_TOTAL(NODE, MONOID)	((NODE) ? AUG((NODE))->total : (MONOID)->identity)
+
+
+int PUBLIC(Aug_Init)(
+		EAVLs_aug_node_t*	aug,
+		const EAVL_monoid_t*	monoid,
+		EAVL_aug_value_t	value
+		)
+	{
+	CHECK_PARAM_NON_NULL(aug);
+	CHECK_PARAM_NON_NULL(monoid);
+
+	aug->count = 1;
+	aug->value = value;
+	aug->total = value;
+	aug->monoid = monoid;
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Aug_Fixup)(
+		EAVLs_node_t*		node,
+		EAVLs_node_t*		childL,
+		EAVLs_node_t*		childR,
+		void*			cbdata
+		)
+	{
+	EAVLs_aug_node_t*	aug = AUG(node);
+	const EAVL_monoid_t*	monoid = aug->monoid;
+	uintptr_t		count;
+	EAVL_aug_value_t	total;
+
+	QUIET_UNUSED(cbdata);
+
+	count = AUG_COUNT(childL) + 1 + AUG_COUNT(childR);
+	total = (*monoid->combine)(
+			(*monoid->combine)(AUG_TOTAL(childL, monoid), aug->value),
+			AUG_TOTAL(childR, monoid)
+			);
+
+	if (aug->count == count && aug->total == total)
+		{
+		return EAVL_CB_FINISHED;
+		}
+
+	aug->count = count;
+	aug->total = total;
+
+	return EAVL_CB_OK;
+	}
+
+
+int PUBLIC(Aug_Verify)(
+		EAVLs_node_t*		node,
+		EAVLs_node_t*		childL,
+		EAVLs_node_t*		childR,
+		void*			cbdata
+		)
+	{
+	EAVLs_aug_node_t*	aug = AUG(node);
+	const EAVL_monoid_t*	monoid = aug->monoid;
+	EAVL_aug_value_t	total;
+
+	QUIET_UNUSED(cbdata);
+
+	total = (*monoid->combine)(
+			(*monoid->combine)(AUG_TOTAL(childL, monoid), aug->value),
+			AUG_TOTAL(childR, monoid)
+			);
+
+	if (aug->count != AUG_COUNT(childL) + 1 + AUG_COUNT(childR)
+			|| aug->total != total
+			)
+		{
+		return EAVL_CB_ERROR;
+		}
+
+	return EAVL_CB_OK;
+	}
+
+
+/*
+** The range is split at the first node within it. Walking down from there
+** towards each bound, every node inside the range contributes itself and
+** its whole subtree on the far side from the bound.
+*/
+static int PRIVATE(aug_range)(
+		EAVLs_node_t*		node,
+		EAVLs_cbCompare_t	compare,
+		void*			cbdata,
+		void*			lo_value,
+		EAVLs_node_t*		lo_node,
+		void*			hi_value,
+		EAVLs_node_t*		hi_node,
+		EAVL_aug_value_t*	totalp
+		)
+	{
+	EAVLs_node_t*		split;
+	const EAVL_monoid_t*	monoid;
+	EAVL_aug_value_t	left;
+	EAVL_aug_value_t	right;
+	EAVL_dir_t		cmp;
+
+	while (node)
+		{
+		CB_COMPARE(lo_value, lo_node, node, compare, cbdata, cmp);
+		if (cmp == EAVL_CMP_LEFT)
+			{
+			node = GET_CHILD(node, DIR_RIGHT);
+			continue;
+			}
+
+		CB_COMPARE(hi_value, hi_node, node, compare, cbdata, cmp);
+		if (cmp == EAVL_CMP_RIGHT)
+			{
+			node = GET_CHILD(node, DIR_LEFT);
+			continue;
+			}
+
+		break;
+		}
+
+	if (!node)
+		{
+		return EAVL_NOTFOUND;
+		}
+
+	split = node;
+	monoid = AUG(split)->monoid;
+	left = monoid->identity;
+	right = monoid->identity;
+
+	node = GET_CHILD(split, DIR_LEFT);
+	while (node)
+		{
+		CB_COMPARE(lo_value, lo_node, node, compare, cbdata, cmp);
+		if (cmp == EAVL_CMP_LEFT)
+			{
+			node = GET_CHILD(node, DIR_RIGHT);
+			continue;
+			}
+
+		left = (*monoid->combine)(
+				(*monoid->combine)(
+					AUG(node)->value,
+					AUG_TOTAL(GET_CHILD(node, DIR_RIGHT), monoid)
+					),
+				left
+				);
+		node = GET_CHILD(node, DIR_LEFT);
+		}
+
+	node = GET_CHILD(split, DIR_RIGHT);
+	while (node)
+		{
+		CB_COMPARE(hi_value, hi_node, node, compare, cbdata, cmp);
+		if (cmp == EAVL_CMP_RIGHT)
+			{
+			node = GET_CHILD(node, DIR_LEFT);
+			continue;
+			}
+
+		right = (*monoid->combine)(
+				right,
+				(*monoid->combine)(
+					AUG_TOTAL(GET_CHILD(node, DIR_LEFT), monoid),
+					AUG(node)->value
+					)
+				);
+		node = GET_CHILD(node, DIR_RIGHT);
+		}
+
+	*totalp = (*monoid->combine)(
+			(*monoid->combine)(left, AUG(split)->value),
+			right
+			);
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Aug_Range)(
+		EAVLs_context_t*	context,
+		EAVLs_cbCompare_t	compare,
+		void*			lo_value,
+		EAVLs_node_t*		lo_node,
+		void*			hi_value,
+		EAVLs_node_t*		hi_node,
+		EAVL_aug_value_t*	totalp
+		)
+	{
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(totalp);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (!compare)
+		{
+		compare = context->tree->cbset->compare;
+		}
+
+	result = PRIVATE(aug_range)(
+			context->tree->root,
+			compare,
+			context->common.cbdata,
+			lo_value,
+			lo_node,
+			hi_value,
+			hi_node,
+			totalp
+			);
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+/*
+** Rank and select steer by the node counts of the subtrees. The rank of a
+** reference is the number of nodes before it, and of a matching node too
+** if the rank is inclusive.
+*/
+static int PRIVATE(aug_rank)(
+		EAVLs_node_t*		node,
+		EAVLs_cbCompare_t	compare,
+		void*			cbdata,
+		void*			ref_value,
+		EAVLs_node_t*		ref_node,
+		unsigned int		inclusive,
+		uintptr_t*		rankp
+		)
+	{
+	uintptr_t		rank = 0;
+	EAVL_dir_t		cmp;
+
+	while (node)
+		{
+		CB_COMPARE(ref_value, ref_node, node, compare, cbdata, cmp);
+		if (cmp == EAVL_CMP_SAME)
+			{
+			rank += AUG_COUNT(GET_CHILD(node, DIR_LEFT));
+			if (inclusive)
+				{
+				rank++;
+				}
+			*rankp = rank;
+			return EAVL_OK;
+			}
+
+		if (cmp == EAVL_CMP_LEFT)
+			{
+			rank += AUG_COUNT(GET_CHILD(node, DIR_LEFT)) + 1;
+			node = GET_CHILD(node, DIR_RIGHT);
+			}
+		else
+			{
+			node = GET_CHILD(node, DIR_LEFT);
+			}
+		}
+
+	*rankp = rank;
+
+	return EAVL_NOTFOUND;
+	}
+
+
+static int PRIVATE(aug_select)(
+		EAVLs_node_t*		node,
+		EAVLs_cbPathe_t		cbpathe,
+		EAVLs_pathelement_t*	pathv,
+		void*			cbdata,
+		uintptr_t		index,
+		EAVLs_node_t**		resultp,
+		unsigned int*		pathlenp
+		)
+	{
+	uintptr_t		left;
+	unsigned int		pathlen = 0;
+
+	PATHE_SET_SAFE(pathlen++, cbpathe, cbdata, NULL);
+
+	while (node)
+		{
+		left = AUG_COUNT(GET_CHILD(node, DIR_LEFT));
+		if (index == left)
+			{
+			*resultp = node;
+			*pathlenp = pathlen;
+			return EAVL_OK;
+			}
+
+		PATHE_SET_SAFE(pathlen++, cbpathe, cbdata, node);
+		if (index < left)
+			{
+			node = GET_CHILD(node, DIR_LEFT);
+			}
+		else
+			{
+			index -= left + 1;
+			node = GET_CHILD(node, DIR_RIGHT);
+			}
+		}
+
+	return EAVL_NOTFOUND;
+	}
+
+
+int PUBLIC(Rank)(
+		EAVLs_context_t*	context,
+		EAVLs_cbCompare_t	compare,
+		void*			ref_value,
+		EAVLs_node_t*		ref_node,
+		uintptr_t*		rankp
+		)
+	{
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(rankp);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (!compare)
+		{
+		compare = context->tree->cbset->compare;
+		}
+
+	result = PRIVATE(aug_rank)(
+			context->tree->root,
+			compare,
+			context->common.cbdata,
+			ref_value,
+			ref_node,
+			0,
+			rankp
+			);
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+int PUBLIC(Select)(
+		EAVLs_context_t*	context,
+		uintptr_t		index,
+		EAVLs_node_t**		resultp
+		)
+	{
+	EAVLs_node_t*		node;
+	EAVLs_pathelement_t*	pathv;
+	unsigned int		pathlen;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(resultp);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	PATHE_VECTOR(context, pathv);
+
+	CONTEXT_RESET(context, 1);
+
+	result = PRIVATE(aug_select)(
+			context->tree->root,
+			context->cbpathe,
+			pathv,
+			context->common.cbdata,
+			index,
+			&node,
+			&pathlen
+			);
+
+	if (result == EAVL_OK)
+		{
+		CONTEXT_SET(context, node, pathlen, 0);
+		*resultp = node;
+		}
+	else
+		{
+		CONTEXT_RESET(context, (result == EAVL_CALLBACK));
+		}
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+int PUBLIC(Count_Range)(
+		EAVLs_context_t*	context,
+		EAVLs_cbCompare_t	compare,
+		void*			lo_value,
+		EAVLs_node_t*		lo_node,
+		void*			hi_value,
+		EAVLs_node_t*		hi_node,
+		uintptr_t*		countp
+		)
+	{
+	uintptr_t		lo;
+	uintptr_t		hi;
+	int			result;
+
+	CHECK_PARAM_NON_NULL(context);
+	CHECK_PARAM_NON_NULL(countp);
+
+	CHECK_STD_PRE(context, context->tree, 0);
+
+	if (!compare)
+		{
+		compare = context->tree->cbset->compare;
+		}
+
+	result = PRIVATE(aug_rank)(
+			context->tree->root,
+			compare,
+			context->common.cbdata,
+			lo_value,
+			lo_node,
+			0,
+			&lo
+			);
+	if (result != EAVL_OK && result != EAVL_NOTFOUND)
+		{
+		RESULT(result);
+		}
+
+	result = PRIVATE(aug_rank)(
+			context->tree->root,
+			compare,
+			context->common.cbdata,
+			hi_value,
+			hi_node,
+			1,
+			&hi
+			);
+	if (result != EAVL_OK && result != EAVL_NOTFOUND)
+		{
+		RESULT(result);
+		}
+
+	*countp = (hi > lo) ? hi - lo : 0;
+	result = EAVL_OK;
+
+	CHECK_STD_POST(context->tree, context);
+
+	RETURN;
+	}
+
+
+/* sTree_aug.c */
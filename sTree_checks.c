@@ -41,7 +41,6 @@
 
 
 #include <stddef.h>
-#include <stdlib.h>
 
 #include "EAVL.h"
 #include "EAVL_sTree.h"
@@ -62,6 +61,58 @@
 unsigned int	PUBLIC(Checks_Available) = EAVLs_CHECKS_AVAILABLE & EAVL_CHECK_ALL;
 unsigned int	PUBLIC(Checks_Enabled) = 0;
 
+unsigned int	PRIVATE(Checks_Interval)[EAVL_CHECK_COUNT];
+uintptr_t	PRIVATE(Checks_Count)[EAVL_CHECK_COUNT];
+
+
+int PUBLIC(Checks_Sample)(
+		unsigned int		checks,
+		unsigned int		interval
+		)
+	{
+	unsigned int		i;
+
+	if (checks & ~CHECKS_SAMPLED)
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	for (i=0; i<EAVL_CHECK_COUNT; i++)
+		{
+		if (checks & (1u<<i))
+			{
+			PRIVATE(Checks_Interval)[i] = interval;
+			__atomic_store_n(&PRIVATE(Checks_Count)[i], 0, __ATOMIC_RELAXED);
+			}
+		}
+
+	return EAVL_OK;
+	}
+
+
+int PUBLIC(Tree_Checks)(
+		EAVLs_tree_t*		tree,
+		unsigned int		checks
+		)
+	{
+	if (!tree || (checks & ~EAVL_CHECK_ALL))
+		{
+		return EAVL_ERROR_PARAMETER;
+		}
+
+	/* The record of associated contexts would be incomplete */
+	if (tree->common.associations
+			&& ((tree->common.checks ^ checks) & EAVL_CHECK_CONTEXT)
+			)
+		{
+		return EAVL_ERROR_CONTEXT;
+		}
+
+	tree->common.checks = checks;
+
+	return EAVL_OK;
+	}
+
 
 #if CHECKS_AVAILABLE & EAVL_CHECK_CONTEXT
 
@@ -72,6 +123,7 @@ int PRIVATE(Path_match)(
 	{
 	EAVLs_node_t*		node;
 	EAVLs_cbPathe_t		cbpathe;
+	EAVLs_pathelement_t*	pathv;
 	void*			cbdata;
 	unsigned int		i;
 
@@ -85,6 +137,8 @@ int PRIVATE(Path_match)(
 	cbpathe = context->cbpathe;
 	cbdata = context->common.cbdata;
 
+	PATHE_VECTOR(context, pathv);
+
 	node = context->recent;
 	for (i=context->pathlen-1; i; i--)
 		{
@@ -121,82 +175,233 @@ int PRIVATE(Path_match)(
 #if CHECKS_AVAILABLE & EAVL_CHECK_TREE
 
 
-static int PRIVATE(validate_tree_recurse)(
-		EAVLs_node_t*		node,
-		int*			heightp,
-		EAVLs_node_t**		leftp,
-		EAVLs_cbCompare_t	compare,
+/*
+** The tree is walked in post-order with an explicit stack of at most
+** HEIGHT_MAX frames, checking order at each in-order step and balance
+** and cbVerify once both subtrees are done; a cycle fails the check
+** instead of overflowing the stack.
+*/
+typedef struct
+	{
+	EAVLs_node_t*		node;
+	unsigned int		height[2];
+	unsigned int		state;		/* Next child to walk		*/
+	}			vframe_t;
+
+
+static int PRIVATE(validate_node)(
+		vframe_t*		frame,
 		EAVLs_cbVerify_t*	verifyp,
 		void*			cbdata
 		)
 	{
-	int			result;
-	int			height[2] = {0, 0};
-	EAVL_dir_t		bal_node;
+	EAVLs_node_t*		node = frame->node;
+	unsigned int		left = frame->height[DIR_LEFT];
+	unsigned int		right = frame->height[DIR_RIGHT];
 	EAVL_dir_t		bal_height;
-	EAVLs_node_t*		T;
+
+	bal_height = (left == right)
+			? DIR_NEITHER
+			: ((left > right)
+				? DIR_LEFT
+				: DIR_RIGHT
+			);
+
+	if (bal_height != GET_BAL(node) || MAX(left, right) - MIN(left, right) > 1)
+		{
+		return EAVL_ERROR_TREE;
+		}
+
+	CB_VERIFY(
+			node,
+			GET_CHILD(node, DIR_LEFT),
+			GET_CHILD(node, DIR_RIGHT),
+			*verifyp,
+			cbdata
+			);
+
+	return EAVL_OK;
+	}
+
+
+static int PRIVATE(validate_tree_walk)(
+		EAVLs_node_t*		root,
+		EAVLs_cbCompare_t	compare,
+		EAVLs_cbVerify_t*	verifyp,
+		void*			cbdata
+		)
+	{
+	vframe_t		frames[HEIGHT_MAX];
+	vframe_t*		frame;
+	EAVLs_node_t*		child;
+	EAVLs_node_t*		prev = NULL;
+	unsigned int		depth = 1;
+	EAVL_dir_t		dir;
 	EAVL_dir_t		cmp;
+	int			result;
 
-	T = GET_CHILD(node, DIR_LEFT);
-	if (T)
+	frames[0].node = root;
+	frames[0].height[DIR_LEFT] = 0;
+	frames[0].height[DIR_RIGHT] = 0;
+	frames[0].state = DIR_LEFT;
+
+	while (depth)
 		{
-		result = PRIVATE(validate_tree_recurse)(
-				T,
-				&height[DIR_LEFT],
-				leftp,
-				compare,
-				verifyp,
-				cbdata
-				);
-		if (result != EAVL_OK)
+		frame = &frames[depth-1];
+
+		if (frame->state <= DIR_RIGHT)
+			{
+			dir = frame->state++;
+
+			if (dir == DIR_RIGHT)
+				{
+				if (prev)
+					{
+					CB_COMPARE(NULL, prev, frame->node, compare, cbdata, cmp);
+					if (cmp != DIR_RIGHT)
+						{
+						return EAVL_ERROR_COMPARE;
+						}
+					}
+				prev = frame->node;
+				}
+
+			if (!(child = GET_CHILD(frame->node, dir)))
+				{
+				continue;
+				}
+
+			if (depth == HEIGHT_MAX)
+				{
+				/* Taller than any tree; a cycle */
+				return EAVL_ERROR_TREE;
+				}
+
+			frames[depth].node = child;
+			frames[depth].height[DIR_LEFT] = 0;
+			frames[depth].height[DIR_RIGHT] = 0;
+			frames[depth].state = DIR_LEFT;
+			depth++;
+			continue;
+			}
+
+		if ((result = PRIVATE(validate_node)(frame, verifyp, cbdata)) != EAVL_OK)
 			{
 			return result;
 			}
-		}
 
-	if (*leftp)
-		{
-		CB_COMPARE(NULL, *leftp, node, compare, cbdata, cmp);
-		if (cmp != DIR_RIGHT)
+		if (--depth)
 			{
-			return EAVL_ERROR_COMPARE;
+			frames[depth-1].height[frames[depth-1].state-1]
+					= MAX(frame->height[DIR_LEFT], frame->height[DIR_RIGHT]) + 1;
 			}
 		}
 
-	*leftp = node;
+	return EAVL_OK;
+	}
+
 
-	T = GET_CHILD(node, DIR_RIGHT);
-	if (T)
+int PRIVATE(Validate_Tree)(
+		EAVLs_context_t*	context,
+		EAVLs_tree_t*		tree
+		)
+	{
+	int			result = EAVL_OK;
+	EAVLs_cbVerify_t	verify = tree->cbset->verify;
+
+	if (tree->root)
 		{
-		result = PRIVATE(validate_tree_recurse)(
-				T,
-				&height[DIR_RIGHT],
-				leftp,
-				compare,
-				verifyp,
-				cbdata
+		result = PRIVATE(validate_tree_walk)(
+				tree->root,
+				tree->cbset->compare,
+				&verify,
+				context->common.cbdata
 				);
-		if (result != EAVL_OK)
+		}
+
+	return result;
+	}
+
+
+#endif	/* EAVLs_CHECKS_AVAILABLE & EAVL_CHECK_TREE */
+
+
+#if CHECKS_AVAILABLE & EAVL_CHECK_PATH
+
+
+static unsigned int PRIVATE(path_height)(
+		EAVLs_node_t*		node
+		)
+	{
+	unsigned int		height = 0;
+
+	/* Below the checked nodes the balance information is trusted */
+	while (node && height < HEIGHT_MAX)
+		{
+		height++;
+		node = GET_CHILD(node, (GET_BAL(node) == DIR_RIGHT) ? DIR_RIGHT : DIR_LEFT);
+		}
+
+	return height;
+	}
+
+
+static int PRIVATE(path_check_node)(
+		EAVLs_node_t*		node,
+		EAVLs_cbCompare_t	compare,
+		EAVLs_cbVerify_t*	verifyp,
+		void*			cbdata
+		)
+	{
+	EAVLs_node_t*		T;
+	unsigned int		height[2];
+	unsigned int		depth;
+	EAVL_dir_t		bal_height;
+	EAVL_dir_t		dir;
+	EAVL_dir_t		cmp;
+
+	for (dir=DIR_LEFT; dir<=DIR_RIGHT; dir++)
+		{
+		T = GET_CHILD(node, dir);
+		height[dir] = PRIVATE(path_height)(T);
+
+		if (!T)
 			{
-			return result;
+			continue;
+			}
+
+		/* The in-order neighbour on this side */
+		for (depth=0; GET_CHILD(T, DIR_OTHER(dir)); depth++)
+			{
+			if (depth == HEIGHT_MAX)
+				{
+				return EAVL_ERROR_TREE;
+				}
+			T = GET_CHILD(T, DIR_OTHER(dir));
+			}
+
+		CB_COMPARE(NULL, node, T, compare, cbdata, cmp);
+		if (cmp != dir)
+			{
+			return EAVL_ERROR_COMPARE;
 			}
 		}
 
-	bal_height = (height[0] == height[1])
+	bal_height = (height[DIR_LEFT] == height[DIR_RIGHT])
 			? DIR_NEITHER
-			: ((height[0] > height[1])
+			: ((height[DIR_LEFT] > height[DIR_RIGHT])
 				? DIR_LEFT
 				: DIR_RIGHT
 			);
-	bal_node = GET_BAL(node);
 
-	if (bal_height != bal_node || abs(height[0]-height[1]) > 1)
+	if (bal_height != GET_BAL(node)
+			|| MAX(height[DIR_LEFT], height[DIR_RIGHT])
+				- MIN(height[DIR_LEFT], height[DIR_RIGHT]) > 1
+			)
 		{
 		return EAVL_ERROR_TREE;
 		}
 
-	*heightp = MAX(height[0], height[1])+1;
-
 	CB_VERIFY(
 			node,
 			GET_CHILD(node, DIR_LEFT),
@@ -209,33 +414,109 @@ static int PRIVATE(validate_tree_recurse)(
 	}
 
 
-int PRIVATE(Validate_Tree)(
+static int PRIVATE(path_check)(
+		EAVLs_node_t*		node,
+		EAVLs_cbCompare_t	compare,
+		EAVLs_cbVerify_t*	verifyp,
+		void*			cbdata
+		)
+	{
+	EAVLs_node_t*		T;
+	EAVL_dir_t		dir;
+	int			result;
+
+	/* Rotations leave changed nodes beside the path too */
+	if ((result = PRIVATE(path_check_node)(node, compare, verifyp, cbdata)) != EAVL_OK)
+		{
+		return result;
+		}
+
+	for (dir=DIR_LEFT; dir<=DIR_RIGHT; dir++)
+		{
+		if ((T = GET_CHILD(node, dir))
+				&& (result = PRIVATE(path_check_node)(T, compare, verifyp, cbdata)) != EAVL_OK
+				)
+			{
+			return result;
+			}
+		}
+
+	return EAVL_OK;
+	}
+
+
+int PRIVATE(Validate_Path)(
 		EAVLs_context_t*	context,
-		EAVLs_tree_t*		tree
+		EAVLs_tree_t*		tree,
+		EAVLs_node_t*		node
 		)
 	{
-	int			result = EAVL_OK;
-	int			height;
+	EAVLs_cbCompare_t	compare = tree->cbset->compare;
 	EAVLs_cbVerify_t	verify = tree->cbset->verify;
-	EAVLs_node_t*		left = NULL;
+	void*			cbdata = context->common.cbdata;
+	EAVLs_node_t*		nearest[2] = {NULL, NULL};
+	EAVLs_node_t*		curr;
+	unsigned int		depth = 0;
+	EAVL_dir_t		dir;
+	EAVL_dir_t		cmp = DIR_NEITHER;
+	int			result;
 
-	if (tree->root)
+	/* The path to where the node is, or was */
+	for (curr = tree->root; curr; curr = GET_CHILD(curr, DIR_OTHER(cmp)))
 		{
-		result = PRIVATE(validate_tree_recurse)(
-				tree->root,
-				&height,
-				&left,
-				tree->cbset->compare,
-				&verify,
-				context->common.cbdata
-				);
+		if (depth++ == HEIGHT_MAX)
+			{
+			return EAVL_ERROR_TREE;
+			}
+
+		if ((result = PRIVATE(path_check)(curr, compare, &verify, cbdata)) != EAVL_OK)
+			{
+			return result;
+			}
+
+		CB_COMPARE(NULL, node, curr, compare, cbdata, cmp);
+		if (cmp == EAVL_CMP_SAME)
+			{
+			return EAVL_OK;
+			}
+
+		nearest[cmp] = curr;
 		}
 
-	return result;
+	/*
+	** A removed node with two children was replaced by one of its
+	** in-order neighbours, taken from the far end of the subtree on
+	** the neighbour's other side.
+	*/
+	for (dir=DIR_LEFT; dir<=DIR_RIGHT; dir++)
+		{
+		if (!nearest[dir])
+			{
+			continue;
+			}
+
+		for (curr = GET_CHILD(nearest[dir], dir), depth = 0;
+				curr;
+				curr = GET_CHILD(curr, DIR_OTHER(dir))
+				)
+			{
+			if (depth++ == HEIGHT_MAX)
+				{
+				return EAVL_ERROR_TREE;
+				}
+
+			if ((result = PRIVATE(path_check)(curr, compare, &verify, cbdata)) != EAVL_OK)
+				{
+				return result;
+				}
+			}
+		}
+
+	return EAVL_OK;
 	}
 
 
-#endif	/* EAVLs_CHECKS_AVAILABLE & EAVL_CHECK_TREE */
+#endif	/* EAVLs_CHECKS_AVAILABLE & EAVL_CHECK_PATH */
 
 
 /* sTree_check.c */
@@ -54,6 +54,7 @@ int FOREIGN(s_, find)(
 		EAVL_rel_t		rel,
 		EAVLs_cbCompare_t	compare,
 		EAVLs_cbPathe_t		cbpathe,
+		EAVLs_pathelement_t*	pathv,
 		void*			cbdata,
 		void*			ref_value,
 		EAVLs_node_t*		ref_node,
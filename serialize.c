@@ -0,0 +1,262 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+
+#include <stddef.h>
+
+#include "treeload.h"
+#include "treeload_internal.h"
+#include "serialize_internal.h"
+
+#include "eavl_internal.h"
+#include "naming_internal.h"
+
+
+#define SHAPE_GET(SHAPE, INDEX)						\
+		(((SHAPE)[(INDEX)>>1] >> (((INDEX)&1)<<2)) & 0x0Fu)
+
+#define SHAPE_SET(SHAPE, INDEX, CODE)					\
+	do								\
+		{							\
+		if ((INDEX)&1)						\
+			{						\
+			(SHAPE)[(INDEX)>>1] = (unsigned char)(		\
+					((SHAPE)[(INDEX)>>1] & 0x0Fu)	\
+					| ((CODE)<<4)			\
+					);				\
+			}						\
+		else							\
+			{						\
+			(SHAPE)[(INDEX)>>1] = (unsigned char)(CODE);	\
+			}						\
+		} while (0)
+
+
+/*
+** Records the shape of a tree as a pre-order stream of node codes and the
+** nodes themselves in (sorted) in-order.  Walks the whole tree even if the
+** arrays are too small so that *countp is the actual node count.
+**
+**	O(n) work
+**	O(log n) extra space
+*/
+int PRIVATE(serialize)(
+		void*			root,
+		unsigned int*		countp,
+		void**			nodep,
+		unsigned char*		shape,
+		FOREIGN(_, serialize_getchild_t)	getchild
+		)
+	{
+	void*			stack[SHAPE_HEIGHT_MAX];
+	unsigned int		depth = 0;
+	unsigned int		capacity = *countp;
+	unsigned int		pre = 0;
+	unsigned int		in = 0;
+	unsigned int		code;
+	void*			curr = root;
+
+	while (curr || depth)
+		{
+		while (curr)
+			{
+			if (depth >= SHAPE_HEIGHT_MAX)
+				{
+				return EAVL_ERROR_TREE;
+				}
+
+			if (pre < capacity)
+				{
+				code = EAVL_GET_BAL((EAVL_node_t*)curr) << SHAPE_BAL_SHIFT;
+				code |= ((*getchild)(curr, DIR_LEFT)) ? SHAPE_LEFT : 0;
+				code |= ((*getchild)(curr, DIR_RIGHT)) ? SHAPE_RIGHT : 0;
+				SHAPE_SET(shape, pre, code);
+				}
+			pre++;
+
+			stack[depth++] = curr;
+			curr = (*getchild)(curr, DIR_LEFT);
+			}
+
+		curr = stack[--depth];
+		if (in < capacity)
+			{
+			nodep[in] = curr;
+			}
+		in++;
+
+		curr = (*getchild)(curr, DIR_RIGHT);
+		}
+
+	*countp = in;
+
+	return (in > capacity) ? EAVL_ERROR_PARAMETER : EAVL_OK;
+	}
+
+
+/*
+** Rebuilds the exact tree recorded by serialize() from the shape stream and
+** the in-order node array.  No comparisons; each node is linked, balanced
+** and (optionally) fixed-up exactly once, children before parents.  The
+** stream is checked for consistency (node count, subtree heights agree with
+** the balance codes) as it is consumed.
+**
+**	O(n) work
+**	O(log n) extra space
+*/
+int PRIVATE(deserialize)(
+		unsigned int*		rootindex,
+		unsigned int		count,
+		void**			nodep,
+		unsigned char*		shape,
+		FOREIGN(_, load_cbset_t)*	cbset,
+		FOREIGN(_, load_cbFixup_t)	fixup,
+		void*			cbdata
+		)
+	{
+	struct
+		{
+		unsigned int		index;
+		unsigned int		height[2];
+		unsigned int		code;
+		int			placed;
+		}			stack[SHAPE_HEIGHT_MAX];
+	unsigned int		depth = 0;
+	unsigned int		pre = 0;
+	unsigned int		in = 0;
+	unsigned int		index = 0;
+	unsigned int		height;
+	EAVL_dir_t		bal;
+	EAVL_dir_t		expect;
+	int			enter = 1;
+	int			result = EAVL_OK;
+
+	for (;;)
+		{
+		if (enter)
+			{
+			if (pre >= count || depth >= SHAPE_HEIGHT_MAX)
+				{
+				return EAVL_ERROR_TREE;
+				}
+
+			stack[depth].code = SHAPE_GET(shape, pre);
+			stack[depth].height[0] = 0;
+			stack[depth].height[1] = 0;
+			stack[depth].placed = 0;
+			pre++;
+
+			if ((stack[depth].code >> SHAPE_BAL_SHIFT) > DIR_NEITHER)
+				{
+				return EAVL_ERROR_TREE;
+				}
+
+			if (stack[depth++].code & SHAPE_LEFT)
+				{
+				continue;
+				}
+
+			stack[depth-1].index = in++;
+			stack[depth-1].placed = 1;
+
+			if (stack[depth-1].code & SHAPE_RIGHT)
+				{
+				continue;
+				}
+			}
+
+		/* The node on the top of the stack is complete */
+		height = MAX(stack[depth-1].height[0], stack[depth-1].height[1]);
+		bal = stack[depth-1].code >> SHAPE_BAL_SHIFT;
+		expect = (stack[depth-1].height[0] == stack[depth-1].height[1])
+				? DIR_NEITHER
+				: (stack[depth-1].height[0] > stack[depth-1].height[1])
+					? DIR_LEFT
+					: DIR_RIGHT
+				;
+		if (bal != expect
+				|| height - MIN(stack[depth-1].height[0], stack[depth-1].height[1]) > 1
+				)
+			{
+			return EAVL_ERROR_TREE;
+			}
+
+		index = stack[depth-1].index;
+		LOAD_SETBAL(nodep, index, bal, cbset->setbal);
+		LOAD_FIXUP(nodep, index, cbset->fixup, fixup, cbdata, result);
+		height++;
+
+		if (!--depth)
+			{
+			break;
+			}
+
+		if (!stack[depth-1].placed)
+			{
+			stack[depth-1].index = in++;
+			stack[depth-1].placed = 1;
+			stack[depth-1].height[DIR_LEFT] = height;
+			LOAD_SETCHILD(nodep, stack[depth-1].index, index, DIR_LEFT, cbset->setchild);
+
+			enter = (stack[depth-1].code & SHAPE_RIGHT) ? 1 : 0;
+			}
+		else
+			{
+			stack[depth-1].height[DIR_RIGHT] = height;
+			LOAD_SETCHILD(nodep, stack[depth-1].index, index, DIR_RIGHT, cbset->setchild);
+
+			enter = 0;
+			}
+		}
+
+	if (pre != count)
+		{
+		return EAVL_ERROR_TREE;
+		}
+
+	*rootindex = index;
+
+	return result;
+	}
+
+
+/* serialize.c */
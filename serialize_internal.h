@@ -0,0 +1,92 @@
+/*\
+***  EAVL_Tree: Embedded AVL Tree
+\*/
+
+/*\
+*#*  Copyright (c) 2018, Raymond S Brand
+*#*  All rights reserved.
+*#*
+*#*  Redistribution and use in source and binary forms, with or without
+*#*  modification, are permitted provided that the following conditions
+*#*  are met:
+*#*
+*#*   * Redistributions of source code must retain the above copyright
+*#*     notice, this list of conditions and the following disclaimer.
+*#*
+*#*   * Redistributions in binary form must reproduce the above copyright
+*#*     notice, this list of conditions and the following disclaimer in
+*#*     the documentation and/or other materials provided with the
+*#*     distribution.
+*#*
+*#*   * Redistributions in source or binary form must carry prominent
+*#*     notices of any modifications.
+*#*
+*#*   * Neither the name of the Raymond S Brand nor the names of its
+*#*     contributors may be used to endorse or promote products derived
+*#*     from this software without specific prior written permission.
+*#*
+*#*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*#*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*#*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*#*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*#*  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*#*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*#*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*#*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*#*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*#*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*#*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*#*  POSSIBILITY OF SUCH DAMAGE.
+\*/
+
+
+
+#ifndef _SERIALIZE_INTERNAL_H
+#define _SERIALIZE_INTERNAL_H 1
+
+
+#include "EAVL.h"
+#include "naming_internal.h"
+#include "treeload_internal.h"
+
+
+/*
+** Shape stream node codes; one per node, in pre-order, 2 per byte, low
+** nibble first.
+*/
+#define SHAPE_LEFT		(1u<<0)	/* Node has a left child	*/
+#define SHAPE_RIGHT		(1u<<1)	/* Node has a right child	*/
+#define SHAPE_BAL_SHIFT		(2)	/* Node balance (EAVL_DIR_*)	*/
+
+/*
+** Deepest AVL tree with no more than UINT_MAX (2^32-1) nodes is 46.
+*/
+#define SHAPE_HEIGHT_MAX	(48)
+
+
+typedef void* (*FOREIGN(_, serialize_getchild_t))(
+		void*			node,
+		EAVL_dir_t		dir
+		);
+
+
+int FOREIGN(_, serialize)(
+		void*			root,
+		unsigned int*		countp,
+		void**			nodep,
+		unsigned char*		shape,
+		FOREIGN(_, serialize_getchild_t)	getchild
+		);
+
+int FOREIGN(_, deserialize)(
+		unsigned int*		rootindex,
+		unsigned int		count,
+		void**			nodep,
+		unsigned char*		shape,
+		FOREIGN(_, load_cbset_t)*	cbset,
+		FOREIGN(_, load_cbFixup_t)	fixup,
+		void*			cbdata
+		);
+
+
+#endif	/* _SERIALIZE_INTERNAL_H */
@@ -94,6 +94,12 @@ int insert(EAVLc_context_t* context, unsigned int k);
 int Eremove(EAVLc_context_t* context, unsigned int k);
 int Nfixup(EAVLc_context_t* context, unsigned int k);
 int traverse(EAVLc_context_t* context, EAVL_dir_t dir, EAVL_order_t order);
+void reshape(EAVLc_tree_t* tree, EAVLc_context_t* context, unsigned int count);
+void version(unsigned int count);
+void epoch(unsigned int count);
+void parallel(unsigned int count);
+void verify(unsigned int count);
+void fixup_all(unsigned int count);
 
 
 static pathestore_t* create_pathestore(void)
@@ -624,10 +630,124 @@ EAVLc_cbset_t cbset =
 		&Node_CMP,
 		&Ndup,
 		&Node_fixup,
-		&Node_verify
+		&Node_verify,
+		&Node_release
 		};
 
 
+unsigned int	vcopies;
+
+
+static EAVLc_node_t* Vdup(
+		EAVLc_node_t*		node,
+		void*			cbdata
+		)
+	{
+	struct node*		copy;
+
+	UNUSED(cbdata);
+
+	if (!(copy = (struct node*)malloc(sizeof(struct node))))
+		{
+		return NULL;
+		}
+
+	*copy = *container_of(node, struct node, node);
+	vcopies++;
+
+	return &copy->node;
+	}
+
+
+static int Vrelease(
+		EAVLc_node_t*		node,
+		void*			data
+		)
+	{
+	struct node*		vnode = container_of(node, struct node, node);
+
+	UNUSED(data);
+
+	if (vnode < nodes || vnode >= nodes + NODES)
+		{
+		free(vnode);
+		vcopies--;
+		}
+
+	return EAVL_CB_OK;
+	}
+
+
+EAVLc_epoch_t	vepoch;
+unsigned int	vretired;
+
+
+static int Vretire(
+		EAVLc_node_t*		node,
+		void*			data
+		)
+	{
+	UNUSED(data);
+
+	vretired++;
+
+	return (EAVLc_Epoch_Retire(&vepoch, node) == EAVL_OK)
+			? EAVL_CB_OK
+			: EAVL_CB_ERROR
+			;
+	}
+
+
+EAVLc_cbset_t vcbset =
+		{
+		&Node_CMP,
+		&Vdup,
+		&Node_fixup,
+		&Node_verify,
+		&Vrelease
+		};
+
+
+EAVLc_node_t*	pvisited[NODES];
+unsigned int	pvisits;
+unsigned int	pstop;
+int		pstopwith;
+
+
+static int Pvisit(
+		EAVLc_node_t*		node,
+		void*			data
+		)
+	{
+	UNUSED(data);
+
+	pvisited[pvisits++] = node;
+
+	return (pvisits == pstop) ? pstopwith : EAVL_CB_OK;
+	}
+
+
+static int Prun(
+		unsigned int		count,
+		EAVL_cbJob_t		job,
+		void*			jobdata,
+		void*			data
+		)
+	{
+	unsigned int		i;
+
+	UNUSED(data);
+
+	/* One at a time; the first job takes every piece in turn */
+	for (i=0; i<count; i++)
+		{
+		(void) (*job)(i, jobdata);
+		}
+
+	return EAVL_CB_OK;
+	}
+
+
 void Init_nodes(
 		struct node		fnodes[],
 		EAVLc_node_t*		fnodep[],
@@ -866,6 +986,703 @@ int traverse(
 	}
 
 
+void reshape(
+		EAVLc_tree_t*		tree,
+		EAVLc_context_t*	context,
+		unsigned int		count
+		)
+	{
+	static EAVLc_node_t*	snodep[NODES];
+	static unsigned char	shape[2][EAVL_SHAPE_SIZE(NODES)];
+	unsigned int		scount;
+	unsigned int		i;
+	unsigned int		k;
+	int			error;
+
+	/* An irregular shape that Load would not produce */
+	init_tree_context(tree, context);
+	check_reset(count, 0);
+	srandom(3);
+	for (i=0; i<count; i++)
+		{
+		k = (unsigned int)random()%count;
+		if (!member[k])
+			{
+			check_op(context, k, &insert, EAVL_OK, "Reshape insert", 1);
+			}
+		}
+
+	scount = NODES;
+	if ((error = EAVLc_Serialize(context, &scount, snodep, shape[0])) != EAVL_OK)
+		{
+		printf("ERROR: Serialize: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0, k=0; i<count; i++)
+		{
+		if (member[i] && snodep[k++] != nodep[i])
+			{
+			printf("ERROR: Serialize order: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	if (k != scount)
+		{
+		printf("ERROR: Serialize count: %u  expect: %u\n", scount, k);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Too small */
+	k = scount-1;
+	if ((error = EAVLc_Serialize(context, &k, snodep, shape[1])) != EAVL_ERROR_PARAMETER
+			|| k != scount
+			)
+		{
+		printf("ERROR: Serialize short: %d  count: %u\n", error, k);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Stored aggregates; no fixup */
+	init_tree_context(tree, context);
+	if ((error = EAVLc_Deserialize(context, scount, snodep, shape[0], 0)) != EAVL_OK)
+		{
+		printf("ERROR: Deserialize: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	if (check_tree(context))
+		{
+		printf("ERROR: Deserialize check\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	k = scount;
+	if ((error = EAVLc_Serialize(context, &k, snodep, shape[1])) != EAVL_OK
+			|| memcmp(shape[0], shape[1], EAVL_SHAPE_SIZE(scount) - (scount&1))
+			|| ((scount&1) && (shape[0][scount>>1] ^ shape[1][scount>>1]) & 0x0F)
+			)
+		{
+		printf("ERROR: Deserialize shape: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Recomputed aggregates */
+	init_tree_context(tree, context);
+	for (i=0; i<scount; i++)
+		{
+		container_of(snodep[i], struct node, node)->height = -1u;
+		}
+	if ((error = EAVLc_Deserialize(context, scount, snodep, shape[0], 1)) != EAVL_OK
+			|| check_tree(context)
+			)
+		{
+		printf("ERROR: Deserialize fixup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Inconsistent streams */
+	init_tree_context(tree, context);
+	if (scount > 1
+			&& (error = EAVLc_Deserialize(context, scount-1, snodep, shape[0], 0)) != EAVL_ERROR_TREE
+			)
+		{
+		printf("ERROR: Deserialize short: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	shape[0][0] ^= 0x0C;
+	if ((error = EAVLc_Deserialize(context, scount, snodep, shape[0], 0)) != EAVL_ERROR_TREE)
+		{
+		printf("ERROR: Deserialize balance: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void version(
+		unsigned int		count
+		)
+	{
+	EAVLc_version_t		ver;
+	EAVLc_context_t		wcontext;
+	EAVLc_tree_t		pinned[2];
+	EAVLc_context_t		rcontext[2];
+	EAVLc_node_t*		dummy;
+	unsigned int		i;
+	unsigned int		j;
+	int			error;
+
+	if (!EAVLc_Atomics_Available)
+		{
+		if ((error = EAVLc_Version_Init(&ver, &vcbset)) != EAVL_ERROR_BUILD)
+			{
+			printf("ERROR: Version_Init without atomics: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		return;
+		}
+
+	vcopies = 0;
+	if ((error = EAVLc_Version_Init(&ver, &vcbset)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&wcontext, &cb_pathe, create_cbData())) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&wcontext, &ver.tree)) != EAVL_OK
+			|| (error = EAVLc_Load(&wcontext, count, nodep)) != EAVL_OK
+			|| (error = EAVLc_Version_Publish(&ver, &wcontext, &Vrelease)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Version setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Pin the full version, then publish one without the even nodes */
+	for (j=0; j<2; j++)
+		{
+		if ((error = EAVLc_Version_Pin(&ver, &pinned[j])) != EAVL_OK
+				|| (error = EAVLc_Context_Init(&rcontext[j], &cb_pathe, create_cbData())) != EAVL_OK
+				|| (error = EAVLc_Context_Associate(&rcontext[j], &pinned[j])) != EAVL_OK
+				)
+			{
+			printf("ERROR: Version_Pin: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		for (i=0; !j && i<count; i+=2)
+			{
+			if ((error = EAVLc_Find(&wcontext, EAVL_FIND_EQ, NULL, NULL, nodep[i], &dummy)) != EAVL_OK
+					|| (error = EAVLc_Remove(&wcontext, &dummy)) != EAVL_OK
+					)
+				{
+				printf("ERROR: Version remove: %d\n", error);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+			(void) Vrelease(dummy, NULL);
+			}
+
+		if (!j && (error = EAVLc_Version_Publish(&ver, &wcontext, &Vrelease)) != EAVL_OK)
+			{
+			printf("ERROR: Version_Publish: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if (pinned[0].count != count || pinned[1].count != count/2)
+		{
+		printf("ERROR: Version count: %lu  %lu\n",
+				(unsigned long)pinned[0].count,
+				(unsigned long)pinned[1].count
+				);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if (EAVLc_Find(&rcontext[0], EAVL_FIND_EQ, NULL, NULL, nodep[i], &dummy) != EAVL_OK
+				|| EAVLc_Find(&rcontext[1], EAVL_FIND_EQ, NULL, NULL, nodep[i], &dummy)
+					!= ((i & 0x1) ? EAVL_OK : EAVL_NOTFOUND)
+				)
+			{
+			printf("ERROR: Version find: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLc_Version_Publish(&ver, &rcontext[0], &Vrelease)) != EAVL_ERROR_CONTEXT)
+		{
+		printf("ERROR: Version_Publish foreign: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Unpin both, then retire the last published version */
+	for (j=0; j<2; j++)
+		{
+		if ((error = EAVLc_Clear(&rcontext[j], &Vrelease)) != EAVL_OK
+				|| (error = EAVLc_Context_Disassociate(&rcontext[j])) != EAVL_OK
+				)
+			{
+			printf("ERROR: Version unpin: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		destroy_cbData((cbData_t*)rcontext[j].common.cbdata);
+		}
+
+	if ((error = EAVLc_Clear(&wcontext, &Vrelease)) != EAVL_OK
+			|| (error = EAVLc_Version_Publish(&ver, &wcontext, &Vrelease)) != EAVL_OK
+			|| (error = EAVLc_Context_Disassociate(&wcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Version retire: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	destroy_cbData((cbData_t*)wcontext.common.cbdata);
+
+	if (vcopies)
+		{
+		printf("ERROR: Version copies leaked: %u\n", vcopies);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void epoch(
+		unsigned int		count
+		)
+	{
+	EAVLc_version_t		ver;
+	EAVLc_context_t		wcontext;
+	EAVLc_epoch_reader_t	reader;
+	EAVLc_tree_t		view;
+	EAVLc_context_t		rcontext;
+	EAVLc_node_t*		dummy;
+	unsigned int		retired;
+	unsigned int		copies;
+	unsigned int		i;
+	unsigned int		j;
+	int			error;
+
+	/* The version test covers a library built without atomics */
+	if (!EAVLc_Atomics_Available)
+		{
+		return;
+		}
+
+	vcopies = 0;
+	vretired = 0;
+	if ((error = EAVLc_Epoch_Init(&vepoch)) != EAVL_OK
+			|| (error = EAVLc_Epoch_Register(&vepoch, &reader)) != EAVL_OK
+			|| (error = EAVLc_Version_Init(&ver, &vcbset)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&wcontext, &cb_pathe, create_cbData())) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&wcontext, &ver.tree)) != EAVL_OK
+			|| (error = EAVLc_Load(&wcontext, count, nodep)) != EAVL_OK
+			|| (error = EAVLc_Version_Publish(&ver, &wcontext, &Vretire)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&rcontext, &cb_pathe, create_cbData())) != EAVL_OK
+			)
+		{
+		printf("ERROR: Epoch setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Remove the even nodes, then the rest, with a reader on each version */
+	for (j=0; j<2; j++)
+		{
+		if ((error = EAVLc_Epoch_Enter(&vepoch, &reader)) != EAVL_OK
+				|| (error = EAVLc_Version_Read(&ver, &view)) != EAVL_OK
+				|| (error = EAVLc_Context_Associate(&rcontext, &view)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Epoch read: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		for (i=j; i<count; i+=2)
+			{
+			if ((error = EAVLc_Find(&wcontext, EAVL_FIND_EQ, NULL, NULL, nodep[i], &dummy)) != EAVL_OK
+					|| (error = EAVLc_Remove(&wcontext, &dummy)) != EAVL_OK
+					)
+				{
+				printf("ERROR: Epoch remove: %d\n", error);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+			(void) Vrelease(dummy, NULL);
+			}
+
+		retired = vretired;
+		copies = vcopies;
+		if ((error = EAVLc_Version_Publish(&ver, &wcontext, &Vretire)) != EAVL_OK
+				|| (j < count && vretired == retired)
+				|| vcopies != copies
+				)
+			{
+			printf("ERROR: Epoch publish: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		/* One advance is allowed; the next waits for the reader */
+		if ((error = EAVLc_Epoch_Reclaim(&vepoch, &Vrelease, NULL)) != EAVL_OK
+				|| (error = EAVLc_Epoch_Reclaim(&vepoch, &Vrelease, NULL)) != EAVL_NOTFOUND
+				|| vcopies != copies
+				)
+			{
+			printf("ERROR: Epoch reclaim early: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		for (i=j; i<count; i+=1+j)
+			{
+			if (EAVLc_Find(&rcontext, EAVL_FIND_EQ, NULL, NULL, nodep[i], &dummy) != EAVL_OK)
+				{
+				printf("ERROR: Epoch find: %u\n", i);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+			}
+
+		if ((error = EAVLc_Context_Disassociate(&rcontext)) != EAVL_OK
+				|| (error = EAVLc_Epoch_Leave(&reader)) != EAVL_OK
+				|| (error = EAVLc_Epoch_Reclaim(&vepoch, &Vrelease, NULL)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Epoch leave: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	/* The copies made for the first version were released by the second */
+	if (count > 2 && vcopies >= copies)
+		{
+		printf("ERROR: Epoch not reclaimed: %u  %u\n", vcopies, copies);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<3; i++)
+		{
+		(void) EAVLc_Epoch_Reclaim(&vepoch, &Vrelease, NULL);
+		}
+	if (EAVLc_TREE_ROOT(&ver.tree) || vcopies)
+		{
+		printf("ERROR: Epoch copies leaked: %u\n", vcopies);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLc_Epoch_Unregister(&vepoch, &reader)) != EAVL_OK
+			|| (error = EAVLc_Epoch_Unregister(&vepoch, &reader)) != EAVL_NOTFOUND
+			)
+		{
+		printf("ERROR: Epoch_Unregister: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	(void) EAVLc_Context_Disassociate(&wcontext);
+	destroy_cbData((cbData_t*)wcontext.common.cbdata);
+	destroy_cbData((cbData_t*)rcontext.common.cbdata);
+	}
+
+
+void parallel(
+		unsigned int		count
+		)
+	{
+	EAVLc_tree_t		ptree;
+	EAVLc_context_t		pcontext;
+	EAVL_dir_t		dir;
+	EAVL_order_t		order;
+	unsigned int		threads;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLc_Tree_Init(&ptree, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&pcontext, &cb_pathe, create_cbData())) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&pcontext, &ptree)) != EAVL_OK
+			|| (error = EAVLc_Load(&pcontext, count, nodep)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Parallel setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	pstopwith = EAVL_CB_OK;
+	for (threads=1; threads<=16; threads*=4)
+		{
+		for (order=EAVL_ORDER_PRE; order<=EAVL_ORDER_POST; order++)
+			{
+			for (dir=LEFT; dir<=RIGHT; dir++)
+				{
+				pvisits = 0;
+				if ((error = EAVLc_Traverse_Parallel(&pcontext, dir, order, threads, &Pvisit, &Prun)) != EAVL_OK
+						|| pvisits != count
+						)
+					{
+					printf("ERROR: Traverse_Parallel: %d  %u  %u  %u\n", error, threads, order, dir);
+					printf("\t%s:%u\n", __FILE__, __LINE__);
+					exit(1);
+					}
+
+				check_reset(count, 0);
+				for (i=0; i<count; i++)
+					{
+					member[container_of(pvisited[i], struct node, node) - nodes]++;
+
+					/* Pieces are taken in order */
+					if (order == EAVL_ORDER_IN
+							&& pvisited[i] != nodep[(dir == RIGHT) ? i : count-1-i]
+							)
+						{
+						printf("ERROR: Traverse_Parallel order: %u  %u  %u\n", threads, dir, i);
+						printf("\t%s:%u\n", __FILE__, __LINE__);
+						exit(1);
+						}
+					}
+				for (i=0; i<count; i++)
+					{
+					if (member[i] != 1)
+						{
+						printf("ERROR: Traverse_Parallel visits: %u  %u  %u\n", threads, order, i);
+						printf("\t%s:%u\n", __FILE__, __LINE__);
+						exit(1);
+						}
+					}
+				}
+			}
+		}
+
+	/* Finishing early, and failing, stop the remaining pieces */
+	pvisits = 0;
+	pstop = (count+1)/2;
+	pstopwith = EAVL_CB_FINISHED;
+	if ((error = EAVLc_Traverse_Parallel(&pcontext, RIGHT, EAVL_ORDER_IN, 4, &Pvisit, &Prun)) != EAVL_OK
+			|| pvisits != pstop
+			)
+		{
+		printf("ERROR: Traverse_Parallel finished: %d  %u\n", error, pvisits);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	pvisits = 0;
+	pstopwith = EAVL_CB_ERROR;
+	if ((error = EAVLc_Traverse_Parallel(&pcontext, LEFT, EAVL_ORDER_PRE, 4, &Pvisit, NULL)) != EAVL_ERROR_CALLBACK
+			|| pvisits != pstop
+			)
+		{
+		printf("ERROR: Traverse_Parallel error: %d  %u\n", error, pvisits);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	pstop = 0;
+
+	if ((error = EAVLc_Clear(&pcontext, &Node_release)) != EAVL_OK
+			|| (error = EAVLc_Context_Disassociate(&pcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Parallel cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	destroy_cbData((cbData_t*)pcontext.common.cbdata);
+	}
+
+
+void verify(
+		unsigned int		count
+		)
+	{
+	EAVLc_tree_t		vtree;
+	EAVLc_context_t		vcontext;
+	EAVLc_node_t*		path[EAVL_HEIGHT_MAX];
+	EAVLc_node_t*		ppath[EAVL_HEIGHT_MAX];
+	EAVLc_node_t*		node;
+	struct node*		leaf;
+	unsigned int		pathlen;
+	unsigned int		ppathlen;
+	unsigned int		depth;
+	unsigned int		val;
+	unsigned int		threads;
+	unsigned int		i;
+	int			error;
+	int			perror;
+
+	if ((error = EAVLc_Tree_Init(&vtree, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&vcontext, &cb_pathe, create_cbData())) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&vcontext, &vtree)) != EAVL_OK
+			|| (error = EAVLc_Load(&vcontext, count, nodep)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Verify setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (threads=1; threads<=16; threads*=4)
+		{
+		if ((error = EAVLc_Verify(&vcontext, threads, &Prun, path, &pathlen)) != EAVL_OK)
+			{
+			printf("ERROR: Verify: %d  %u\n", error, threads);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if (count < 2)
+		{
+		goto out;
+		}
+
+	/* A bad node deep in the tree is reported with its path */
+	node = EAVLc_TREE_ROOT(&vtree);
+	for (depth=1; EAVLc_GET_CHILD(node, LEFT) || EAVLc_GET_CHILD(node, RIGHT); depth++)
+		{
+		node = EAVLc_GET_CHILD(node, LEFT)
+				? EAVLc_GET_CHILD(node, LEFT)
+				: EAVLc_GET_CHILD(node, RIGHT)
+				;
+		}
+	leaf = container_of(node, struct node, node);
+
+	leaf->height++;
+	error = EAVLc_Verify(&vcontext, 1, NULL, path, &pathlen);
+	perror = EAVLc_Verify(&vcontext, 16, &Prun, ppath, &ppathlen);
+	leaf->height--;
+	if (error != EAVL_ERROR_CALLBACK || perror != error
+			|| pathlen != depth || ppathlen != depth
+			|| path[0] != EAVLc_TREE_ROOT(&vtree)
+			|| path[depth-1] != node
+			)
+		{
+		printf("ERROR: Verify verify: %d  %d  %u  %u  %u\n", error, perror, pathlen, ppathlen, depth);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	for (i=0; i<depth; i++)
+		{
+		if (path[i] != ppath[i])
+			{
+			printf("ERROR: Verify path: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	/* Out of order keys */
+	val = nodes[0].val;
+	nodes[0].val = nodes[count-1].val;
+	nodes[count-1].val = val;
+	error = EAVLc_Verify(&vcontext, 1, NULL, path, &pathlen);
+	perror = EAVLc_Verify(&vcontext, 16, &Prun, ppath, &ppathlen);
+	nodes[count-1].val = nodes[0].val;
+	nodes[0].val = val;
+	if (error != EAVL_ERROR_COMPARE || perror != error
+			|| pathlen != ppathlen || !pathlen
+			|| path[0] != EAVLc_TREE_ROOT(&vtree)
+			)
+		{
+		printf("ERROR: Verify compare: %d  %d  %u  %u\n", error, perror, pathlen, ppathlen);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	for (i=0; i<pathlen; i++)
+		{
+		if (path[i] != ppath[i])
+			{
+			printf("ERROR: Verify compare path: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLc_Verify(&vcontext, 16, &Prun, NULL, NULL)) != EAVL_OK)
+		{
+		printf("ERROR: Verify restored: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+out:
+	if ((error = EAVLc_Clear(&vcontext, &Node_release)) != EAVL_OK
+			|| (error = EAVLc_Context_Disassociate(&vcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Verify cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	destroy_cbData((cbData_t*)vcontext.common.cbdata);
+	}
+
+
+void fixup_all(
+		unsigned int		count
+		)
+	{
+	EAVLc_tree_t		ftree;
+	EAVLc_context_t		fcontext;
+	EAVLc_node_t*		path[EAVL_HEIGHT_MAX];
+	unsigned int		pathlen;
+	unsigned int		threads;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLc_Tree_Init(&ftree, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&fcontext, &cb_pathe, create_cbData())) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&fcontext, &ftree)) != EAVL_OK
+			|| (error = EAVLc_Load(&fcontext, count, nodep)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Fixup_All setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (threads=0; threads<=16; threads=(threads) ? threads*4 : 1)
+		{
+		/* Wreck every node's fixup data; Fixup_All must rebuild it */
+		for (i=0; i<count; i++)
+			{
+			nodes[i].height = 0;
+			nodes[i].weight = 0;
+			nodes[i].sum = 0;
+			}
+
+		error = EAVLc_Verify(&fcontext, 1, NULL, path, &pathlen);
+		if ((count && error != EAVL_ERROR_CALLBACK)
+				|| (!count && error != EAVL_OK)
+				)
+			{
+			printf("ERROR: Fixup_All verify: %d  %u\n", error, threads);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		if ((error = EAVLc_Fixup_All(&fcontext, threads, (threads) ? &Prun : NULL)) != EAVL_OK
+				|| (error = EAVLc_Verify(&fcontext, 1, NULL, path, &pathlen)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Fixup_All: %d  %u\n", error, threads);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLc_Clear(&fcontext, &Node_release)) != EAVL_OK
+			|| (error = EAVLc_Context_Disassociate(&fcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Fixup_All cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	destroy_cbData((cbData_t*)fcontext.common.cbdata);
+	}
+
+
 int main(
 		int			argc,
 		char**			argv
@@ -1195,6 +2012,30 @@ int main(
 		check_op(&context, k, &Eremove, EAVL_OK, "Insert-Remove remove", 0);
 		}
 
+//  serialize
+	printf("\n== serialize\n");
+	reshape(&tree, &context, count);
+
+//  version
+	printf("\n== version\n");
+	version(count);
+
+//  epoch
+	printf("\n== epoch\n");
+	epoch(count);
+
+//  parallel
+	printf("\n== parallel\n");
+	parallel(count);
+
+//  verify
+	printf("\n== verify\n");
+	verify(count);
+
+//  fixup_all
+	printf("\n== fixup_all\n");
+	fixup_all(count);
+
 //  random
 	printf("\n== Random\n");
 	init_tree_context(&tree, &context);
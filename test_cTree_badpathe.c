@@ -641,7 +641,8 @@ EAVLc_cbset_t cbset =
 		&Node_CMP,
 		&Ndup,
 		&Node_fixup,
-		&Node_verify
+		&Node_verify,
+		&Node_release
 		};
 
 
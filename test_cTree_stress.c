@@ -230,6 +230,7 @@ struct master_track
 		(MASTER)->cbset.dup	= NULL;				\
 		(MASTER)->cbset.fixup	= NULL;				\
 		(MASTER)->cbset.verify	= NULL;				\
+		(MASTER)->cbset.release	= NULL;				\
 		TREE_TRACK_CLEAR(&(MASTER)->tracker[0]);		\
 		TREE_TRACK_CLEAR(&(MASTER)->tracker[1]);		\
 		} while (0)
@@ -1538,6 +1539,7 @@ static master_track_t* create_mtrack(
 	mtrack->cbset.dup	= &ecb_dup;
 	mtrack->cbset.fixup	= &ecb_fixup;
 	mtrack->cbset.verify	= &ecb_verify;
+	mtrack->cbset.release	= &ecb_release;
 
 	mtrack->tracker[0].tracker = mtrack;
 	mtrack->tracker[1].tracker = mtrack;
@@ -1611,6 +1613,18 @@ static master_track_t* create_mtrack(
 	}
 
 
+#define TESTED_EAVLc_CALL(ERROR, FUNCT, ...)				\
+	do								\
+		{							\
+		if (EAVL_OK != ((ERROR) = EAVLc_ ## FUNCT (__VA_ARGS__)))	\
+			{						\
+			printf("ERROR: " #FUNCT ": %d\n", (ERROR));	\
+			printf("\t%s:%u\n", __FILE__, __LINE__);	\
+			return FAILURE;					\
+			}						\
+		} while (0)
+
+
 static int check_tree_track(
 		master_track_t*		mtrack,
 		tree_track_t*		tracker,
@@ -1692,6 +1706,69 @@ static int check_tree_track(
 	}
 
 
+static int check_usage(
+		master_track_t*		mtrack
+		)
+	{
+	EAVLc_usage_t		usage[2];
+	uintptr_t		lower;
+	unsigned int		i;
+	int			error;
+
+	for (i=0; i<2; i++)
+		{
+		TESTED_EAVLc_CALL(error, Usage, &mtrack->tracker[i].context, 0, &usage[i]);
+		lower = usage[i].unique;
+
+		do
+			{
+			error = EAVLc_Usage(&mtrack->tracker[i].context, 1, &usage[i]);
+			} while (error == EAVL_CALLBACK);
+		if (error != EAVL_OK)
+			{
+			printf("ERROR: Usage: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			return FAILURE;
+			}
+
+		if (usage[i].nodes != mtrack->tracker[i].count
+				|| usage[i].unique < lower
+				|| usage[i].unique + usage[i].shared != usage[i].nodes
+				)
+			{
+			printf("ERROR: usage[%u] nodes: %lu  unique: %lu (>= %lu)  shared: %lu  count: %u\n",
+					i,
+					(unsigned long)usage[i].nodes,
+					(unsigned long)usage[i].unique,
+					(unsigned long)lower,
+					(unsigned long)usage[i].shared,
+					mtrack->tracker[i].count
+					);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			return FAILURE;
+			}
+		}
+
+	/* With two trees every shared node is in both */
+	if (usage[0].shared != usage[1].shared
+			|| usage[0].unique + usage[1].unique + usage[0].shared != mtrack->total
+			)
+		{
+		printf("ERROR: usage shared: %lu/%lu  unique: %lu/%lu  total: %u\n",
+				(unsigned long)usage[0].shared,
+				(unsigned long)usage[1].shared,
+				(unsigned long)usage[0].unique,
+				(unsigned long)usage[1].unique,
+				mtrack->total
+				);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		return FAILURE;
+		}
+
+	return SUCCESS;
+	}
+
+
 static int check_mtrack(
 		master_track_t*		mtrack,
 		params_t*		params
@@ -1699,6 +1776,7 @@ static int check_mtrack(
 	{
 	if (check_tree_track(mtrack, &mtrack->tracker[0], params) != SUCCESS
 			|| check_tree_track(mtrack, &mtrack->tracker[1], params) != SUCCESS
+			|| check_usage(mtrack) != SUCCESS
 			)
 		{
 		return FAILURE;
@@ -1778,18 +1856,6 @@ static int check_shadow(
 		} while (0)
 
 
-#define TESTED_EAVLc_CALL(ERROR, FUNCT, ...)				\
-	do								\
-		{							\
-		if (EAVL_OK != ((ERROR) = EAVLc_ ## FUNCT (__VA_ARGS__)))	\
-			{						\
-			printf("ERROR: " #FUNCT ": %d\n", (ERROR));	\
-			printf("\t%s:%u\n", __FILE__, __LINE__);	\
-			return FAILURE;					\
-			}						\
-		} while (0)
-
-
 static int test_reshadow(
 		master_track_t*		mtrack,
 		unsigned int		active,
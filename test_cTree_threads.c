@@ -0,0 +1,761 @@
+/*
+**
+*/
+
+
+#define _XOPEN_SOURCE 1000
+
+
+#include "EAVL_cTree.h"
+#include "container_of.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+
+#ifndef UNUSED
+#define UNUSED(var)	var = var
+#endif	/* UNUSED */
+
+
+#define NODES		65537
+#define ROUNDS		64
+#define READERS		4
+#define PUBLISHES	2000
+
+
+struct tnode
+	{
+	unsigned int		val;
+	EAVLc_node_t		node;
+	};
+
+typedef struct
+	{
+	EAVLc_pathelement_t	elements[EAVL_PATHE_VECTOR_SIZE];
+	} tpathe_t;
+
+
+uintptr_t		live;		/* Allocated tnodes		*/
+EAVLc_epoch_t		tepoch;
+pthread_mutex_t		unregister = PTHREAD_MUTEX_INITIALIZER;
+
+
+EAVL_dir_t Tcompare(void* ref_value, EAVLc_node_t* ref_node, EAVLc_node_t* node, void* data);
+void snapshot(unsigned int count);
+void versions(unsigned int count);
+void epochs(unsigned int count);
+
+
+static EAVLc_pathelement_t* Tpathe(
+		unsigned int		index,
+		unsigned int		param,
+		void*			data
+		)
+	{
+	tpathe_t*		pathe = data;
+
+	if (index == -1u)	// truncate
+		{
+		return NULL;
+		}
+
+	if (param != 0)		// shift down 1
+		{
+		memmove(
+				&pathe->elements[index-1],
+				&pathe->elements[index],
+				sizeof(EAVLc_pathelement_t)*(param-index+1)
+				);
+		return NULL;
+		}
+
+	return (index < EAVL_PATHE_VECTOR_SIZE) ? &pathe->elements[index] : NULL;
+	}
+
+
+static struct tnode* Talloc(
+		unsigned int		val
+		)
+	{
+	struct tnode*		tnode;
+
+	if (!(tnode = (struct tnode*)malloc(sizeof(struct tnode))))
+		{
+		printf("ERROR: Out of memory\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	tnode->val = val;
+	(void) __atomic_fetch_add(&live, 1, __ATOMIC_RELAXED);
+
+	return tnode;
+	}
+
+
+EAVL_dir_t Tcompare(
+		void*			ref_value,
+		EAVLc_node_t*		ref_node,
+		EAVLc_node_t*		node,
+		void*			data
+		)
+	{
+	unsigned int		val = container_of(node, struct tnode, node)->val;
+	unsigned int		ref;
+
+	UNUSED(data);
+
+	ref = (ref_node)
+			? container_of(ref_node, struct tnode, node)->val
+			: *(unsigned int*)ref_value
+			;
+
+	return (val == ref) ? EAVL_CMP_SAME : (val < ref) ? EAVL_CMP_LEFT : EAVL_CMP_RIGHT;
+	}
+
+
+static EAVLc_node_t* Tdup(
+		EAVLc_node_t*		node,
+		void*			data
+		)
+	{
+	UNUSED(data);
+
+	return &Talloc(container_of(node, struct tnode, node)->val)->node;
+	}
+
+
+static int Trelease(
+		EAVLc_node_t*		node,
+		void*			data
+		)
+	{
+	UNUSED(data);
+
+	free(container_of(node, struct tnode, node));
+	(void) __atomic_fetch_sub(&live, 1, __ATOMIC_RELAXED);
+
+	return EAVL_CB_OK;
+	}
+
+
+EAVLc_cbset_t tcbset =
+		{
+		&Tcompare,
+		&Tdup,
+		NULL,
+		NULL,
+		&Trelease
+		};
+
+
+static void Tinsert(
+		EAVLc_context_t*	context,
+		unsigned int		val
+		)
+	{
+	EAVLc_node_t*		dummy;
+	int			error;
+
+	if ((error = EAVLc_Insert(context, &Talloc(val)->node, &dummy)) != EAVL_OK)
+		{
+		printf("ERROR: Insert: %d  %u\n", error, val);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+static void Tremove(
+		EAVLc_context_t*	context,
+		unsigned int		val
+		)
+	{
+	EAVLc_node_t*		node;
+	int			error;
+
+	if ((error = EAVLc_Find(context, EAVL_FIND_EQ, NULL, &val, NULL, &node)) != EAVL_OK
+			|| (error = EAVLc_Remove(context, &node)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Remove: %d  %u\n", error, val);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	(void) Trelease(node, NULL);
+	}
+
+
+typedef struct
+	{
+	EAVLc_tree_t		tree;
+	unsigned char*		present;
+	unsigned int		count;
+	int			error;
+	}			snapjob_t;
+
+
+static void* snapshot_release(
+		void*			data
+		)
+	{
+	snapjob_t*		job = data;
+	EAVLc_context_t		context;
+	EAVLc_node_t*		dummy;
+	tpathe_t		pathe;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLc_Context_Init(&context, &Tpathe, &pathe)) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&context, &job->tree)) != EAVL_OK
+			)
+		{
+		job->error = error;
+		return NULL;
+		}
+
+	for (i=0; i<job->count; i++)
+		{
+		if (EAVLc_Find(&context, EAVL_FIND_EQ, NULL, &i, NULL, &dummy)
+				!= ((job->present[i]) ? EAVL_OK : EAVL_NOTFOUND)
+				)
+			{
+			job->error = EAVL_ERROR_TREE;
+			break;
+			}
+		}
+
+	if ((error = EAVLc_Clear(&context, &Trelease)) != EAVL_OK
+			|| (error = EAVLc_Context_Disassociate(&context)) != EAVL_OK
+			)
+		{
+		job->error = error;
+		}
+
+	return NULL;
+	}
+
+
+void snapshot(
+		unsigned int		count
+		)
+	{
+	EAVLc_tree_t		tree;
+	EAVLc_context_t		context;
+	tpathe_t		pathe;
+	snapjob_t		job;
+	pthread_t		thread;
+	unsigned char*		present;
+	unsigned int		round;
+	unsigned int		i;
+	int			error;
+
+	if (!(present = (unsigned char*)malloc(count)) || !(job.present = (unsigned char*)malloc(count)))
+		{
+		printf("ERROR: Out of memory\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLc_Tree_Init(&tree, NULL, &tcbset)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&context, &Tpathe, &pathe)) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&context, &tree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Snapshot setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		Tinsert(&context, i);
+		present[i] = 1;
+		}
+
+	/* Each snapshot is searched and released while the writer changes */
+	for (round=0; round<ROUNDS; round++)
+		{
+		if ((error = EAVLc_Tree_Init(&job.tree, &tree, NULL)) != EAVL_OK)
+			{
+			printf("ERROR: Snapshot fork: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		memcpy(job.present, present, count);
+		job.count = count;
+		job.error = EAVL_OK;
+
+		if (pthread_create(&thread, NULL, &snapshot_release, &job))
+			{
+			printf("ERROR: Snapshot thread\n");
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		for (i=round%3; i<count; i+=3)
+			{
+			if (present[i])
+				{
+				Tremove(&context, i);
+				}
+			else
+				{
+				Tinsert(&context, i);
+				}
+			present[i] = !present[i];
+			}
+
+		if (pthread_join(thread, NULL) || job.error != EAVL_OK)
+			{
+			printf("ERROR: Snapshot release: %d  %u\n", job.error, round);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLc_Verify(&context, 1, NULL, NULL, NULL)) != EAVL_OK
+			|| (error = EAVLc_Clear(&context, &Trelease)) != EAVL_OK
+			|| (error = EAVLc_Context_Disassociate(&context)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Snapshot cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if (__atomic_load_n(&live, __ATOMIC_RELAXED))
+		{
+		printf("ERROR: Snapshot nodes leaked: %lu\n", (unsigned long)live);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	free(job.present);
+	free(present);
+	}
+
+
+/*
+** Every published version holds COUNT consecutive values; a version seen
+** with other contents was released while the reader was still using it.
+*/
+static int Twindow(
+		EAVLc_context_t*	context,
+		unsigned int		count
+		)
+	{
+	EAVLc_node_t*		node;
+	unsigned int		val = 0;
+	unsigned int		seen = 0;
+	int			error;
+
+	error = EAVLc_First(context, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node);
+	if (error == EAVL_OK)
+		{
+		val = container_of(node, struct tnode, node)->val;
+		}
+	while (error == EAVL_OK
+			&& container_of(node, struct tnode, node)->val == val + seen
+			)
+		{
+		seen++;
+		error = EAVLc_Next(context, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node);
+		}
+
+	if (error != EAVL_NOTFOUND || seen != count || context->tree->count != count)
+		{
+		return (error == EAVL_OK || error == EAVL_NOTFOUND) ? EAVL_ERROR_TREE : error;
+		}
+
+	return EAVL_OK;
+	}
+
+
+typedef struct
+	{
+	EAVLc_version_t*	version;
+	unsigned int		count;
+	uintptr_t*		stop;
+	uintptr_t		pins;
+	int			error;
+	}			pinjob_t;
+
+
+static void* version_pin(
+		void*			data
+		)
+	{
+	pinjob_t*		job = data;
+	EAVLc_tree_t		tree;
+	EAVLc_context_t		context;
+	tpathe_t		pathe;
+	int			error;
+
+	while (!__atomic_load_n(job->stop, __ATOMIC_ACQUIRE))
+		{
+		if ((error = EAVLc_Version_Pin(job->version, &tree)) != EAVL_OK
+				|| (error = EAVLc_Context_Init(&context, &Tpathe, &pathe)) != EAVL_OK
+				|| (error = EAVLc_Context_Associate(&context, &tree)) != EAVL_OK
+				)
+			{
+			job->error = error;
+			return NULL;
+			}
+
+		job->error = Twindow(&context, job->count);
+
+		if ((error = EAVLc_Clear(&context, &Trelease)) != EAVL_OK
+				|| (error = EAVLc_Context_Disassociate(&context)) != EAVL_OK
+				|| (error = EAVLc_Release(&tree)) != EAVL_OK
+				)
+			{
+			job->error = error;
+			}
+
+		if (job->error != EAVL_OK)
+			{
+			return NULL;
+			}
+		job->pins++;
+		}
+
+	return NULL;
+	}
+
+
+void versions(
+		unsigned int		count
+		)
+	{
+	EAVLc_version_t		version;
+	EAVLc_context_t		context;
+	tpathe_t		pathe;
+	pinjob_t		jobs[READERS];
+	pthread_t		threads[READERS];
+	uintptr_t		stop = 0;
+	unsigned int		publish;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLc_Version_Init(&version, &tcbset)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&context, &Tpathe, &pathe)) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&context, &version.tree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Versions setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		Tinsert(&context, i);
+		}
+
+	if ((error = EAVLc_Version_Publish(&version, &context, &Trelease)) != EAVL_OK)
+		{
+		printf("ERROR: Versions publish: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<READERS; i++)
+		{
+		jobs[i].version = &version;
+		jobs[i].count = count;
+		jobs[i].stop = &stop;
+		jobs[i].pins = 0;
+		jobs[i].error = EAVL_OK;
+		if (pthread_create(&threads[i], NULL, &version_pin, &jobs[i]))
+			{
+			printf("ERROR: Versions thread\n");
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	/* Slide the window of values up by one for each publication */
+	for (publish=0; publish<PUBLISHES; publish++)
+		{
+		Tremove(&context, publish);
+		Tinsert(&context, publish + count);
+
+		if ((error = EAVLc_Version_Publish(&version, &context, &Trelease)) != EAVL_OK)
+			{
+			printf("ERROR: Versions publish: %d  %u\n", error, publish);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	__atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+	for (i=0; i<READERS; i++)
+		{
+		if (pthread_join(threads[i], NULL) || jobs[i].error != EAVL_OK)
+			{
+			printf("ERROR: Versions pin: %d  %u  %lu\n", jobs[i].error, i, (unsigned long)jobs[i].pins);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLc_Clear(&context, &Trelease)) != EAVL_OK
+			|| (error = EAVLc_Version_Publish(&version, &context, &Trelease)) != EAVL_OK
+			|| (error = EAVLc_Context_Disassociate(&context)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Versions cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if (__atomic_load_n(&live, __ATOMIC_RELAXED))
+		{
+		printf("ERROR: Versions nodes leaked: %lu\n", (unsigned long)live);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+static int Tretire(
+		EAVLc_node_t*		node,
+		void*			data
+		)
+	{
+	UNUSED(data);
+
+	return (EAVLc_Epoch_Retire(&tepoch, node) == EAVL_OK)
+			? EAVL_CB_OK
+			: EAVL_CB_ERROR
+			;
+	}
+
+
+typedef struct
+	{
+	EAVLc_version_t*	version;
+	unsigned int		count;
+	uintptr_t*		stop;
+	uintptr_t		reads;
+	int			error;
+	}			readjob_t;
+
+
+static void* epoch_read(
+		void*			data
+		)
+	{
+	readjob_t*		job = data;
+	EAVLc_epoch_reader_t	reader;
+	EAVLc_tree_t		view;
+	EAVLc_context_t		context;
+	tpathe_t		pathe;
+	int			error;
+
+	if ((error = EAVLc_Epoch_Register(&tepoch, &reader)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&context, &Tpathe, &pathe)) != EAVL_OK
+			)
+		{
+		job->error = error;
+		return NULL;
+		}
+
+	while (!__atomic_load_n(job->stop, __ATOMIC_ACQUIRE) && job->error == EAVL_OK)
+		{
+		if ((error = EAVLc_Epoch_Enter(&tepoch, &reader)) != EAVL_OK
+				|| (error = EAVLc_Version_Read(job->version, &view)) != EAVL_OK
+				|| (error = EAVLc_Context_Associate(&context, &view)) != EAVL_OK
+				)
+			{
+			job->error = error;
+			break;
+			}
+
+		job->error = Twindow(&context, job->count);
+
+		if ((error = EAVLc_Context_Disassociate(&context)) != EAVL_OK
+				|| (error = EAVLc_Epoch_Leave(&reader)) != EAVL_OK
+				)
+			{
+			job->error = error;
+			}
+		job->reads++;
+		}
+
+	/* Stopping is after the writer's last reclaim; readers unlink in turn */
+	pthread_mutex_lock(&unregister);
+	if ((error = EAVLc_Epoch_Unregister(&tepoch, &reader)) != EAVL_OK)
+		{
+		job->error = error;
+		}
+	pthread_mutex_unlock(&unregister);
+
+	return NULL;
+	}
+
+
+void epochs(
+		unsigned int		count
+		)
+	{
+	EAVLc_version_t		version;
+	EAVLc_context_t		context;
+	tpathe_t		pathe;
+	readjob_t		jobs[READERS];
+	pthread_t		threads[READERS];
+	uintptr_t		stop = 0;
+	unsigned int		publish;
+	unsigned int		reclaims = 0;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLc_Epoch_Init(&tepoch)) != EAVL_OK
+			|| (error = EAVLc_Version_Init(&version, &tcbset)) != EAVL_OK
+			|| (error = EAVLc_Context_Init(&context, &Tpathe, &pathe)) != EAVL_OK
+			|| (error = EAVLc_Context_Associate(&context, &version.tree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Epochs setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		Tinsert(&context, i);
+		}
+
+	if ((error = EAVLc_Version_Publish(&version, &context, &Tretire)) != EAVL_OK)
+		{
+		printf("ERROR: Epochs publish: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<READERS; i++)
+		{
+		jobs[i].version = &version;
+		jobs[i].count = count;
+		jobs[i].stop = &stop;
+		jobs[i].reads = 0;
+		jobs[i].error = EAVL_OK;
+		if (pthread_create(&threads[i], NULL, &epoch_read, &jobs[i]))
+			{
+			printf("ERROR: Epochs thread\n");
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	/* Retired nodes are only released once no reader can still see them */
+	for (publish=0; publish<PUBLISHES; publish++)
+		{
+		Tremove(&context, publish);
+		Tinsert(&context, publish + count);
+
+		if ((error = EAVLc_Version_Publish(&version, &context, &Tretire)) != EAVL_OK)
+			{
+			printf("ERROR: Epochs publish: %d  %u\n", error, publish);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		switch (error = EAVLc_Epoch_Reclaim(&tepoch, &Trelease, NULL))
+			{
+			case EAVL_OK:
+				reclaims++;
+				break;
+
+			case EAVL_NOTFOUND:
+				break;
+
+			default:
+				printf("ERROR: Epochs reclaim: %d  %u\n", error, publish);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+			}
+		}
+
+	__atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+	for (i=0; i<READERS; i++)
+		{
+		if (pthread_join(threads[i], NULL) || jobs[i].error != EAVL_OK)
+			{
+			printf("ERROR: Epochs read: %d  %u  %lu\n", jobs[i].error, i, (unsigned long)jobs[i].reads);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLc_Clear(&context, &Trelease)) != EAVL_OK
+			|| (error = EAVLc_Version_Publish(&version, &context, &Tretire)) != EAVL_OK
+			|| (error = EAVLc_Context_Disassociate(&context)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Epochs cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<3; i++)
+		{
+		if ((error = EAVLc_Epoch_Reclaim(&tepoch, &Trelease, NULL)) != EAVL_OK)
+			{
+			printf("ERROR: Epochs final reclaim: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if (!reclaims || __atomic_load_n(&live, __ATOMIC_RELAXED))
+		{
+		printf("ERROR: Epochs nodes leaked: %u  %lu\n", reclaims, (unsigned long)live);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+int main(
+		int			argc,
+		char**			argv
+		)
+	{
+	unsigned int		count = 0;
+
+	if (argc > 1)
+		{
+		count = (unsigned int)strtol(argv[1], NULL, 10);
+		}
+
+	if (!(1 <= count && count <= NODES))
+		{
+		exit(1);
+		}
+
+	if (!EAVLc_Atomics_Available)
+		{
+		printf("ERROR: Library built without atomics\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+//  snapshot
+	printf("\n== snapshot\n");
+	snapshot(count);
+
+//  versions
+	printf("\n== versions\n");
+	versions(count);
+
+//  epochs
+	printf("\n== epochs\n");
+	epochs(count);
+
+	return 0;
+	}
@@ -80,6 +80,22 @@ int insert(EAVLp_context_t* context, unsigned int k);
 int Eremove(EAVLp_context_t* context, unsigned int k);
 int Nfixup(EAVLp_context_t* context, unsigned int k);
 int traverse(EAVLp_context_t* context, EAVL_dir_t dir, EAVL_order_t order);
+void reshape(EAVLp_tree_t* tree, EAVLp_context_t* context, unsigned int count);
+void seq(unsigned int count);
+void shards_check(EAVLp_shards_t* shards, unsigned int count, unsigned int present);
+void shards(unsigned int count);
+void combiner(unsigned int count);
+void sampled(unsigned int count);
+void pathcheck(unsigned int count);
+void treechecks(unsigned int count);
+void generation(unsigned int count);
+void cursor(unsigned int count);
+int Deferred_fixup(EAVLp_node_t* eavl_node, EAVLp_node_t* childL, EAVLp_node_t* childR, void* data);
+void deferred(unsigned int count);
+EAVL_dir_t Aug_CMP(void* ref_value, EAVLp_node_t* ref_node, EAVLp_node_t* node, void* data);
+void aug(unsigned int count);
+int Interval_visit(EAVLp_node_t* node, void* data);
+void intervals(unsigned int count);
 
 
 void check_reset(
@@ -663,6 +679,1303 @@ int traverse(
 	}
 
 
+void reshape(
+		EAVLp_tree_t*		tree,
+		EAVLp_context_t*	context,
+		unsigned int		count
+		)
+	{
+	static EAVLp_node_t*	snodep[NODES];
+	static unsigned char	shape[2][EAVL_SHAPE_SIZE(NODES)];
+	unsigned int		scount;
+	unsigned int		i;
+	unsigned int		k;
+	int			error;
+
+	/* An irregular shape that Load would not produce */
+	init_tree_context(tree, context);
+	check_reset(count, 0);
+	srandom(3);
+	for (i=0; i<count; i++)
+		{
+		k = (unsigned int)random()%count;
+		if (!member[k])
+			{
+			check_op(context, k, &insert, EAVL_OK, "Reshape insert", 1);
+			}
+		}
+
+	scount = NODES;
+	if ((error = EAVLp_Serialize(context, &scount, snodep, shape[0])) != EAVL_OK)
+		{
+		printf("ERROR: Serialize: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0, k=0; i<count; i++)
+		{
+		if (member[i] && snodep[k++] != nodep[i])
+			{
+			printf("ERROR: Serialize order: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	if (k != scount)
+		{
+		printf("ERROR: Serialize count: %u  expect: %u\n", scount, k);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Too small */
+	k = scount-1;
+	if ((error = EAVLp_Serialize(context, &k, snodep, shape[1])) != EAVL_ERROR_PARAMETER
+			|| k != scount
+			)
+		{
+		printf("ERROR: Serialize short: %d  count: %u\n", error, k);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Stored aggregates; no fixup */
+	init_tree_context(tree, context);
+	if ((error = EAVLp_Deserialize(context, scount, snodep, shape[0], 0)) != EAVL_OK)
+		{
+		printf("ERROR: Deserialize: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	if (check_tree(context))
+		{
+		printf("ERROR: Deserialize check\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	k = scount;
+	if ((error = EAVLp_Serialize(context, &k, snodep, shape[1])) != EAVL_OK
+			|| memcmp(shape[0], shape[1], EAVL_SHAPE_SIZE(scount) - (scount&1))
+			|| ((scount&1) && (shape[0][scount>>1] ^ shape[1][scount>>1]) & 0x0F)
+			)
+		{
+		printf("ERROR: Deserialize shape: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Recomputed aggregates */
+	init_tree_context(tree, context);
+	for (i=0; i<scount; i++)
+		{
+		container_of(snodep[i], struct node, node)->height = -1u;
+		}
+	if ((error = EAVLp_Deserialize(context, scount, snodep, shape[0], 1)) != EAVL_OK
+			|| check_tree(context)
+			)
+		{
+		printf("ERROR: Deserialize fixup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Inconsistent streams */
+	init_tree_context(tree, context);
+	if (scount > 1
+			&& (error = EAVLp_Deserialize(context, scount-1, snodep, shape[0], 0)) != EAVL_ERROR_TREE
+			)
+		{
+		printf("ERROR: Deserialize short: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	shape[0][0] ^= 0x0C;
+	if ((error = EAVLp_Deserialize(context, scount, snodep, shape[0], 0)) != EAVL_ERROR_TREE)
+		{
+		printf("ERROR: Deserialize balance: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void seq(
+		unsigned int		count
+		)
+	{
+	EAVLp_seq_t		sq;
+	EAVLp_context_t		wcontext;
+	EAVLp_node_t*		node;
+	EAVLp_node_t*		dummy;
+	EAVL_node_spec_t	save;
+	unsigned int		zero = 0;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLp_Seq_Init(&sq, &cbset)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&wcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&wcontext, &sq.tree)) != EAVL_OK
+			|| (error = EAVLp_Seq_Write_Begin(&sq)) != EAVL_OK
+			|| (error = EAVLp_Load(&wcontext, count, nodep)) != EAVL_OK
+			|| (error = EAVLp_Seq_Write_End(&sq)) != EAVL_OK
+			|| sq.sequence != 2
+			)
+		{
+		printf("ERROR: Seq setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLp_Seq_Find(&sq, EAVL_FIND_EQ, NULL, NULL, NULL, nodep[i], &dummy)) != EAVL_OK
+				|| dummy != nodep[i]
+				)
+			{
+			printf("ERROR: Seq_Find: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLp_Seq_Write_Begin(&sq)) != EAVL_OK
+			|| (error = EAVLp_Find(&wcontext, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy)) != EAVL_OK
+			|| (error = EAVLp_Remove(&wcontext, &dummy)) != EAVL_OK
+			|| (error = EAVLp_Seq_Write_End(&sq)) != EAVL_OK
+			|| (error = EAVLp_Seq_Find(&sq, EAVL_FIND_EQ, NULL, NULL, NULL, nodep[0], &dummy)) != EAVL_NOTFOUND
+			|| (error = EAVLp_Seq_Find(&sq, EAVL_FIND_GE, NULL, NULL, NULL, nodep[0], &dummy)) != (count > 1 ? EAVL_OK : EAVL_NOTFOUND)
+			|| (count > 1 && dummy != nodep[1])
+			)
+		{
+		printf("ERROR: Seq remove: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Seq_Write_Begin(&sq)) != EAVL_OK
+			|| (error = EAVLp_Insert(&wcontext, nodep[0], &dummy)) != EAVL_OK
+			|| (error = EAVLp_Seq_Write_End(&sq)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Seq insert: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* A cycle, as a torn path may appear, is cut short */
+	node = EAVLp_TREE_ROOT(&sq.tree);
+	while (EAVLp_GET_CHILD(node, LEFT))
+		{
+		node = EAVLp_GET_CHILD(node, LEFT);
+		}
+	save = node->EAVLnode.child[LEFT];
+	node->EAVLnode.child[LEFT] = (save & 0x1u) | (uintptr_t)EAVLp_TREE_ROOT(&sq.tree);
+	error = EAVLp_Seq_Find(&sq, EAVL_FIND_EQ, NULL, NULL, &zero, NULL, &dummy);
+	node->EAVLnode.child[LEFT] = save;
+	if (error != EAVL_ERROR_TREE)
+		{
+		printf("ERROR: Seq cycle: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Clear(&wcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&wcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Seq cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void shards_check(
+		EAVLp_shards_t*		shards,
+		unsigned int		count,
+		unsigned int		present
+		)
+	{
+	unsigned int		i;
+	unsigned int		k;
+	unsigned int		expect;
+	unsigned int		val;
+
+	for (k=0; k<shards->count; k++)
+		{
+		expect = 0;
+		for (i=0; present && i<count; i++)
+			{
+			val = container_of(nodep[i], struct node, node)->val;
+			if ((!k || val >= container_of(shards->shard[k].bound, struct node, node)->val)
+					&& (k+1 == shards->count || val < container_of(shards->shard[k+1].bound, struct node, node)->val)
+					)
+				{
+				expect++;
+				}
+			}
+
+		if (shards->shard[k].count != expect
+				|| (expect && !shards->shard[k].tree.root)
+				|| (!expect && shards->shard[k].tree.root)
+				)
+			{
+			printf("ERROR: Shards count: %u  %u  %u\n", k, (unsigned int)shards->shard[k].count, expect);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	}
+
+
+void shards(
+		unsigned int		count
+		)
+	{
+	EAVLp_shards_t		sh;
+	EAVLp_shard_t		shard[4];
+	struct node		bnodes[4];
+	EAVLp_node_t*		bounds[3];
+	EAVLp_node_t*		dummy;
+	EAVLp_node_t*		old;
+	unsigned int		before = 99;
+	unsigned int		i;
+	int			error;
+
+	for (i=0; i<4; i++)
+		{
+		bnodes[i].val = 100 + (i+1)*(count+3)/4;
+		if (i < 3)
+			{
+			bounds[i] = &bnodes[i].node;
+			}
+		}
+
+	if ((error = EAVLp_Shards_Init(&sh, 4, shard, bounds, &cbset)) != EAVL_OK)
+		{
+		printf("ERROR: Shards_Init: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLp_Shards_Insert(&sh, NULL, nodep[i], &dummy)) != EAVL_OK
+				|| (error = EAVLp_Shards_Insert(&sh, NULL, nodep[i], &dummy)) != EAVL_EXISTS
+				|| dummy != nodep[i]
+				)
+			{
+			printf("ERROR: Shards_Insert: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	shards_check(&sh, count, 1);
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLp_Shards_Find(&sh, EAVL_FIND_EQ, NULL, NULL, NULL, nodep[i], &dummy)) != EAVL_OK
+				|| dummy != nodep[i]
+				|| (error = EAVLp_Shards_Find(&sh, EAVL_FIND_GT, NULL, NULL, NULL, nodep[i], &dummy)) != (i+1 < count ? EAVL_OK : EAVL_NOTFOUND)
+				|| (i+1 < count && dummy != nodep[i+1])
+				|| (error = EAVLp_Shards_Find(&sh, EAVL_FIND_LT, NULL, NULL, NULL, nodep[i], &dummy)) != (i ? EAVL_OK : EAVL_NOTFOUND)
+				|| (i && dummy != nodep[i-1])
+				)
+			{
+			printf("ERROR: Shards_Find: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLp_Shards_Find(&sh, EAVL_FIND_GE, NULL, NULL, &before, NULL, &dummy)) != EAVL_OK
+			|| dummy != nodep[0]
+			|| (error = EAVLp_Shards_Find(&sh, EAVL_FIND_LE, NULL, NULL, &bnodes[3].val, NULL, &dummy)) != EAVL_OK
+			|| dummy != nodep[count-1]
+			)
+		{
+		printf("ERROR: Shards_Find ends: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Move the middle bound down to the first, then back */
+	bnodes[3].val = bnodes[0].val + 1;
+	if ((error = EAVLp_Shards_Rebalance(&sh, NULL, 2, bounds[0], &old)) != EAVL_ERROR_PARAMETER
+			|| (error = EAVLp_Shards_Rebalance(&sh, NULL, 2, &bnodes[3].node, &old)) != EAVL_OK
+			|| old != bounds[1]
+			)
+		{
+		printf("ERROR: Shards_Rebalance: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	shards_check(&sh, count, 1);
+
+	if ((error = EAVLp_Shards_Rebalance(&sh, NULL, 2, bounds[1], &old)) != EAVL_OK
+			|| old != &bnodes[3].node
+			)
+		{
+		printf("ERROR: Shards_Rebalance back: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	shards_check(&sh, count, 1);
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLp_Shards_Remove(&sh, NULL, NULL, nodep[i], &dummy)) != EAVL_OK
+				|| dummy != nodep[i]
+				|| (error = EAVLp_Shards_Remove(&sh, NULL, NULL, nodep[i], &dummy)) != EAVL_NOTFOUND
+				)
+			{
+			printf("ERROR: Shards_Remove: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	shards_check(&sh, count, 0);
+	}
+
+
+void combiner(
+		unsigned int		count
+		)
+	{
+	EAVLp_combiner_t	comb;
+	EAVLp_combiner_slot_t	slot[2];
+	EAVLp_context_t		context;
+	EAVLp_node_t*		dummy;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLp_Combiner_Init(&comb, &cbset, NULL)) != EAVL_OK
+			|| (error = EAVLp_Combiner_Register(&comb, &slot[0])) != EAVL_OK
+			|| (error = EAVLp_Combiner_Register(&comb, &slot[1])) != EAVL_OK
+			)
+		{
+		printf("ERROR: Combiner setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLp_Combiner_Insert(&comb, &slot[i&1], nodep[i], &dummy)) != EAVL_OK
+				|| dummy != nodep[i]
+				|| (error = EAVLp_Combiner_Insert(&comb, &slot[~i&1], nodep[i], &dummy)) != EAVL_EXISTS
+				|| dummy != nodep[i]
+				)
+			{
+			printf("ERROR: Combiner_Insert: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLp_Context_Init(&context, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&context, &comb.tree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Combiner context: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	checksize = count;
+	for (i=0; i<count; i++)
+		{
+		member[i] = 1;
+		}
+	if (check_tree(&context))
+		{
+		printf("ERROR: Combiner tree\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLp_Combiner_Remove(&comb, &slot[i&1], nodep[i], &dummy)) != EAVL_OK
+				|| dummy != nodep[i]
+				|| (error = EAVLp_Combiner_Remove(&comb, &slot[~i&1], nodep[i], &dummy)) != EAVL_NOTFOUND
+				)
+			{
+			printf("ERROR: Combiner_Remove: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if (comb.tree.root
+			|| (error = EAVLp_Context_Disassociate(&context)) != EAVL_OK
+			|| (error = EAVLp_Combiner_Unregister(&comb, &slot[0])) != EAVL_OK
+			|| (error = EAVLp_Combiner_Unregister(&comb, &slot[0])) != EAVL_NOTFOUND
+			|| (error = EAVLp_Combiner_Unregister(&comb, &slot[1])) != EAVL_OK
+			|| comb.slots
+			)
+		{
+		printf("ERROR: Combiner cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void sampled(
+		unsigned int		count
+		)
+	{
+	EAVLp_tree_t		stree;
+	EAVLp_context_t		scontext;
+	EAVLp_node_t*		dummy;
+	struct node*		bad;
+	unsigned int		failed;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLp_Checks_Sample(EAVL_CHECK_PARAM, 2)) != EAVL_ERROR_PARAMETER)
+		{
+		printf("ERROR: Checks_Sample param: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if (!(EAVLp_Checks_Enabled & EAVL_CHECK_TREE))
+		{
+		return;
+		}
+
+	if ((error = EAVLp_Tree_Init(&stree, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&scontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&scontext, &stree)) != EAVL_OK
+			|| (error = EAVLp_Load(&scontext, count, nodep)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Sampled setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* A bad node is found on some operations, not every one */
+	bad = container_of(nodep[0], struct node, node);
+	bad->height++;
+
+	if ((error = EAVLp_Checks_Sample(EAVL_CHECK_TREE, 4)) != EAVL_OK
+			|| (error = EAVLp_Find(&scontext, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Sampled first: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	failed = 0;
+	for (i=0; i<8; i++)
+		{
+		if (EAVLp_Find(&scontext, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy) == EAVL_ERROR_CALLBACK)
+			{
+			failed++;
+			}
+		}
+
+	if (!failed || failed == 8
+			|| (error = EAVLp_Checks_Sample(EAVL_CHECK_TREE, 0)) != EAVL_OK
+			|| (error = EAVLp_Find(&scontext, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy)) != EAVL_ERROR_CALLBACK
+			)
+		{
+		printf("ERROR: Sampled: %d  %u\n", error, failed);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	bad->height--;
+
+	if ((error = EAVLp_Clear(&scontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&scontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Sampled cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void pathcheck(
+		unsigned int		count
+		)
+	{
+	EAVLp_tree_t		ptree;
+	EAVLp_context_t		pcontext;
+	EAVLp_node_t*		dummy;
+	unsigned int		enabled = EAVLp_Checks_Enabled;
+	unsigned int		val;
+	int			error;
+	int			offpath;
+	int			onpath;
+
+	if (!(EAVLp_Checks_Available & EAVL_CHECK_PATH) || count < 16)
+		{
+		return;
+		}
+
+	if ((error = EAVLp_Tree_Init(&ptree, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&pcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&pcontext, &ptree)) != EAVL_OK
+			|| (error = EAVLp_Load(&pcontext, count-1, nodep)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Path setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Only the nodes near the changed path are checked */
+	EAVLp_Checks_Enabled = EAVL_CHECK_PATH;
+
+	val = nodes[0].val;
+	nodes[0].val = -1u;
+	offpath = EAVLp_Insert(&pcontext, nodep[count-1], &dummy);
+	nodes[0].val = val;
+
+	/* Removing the last node leaves its predecessor on the path */
+	val = nodes[count-2].val;
+	nodes[count-2].val = 0;
+	onpath = (offpath == EAVL_OK)
+			? EAVLp_Remove(&pcontext, NULL)
+			: EAVL_OK
+			;
+	nodes[count-2].val = val;
+
+	EAVLp_Checks_Enabled = enabled;
+
+	if (offpath != EAVL_OK || onpath != EAVL_ERROR_COMPARE)
+		{
+		printf("ERROR: Path check: %d  %d\n", offpath, onpath);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Clear(&pcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&pcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Path cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void treechecks(
+		unsigned int		count
+		)
+	{
+	EAVLp_tree_t		quiet;
+	EAVLp_tree_t		loud;
+	EAVLp_context_t		qcontext;
+	EAVLp_context_t		lcontext;
+	EAVLp_node_t*		dummy;
+	unsigned int		half = count/2;
+	int			error;
+	int			qerror;
+	int			lerror;
+
+	if (!(EAVLp_Checks_Enabled & EAVL_CHECK_TREE) || count < 2)
+		{
+		return;
+		}
+
+	if ((error = EAVLp_Tree_Init(&quiet, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLp_Tree_Init(&loud, &quiet, NULL)) != EAVL_OK
+			|| (error = EAVLp_Tree_Checks(&quiet, EAVL_CHECK_ALL & ~EAVL_CHECK_TREE)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&qcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&qcontext, &quiet)) != EAVL_OK
+			|| (error = EAVLp_Load(&qcontext, half, nodep)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&lcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&lcontext, &loud)) != EAVL_OK
+			|| (error = EAVLp_Load(&lcontext, count-half, &nodep[half])) != EAVL_OK
+			)
+		{
+		printf("ERROR: Tree_Checks setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Tree_Checks(&quiet, -1u)) != EAVL_ERROR_PARAMETER
+			|| (error = EAVLp_Tree_Checks(&quiet, 0)) != EAVL_ERROR_CONTEXT
+			)
+		{
+		printf("ERROR: Tree_Checks: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Only the tree that allows the check finds the bad node */
+	nodes[0].height++;
+	nodes[count-1].height++;
+	qerror = EAVLp_Find(&qcontext, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy);
+	lerror = EAVLp_Find(&lcontext, EAVL_FIND_EQ, NULL, NULL, nodep[count-1], &dummy);
+	nodes[0].height--;
+	nodes[count-1].height--;
+
+	if (qerror != (half ? EAVL_OK : EAVL_NOTFOUND) || lerror != EAVL_ERROR_CALLBACK)
+		{
+		printf("ERROR: Tree_Checks find: %d  %d\n", qerror, lerror);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Clear(&qcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&qcontext)) != EAVL_OK
+			|| (error = EAVLp_Clear(&lcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&lcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Tree_Checks cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void generation(
+		unsigned int		count
+		)
+	{
+	EAVLp_tree_t		gtree;
+	EAVLp_context_t		reader;
+	EAVLp_context_t		writer;
+	EAVLp_node_t*		dummy;
+	unsigned int		enabled = EAVLp_Checks_Enabled;
+	int			stale;
+	int			fresh;
+	int			error;
+
+	if (!(EAVLp_Checks_Available & EAVL_CHECK_GENERATION) || count < 2)
+		{
+		return;
+		}
+
+	if ((error = EAVLp_Tree_Init(&gtree, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&reader, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&reader, &gtree)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&writer, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&writer, &gtree)) != EAVL_OK
+			|| (error = EAVLp_Load(&writer, count-1, nodep)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Generation setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Contexts are not registered; a change makes the reader stale */
+	EAVLp_Checks_Enabled = EAVL_CHECK_GENERATION;
+
+	if ((error = EAVLp_Find(&reader, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy)) != EAVL_OK
+			|| (error = EAVLp_Insert(&writer, nodep[count-1], &dummy)) != EAVL_OK
+			)
+		{
+		EAVLp_Checks_Enabled = enabled;
+		printf("ERROR: Generation: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	stale = EAVLp_Next(&reader, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &dummy);
+	fresh = EAVLp_Find(&reader, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy);
+
+	EAVLp_Checks_Enabled = enabled;
+
+	if (stale != EAVL_ERROR_CONTEXT || fresh != EAVL_OK)
+		{
+		printf("ERROR: Generation: %d  %d\n", stale, fresh);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Clear(&writer, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&writer)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&reader)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Generation cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void cursor(
+		unsigned int		count
+		)
+	{
+	EAVLp_tree_t		ctree;
+	EAVLp_context_t		ccontext;
+	EAVLp_cursor_t		cursor;
+	EAVLp_node_t*		node;
+	unsigned int		val;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLp_Tree_Init(&ctree, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&ccontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&ccontext, &ctree)) != EAVL_OK
+			|| (error = EAVLp_Load(&ccontext, count, nodep)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Cursor setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* A cursor needs no context and is not reset by writers */
+	if ((error = EAVLp_Cursor_Init(&cursor, &ctree, NULL)) != EAVL_OK
+			|| (error = EAVLp_Cursor_Next(&cursor, EAVL_DIR_RIGHT, &node)) != EAVL_ERROR_CONTEXT
+			)
+		{
+		printf("ERROR: Cursor_Init: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	error = EAVLp_Cursor_First(&cursor, EAVL_DIR_RIGHT, &node);
+	for (i=0; error == EAVL_OK; i++)
+		{
+		if (i >= count || node != nodep[i])
+			{
+			printf("ERROR: Cursor_Next: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		error = EAVLp_Cursor_Next(&cursor, EAVL_DIR_RIGHT, &node);
+		}
+	if (error != EAVL_NOTFOUND || i != count)
+		{
+		printf("ERROR: Cursor_Next end: %d  %u\n", error, i);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	error = EAVLp_Cursor_Last(&cursor, EAVL_DIR_RIGHT, &node);
+	for (i=count; error == EAVL_OK; i--)
+		{
+		if (!i || node != nodep[i-1])
+			{
+			printf("ERROR: Cursor_Prev: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		error = EAVLp_Cursor_Prev(&cursor, EAVL_DIR_RIGHT, &node);
+		}
+	if (error != EAVL_NOTFOUND || i)
+		{
+		printf("ERROR: Cursor_Prev end: %d  %u\n", error, i);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Find, then continue the scan from the found node */
+	val = nodes[count/2].val;
+	if ((error = EAVLp_Cursor_Find(&cursor, EAVL_FIND_GT, NULL, &val, NULL, &node)) != EAVL_OK
+			? (error != EAVL_NOTFOUND || count/2 != count-1)
+			: (node != nodep[count/2+1]
+				|| ((error = EAVLp_Cursor_Prev(&cursor, EAVL_DIR_RIGHT, &node)) != EAVL_OK)
+				|| node != nodep[count/2]
+				)
+			)
+		{
+		printf("ERROR: Cursor_Find: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Clear(&ccontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&ccontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Cursor cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+unsigned int		fixups;
+
+
+int Deferred_fixup(
+		EAVLp_node_t*		eavl_node,
+		EAVLp_node_t*		childL,
+		EAVLp_node_t*		childR,
+		void*			data
+		)
+	{
+	fixups++;
+
+	return Node_fixup(eavl_node, childL, childR, data);
+	}
+
+
+void deferred(
+		unsigned int		count
+		)
+	{
+	EAVLp_cbset_t		dcbset = cbset;
+	EAVLp_tree_t		dtree;
+	EAVLp_context_t		dcontext;
+	EAVLp_node_t*		dummy;
+	unsigned int		removed = 0;
+	unsigned int		i;
+	int			error;
+
+	if (count < 2)
+		{
+		return;
+		}
+
+	dcbset.fixup = &Deferred_fixup;
+	if ((error = EAVLp_Tree_Init(&dtree, NULL, &dcbset)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&dcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&dcontext, &dtree)) != EAVL_OK
+			|| (error = EAVLp_Load(&dcontext, count, nodep)) != EAVL_OK
+			|| (error = EAVLp_Fixup_Deferred(&dcontext, 1)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Deferred setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* The weights are only right again after the deferred fixups */
+	fixups = 0;
+	for (i=0; i<count; i+=2, removed++)
+		{
+		if ((error = EAVLp_Find(&dcontext, EAVL_FIND_EQ, NULL, NULL, nodep[i], &dummy)) != EAVL_OK
+				|| (error = EAVLp_Remove(&dcontext, NULL)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Deferred remove: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if (fixups)
+		{
+		printf("ERROR: Deferred remove fixups: %u\n", fixups);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Fixup_Deferred(&dcontext, 1)) != EAVL_OK
+			|| !fixups
+			|| container_of(dtree.root, struct node, node)->weight != count-removed
+			)
+		{
+		printf("ERROR: Deferred fixup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i+=2)
+		{
+		if ((error = EAVLp_Insert(&dcontext, nodep[i], &dummy)) != EAVL_OK)
+			{
+			printf("ERROR: Deferred insert: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	/* Fixup_All redoes every node, including those still waiting */
+	for (i=0; i<count; i++)
+		{
+		nodes[i].weight = 0;
+		}
+
+	if ((error = EAVLp_Fixup_All(&dcontext, 0, NULL)) != EAVL_OK
+			|| container_of(dtree.root, struct node, node)->weight != count
+			)
+		{
+		printf("ERROR: Deferred fixup all: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLp_Fixup(&dcontext)) != EAVL_OK
+			|| container_of(dtree.root, struct node, node)->weight != count
+			|| (error = EAVLp_Fixup_Deferred(&dcontext, 0)) != EAVL_OK
+			|| (error = EAVLp_Clear(&dcontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&dcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Deferred cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+struct anode
+	{
+	unsigned int		val;
+	EAVLp_aug_node_t	aug;
+	};
+struct anode			anodes[NODES];
+EAVLp_node_t*		anodep[NODES];
+
+
+EAVL_dir_t Aug_CMP(
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t*		node,
+		void*			data
+		)
+	{
+	unsigned int*		valp = &container_of(node, struct anode, aug.node)->val;
+	unsigned int*		refp = (unsigned int*)ref_value;
+
+	UNUSED(data);
+
+	if (ref_node)
+		{
+		refp = &container_of(ref_node, struct anode, aug.node)->val;
+		}
+
+	return (*valp == *refp) ? EAVL_CMP_SAME : (*valp < *refp) ? EAVL_CMP_LEFT : EAVL_CMP_RIGHT;
+	}
+
+
+EAVLp_cbset_t augcbset =
+		{
+		&Aug_CMP,
+		&EAVLp_Aug_Fixup,
+		&EAVLp_Aug_Verify
+		};
+
+
+void aug(
+		unsigned int		count
+		)
+	{
+	const EAVL_monoid_t*	monoids[2] = {&EAVL_Monoid_Sum, &EAVL_Monoid_Min};
+	EAVLp_tree_t		atree;
+	EAVLp_context_t		acontext;
+	EAVLp_node_t*		dummy;
+	EAVL_aug_value_t	total;
+	EAVL_aug_value_t	expect;
+	EAVLp_node_t*		node;
+	uintptr_t		n;
+	unsigned int		in;
+	unsigned int		lo;
+	unsigned int		hi;
+	unsigned int		i;
+	unsigned int		j;
+	unsigned int		m;
+	int			error;
+
+	/* Sums wrap instead of overflowing */
+	if ((*EAVL_Monoid_Sum.combine)(INT64_MAX, 1) != INT64_MIN
+			|| (*EAVL_Monoid_Sum.combine)(INT64_MIN, -1) != INT64_MAX
+			)
+		{
+		printf("ERROR: Monoid_Sum wrap\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (m=0; m<2; m++)
+		{
+		for (i=0; i<count; i++)
+			{
+			anodes[i].val = 2*i+1;
+			anodep[i] = &anodes[i].aug.node;
+			(void) EAVLp_Aug_Init(&anodes[i].aug, monoids[m], (EAVL_aug_value_t)((i*7919)%1001) - 500);
+			}
+
+		if ((error = EAVLp_Tree_Init(&atree, NULL, &augcbset)) != EAVL_OK
+				|| (error = EAVLp_Context_Init(&acontext, NULL)) != EAVL_OK
+				|| (error = EAVLp_Context_Associate(&acontext, &atree)) != EAVL_OK
+				|| (error = EAVLp_Load(&acontext, count, anodep)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Aug setup: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		if (count && EAVLp_AUG(atree.root)->count != count)
+			{
+			printf("ERROR: Aug count: %lu\n", (unsigned long)EAVLp_AUG(atree.root)->count);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		/* Select a node, then rank it and the gap before it */
+		for (i=0; i<count; i+=1+count/64)
+			{
+			lo = anodes[i].val - 1;
+			if ((error = EAVLp_Select(&acontext, i, &node)) != EAVL_OK
+					|| node != anodep[i]
+					|| (error = EAVLp_Rank(&acontext, NULL, NULL, node, &n)) != EAVL_OK
+					|| n != i
+					|| (error = EAVLp_Rank(&acontext, NULL, &lo, NULL, &n)) != EAVL_NOTFOUND
+					|| n != i
+					)
+				{
+				printf("ERROR: Rank/Select: %d  %u  %lu\n", error, i, (unsigned long)n);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+			}
+
+		if ((error = EAVLp_Select(&acontext, count, &node)) != EAVL_NOTFOUND)
+			{
+			printf("ERROR: Select past end: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		/* Bounds between and on the keys, including outside the tree */
+		srandom(m);
+		for (j=0; j<64; j++)
+			{
+			lo = (unsigned int)random()%(2*count+2);
+			hi = lo + (unsigned int)random()%(2*count+2-lo);
+
+			expect = monoids[m]->identity;
+			in = 0;
+			for (i=0; i<count; i++)
+				{
+				if (anodes[i].val >= lo && anodes[i].val <= hi)
+					{
+					expect = (*monoids[m]->combine)(expect, anodes[i].aug.value);
+					in++;
+					}
+				}
+
+			if ((error = EAVLp_Count_Range(&acontext, NULL, &lo, NULL, &hi, NULL, &n)) != EAVL_OK
+					|| n != in
+					)
+				{
+				printf("ERROR: Count_Range: %d  %u  %u  %lu  %u\n", error, lo, hi, (unsigned long)n, in);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+
+			error = EAVLp_Aug_Range(&acontext, NULL, &lo, NULL, &hi, NULL, &total);
+			if ((error == EAVL_OK)
+					? (total != expect)
+					: (error != EAVL_NOTFOUND || (lo/2 < count && (lo|1) <= hi))
+					)
+				{
+				printf("ERROR: Aug_Range: %d  %u  %u  %ld  %ld\n", error, lo, hi, (long)total, (long)expect);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+			}
+
+		/* Queries see changes whose fixups are still deferred */
+		if ((error = EAVLp_Fixup_Deferred(&acontext, 1)) != EAVL_OK)
+			{
+			printf("ERROR: Aug deferred on: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		expect = monoids[m]->identity;
+		for (i=0; i<count; i++)
+			{
+			if (i%2)
+				{
+				expect = (*monoids[m]->combine)(expect, anodes[i].aug.value);
+				continue;
+				}
+
+			if ((error = EAVLp_Find(&acontext, EAVL_FIND_EQ, NULL, NULL, anodep[i], &dummy)) != EAVL_OK
+					|| (error = EAVLp_Remove(&acontext, NULL)) != EAVL_OK
+					)
+				{
+				printf("ERROR: Aug deferred remove: %d  %u\n", error, i);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+			}
+
+		lo = 0;
+		hi = 2*count;
+		error = EAVLp_Aug_Range(&acontext, NULL, &lo, NULL, &hi, NULL, &total);
+		if ((error == EAVL_OK)
+				? (total != expect)
+				: (error != EAVL_NOTFOUND || count > 1)
+				)
+			{
+			printf("ERROR: Aug deferred: %d  %ld  %ld\n", error, (long)total, (long)expect);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		if ((error = EAVLp_Fixup_Deferred(&acontext, 0)) != EAVL_OK)
+			{
+			printf("ERROR: Aug deferred off: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		if ((error = EAVLp_Clear(&acontext, NULL)) != EAVL_OK
+				|| (error = EAVLp_Context_Disassociate(&acontext)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Aug cleanup: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	}
+
+
+struct inode
+	{
+	unsigned int		id;
+	EAVLp_interval_t	interval;
+	};
+struct inode			inodes[NODES];
+
+struct ivisit
+	{
+	EAVL_aug_value_t	lo;
+	EAVL_aug_value_t	hi;
+	EAVLp_interval_t*	prev;
+	unsigned int		count;
+	unsigned int		bad;
+	};
+
+
+int Interval_visit(
+		EAVLp_node_t*		node,
+		void*			data
+		)
+	{
+	struct ivisit*		visit = (struct ivisit*)data;
+	EAVLp_interval_t*	interval = EAVLp_INTERVAL(node);
+
+	if (interval->start > visit->hi || interval->end < visit->lo
+			|| (visit->prev && EAVLp_Interval_Compare(NULL, &visit->prev->node, node, NULL) != EAVL_CMP_RIGHT)
+			)
+		{
+		visit->bad++;
+		}
+
+	visit->prev = interval;
+	visit->count++;
+
+	return EAVL_CB_OK;
+	}
+
+
+EAVLp_cbset_t intervalcbset =
+		{
+		&EAVLp_Interval_Compare,
+		&EAVLp_Interval_Fixup,
+		&EAVLp_Interval_Verify
+		};
+
+
+void intervals(
+		unsigned int		count
+		)
+	{
+	EAVLp_tree_t		itree;
+	EAVLp_context_t		icontext;
+	EAVLp_node_t*		dummy;
+	struct ivisit		visit;
+	EAVL_aug_value_t	span = (EAVL_aug_value_t)count + 1;
+	EAVL_aug_value_t	start;
+	unsigned int		expect;
+	unsigned int		i;
+	unsigned int		j;
+	int			error;
+
+	if ((error = EAVLp_Tree_Init(&itree, NULL, &intervalcbset)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&icontext, &visit)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&icontext, &itree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Intervals setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Short and long intervals, some with the same start and end */
+	srandom(3);
+	for (i=0; i<count; i++)
+		{
+		inodes[i].id = i;
+		start = random()%span;
+		(void) EAVLp_Interval_Init(&inodes[i].interval, start, start + ((i%8) ? random()%4 : random()%span));
+		if ((error = EAVLp_Insert(&icontext, &inodes[i].interval.node, &dummy)) != EAVL_OK)
+			{
+			printf("ERROR: Intervals insert: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	for (i=0; i<count; i+=3)
+		{
+		if ((error = EAVLp_Find(&icontext, EAVL_FIND_EQ, NULL, NULL, &inodes[i].interval.node, &dummy)) != EAVL_OK
+				|| (error = EAVLp_Remove(&icontext, NULL)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Intervals remove: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	for (j=0; j<64; j++)
+		{
+		visit.lo = random()%(span+2) - 1;
+		visit.hi = (j%2) ? visit.lo : visit.lo + random()%4;
+		visit.prev = NULL;
+		visit.count = 0;
+		visit.bad = 0;
+
+		expect = 0;
+		for (i=0; i<count; i++)
+			{
+			if (i%3 && inodes[i].interval.start <= visit.hi && inodes[i].interval.end >= visit.lo)
+				{
+				expect++;
+				}
+			}
+
+		error = (j%2)
+				? EAVLp_Interval_Stab(&icontext, visit.lo, &Interval_visit)
+				: EAVLp_Interval_Overlap(&icontext, visit.lo, visit.hi, &Interval_visit);
+		if (error != EAVL_OK || visit.count != expect || visit.bad)
+			{
+			printf("ERROR: Intervals query: %d  %ld  %ld  %u  %u  %u\n", error, (long)visit.lo, (long)visit.hi, visit.count, expect, visit.bad);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLp_Clear(&icontext, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&icontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Intervals cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
 int main(
 		int			argc,
 		char**			argv
@@ -990,6 +2303,54 @@ int main(
 		check_op(&context, k, &Eremove, EAVL_OK, "Insert-Remove remove", 0);
 		}
 
+//  serialize
+	printf("\n== serialize\n");
+	reshape(&tree, &context, count);
+
+//  seq
+	printf("\n== seq\n");
+	seq(count);
+
+//  shards
+	printf("\n== shards\n");
+	shards(count);
+
+//  combiner
+	printf("\n== combiner\n");
+	combiner(count);
+
+//  sampled
+	printf("\n== sampled\n");
+	sampled(count);
+
+//  pathcheck
+	printf("\n== pathcheck\n");
+	pathcheck(count);
+
+//  treechecks
+	printf("\n== treechecks\n");
+	treechecks(count);
+
+//  generation
+	printf("\n== generation\n");
+	generation(count);
+
+//  cursor
+	printf("\n== cursor\n");
+	cursor(count);
+
+//  deferred
+	printf("\n== deferred\n");
+	deferred(count);
+
+//  aug
+	printf("\n== aug\n");
+	aug(count);
+
+//  intervals
+	printf("\n== intervals\n");
+	intervals(count);
+
 //  random
 	printf("\n== Random\n");
 	init_tree_context(&tree, &context);
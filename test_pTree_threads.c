@@ -0,0 +1,620 @@
+/*
+**
+*/
+
+
+#define _XOPEN_SOURCE 1000
+
+
+#include "EAVL_pTree.h"
+#include "container_of.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+
+#ifndef UNUSED
+#define UNUSED(var)	var = var
+#endif	/* UNUSED */
+
+
+#define NODES		65537
+#define THREADS		4
+#define ROUNDS		16
+#define SHARDS		4
+
+
+/* Keys are spaced so that shard bounds fit between them */
+#define KEY(I)		(((I)+1)*16)
+
+
+struct tnode
+	{
+	unsigned int		val;
+	EAVLp_node_t		node;
+	};
+struct tnode			tnodes[NODES];
+
+
+EAVL_dir_t Tcompare(void* ref_value, EAVLp_node_t* ref_node, EAVLp_node_t* node, void* data);
+void shards(unsigned int count);
+void combiner(unsigned int count);
+void contexts(unsigned int count);
+
+
+EAVL_dir_t Tcompare(
+		void*			ref_value,
+		EAVLp_node_t*		ref_node,
+		EAVLp_node_t*		node,
+		void*			data
+		)
+	{
+	unsigned int		val = container_of(node, struct tnode, node)->val;
+	unsigned int		ref;
+
+	UNUSED(data);
+
+	ref = (ref_node)
+			? container_of(ref_node, struct tnode, node)->val
+			: *(unsigned int*)ref_value
+			;
+
+	return (val == ref) ? EAVL_CMP_SAME : (val < ref) ? EAVL_CMP_LEFT : EAVL_CMP_RIGHT;
+	}
+
+
+EAVLp_cbset_t tcbset =
+		{
+		&Tcompare,
+		NULL,
+		NULL
+		};
+
+
+typedef struct
+	{
+	unsigned int		thread;
+	unsigned int		count;
+	void*			container;
+	uintptr_t*		stop;
+	int			error;
+	}			job_t;
+
+
+static int start_jobs(
+		job_t			jobs[],
+		pthread_t		threads[],
+		unsigned int		count,
+		void*			container,
+		uintptr_t*		stop,
+		void*			(*run)(void*)
+		)
+	{
+	unsigned int		i;
+
+	for (i=0; i<THREADS; i++)
+		{
+		jobs[i].thread = i;
+		jobs[i].count = count;
+		jobs[i].container = container;
+		jobs[i].stop = stop;
+		jobs[i].error = EAVL_OK;
+		if (pthread_create(&threads[i], NULL, run, &jobs[i]))
+			{
+			return EAVL_ERROR;
+			}
+		}
+
+	return EAVL_OK;
+	}
+
+
+static int finish_jobs(
+		job_t			jobs[],
+		pthread_t		threads[]
+		)
+	{
+	unsigned int		i;
+	int			error = EAVL_OK;
+
+	for (i=0; i<THREADS; i++)
+		{
+		if (pthread_join(threads[i], NULL))
+			{
+			error = EAVL_ERROR;
+			}
+		else if (jobs[i].error != EAVL_OK)
+			{
+			error = jobs[i].error;
+			}
+		}
+
+	return error;
+	}
+
+
+struct tnode			bounds[2][SHARDS];
+
+
+/* Each thread inserts, finds and removes the keys it owns */
+static void* shards_work(
+		void*			data
+		)
+	{
+	job_t*			job = data;
+	EAVLp_shards_t*		sh = job->container;
+	EAVLp_node_t*		node;
+	EAVL_rel_t		rel;
+	unsigned int		round;
+	unsigned int		key;
+	unsigned int		i;
+	int			error;
+
+	for (round=0; round<=ROUNDS && job->error == EAVL_OK; round++)
+		{
+		for (i=job->thread; i<job->count; i+=THREADS)
+			{
+			if ((error = EAVLp_Shards_Insert(sh, NULL, &tnodes[i].node, &node)) != EAVL_OK)
+				{
+				job->error = error;
+				return NULL;
+				}
+			}
+
+		/* The nearest key may sit in a neighbouring shard */
+		for (i=job->thread; i<job->count; i+=THREADS)
+			{
+			rel = (round & 1) ? EAVL_FIND_LE : EAVL_FIND_GE;
+			key = (round & 1) ? KEY(i) + 1 : KEY(i) - 1;
+			if ((error = EAVLp_Shards_Find(sh, rel, NULL, NULL, &key, NULL, &node)) != EAVL_OK
+					|| node != &tnodes[i].node
+					)
+				{
+				job->error = (error == EAVL_OK) ? EAVL_ERROR_TREE : error;
+				return NULL;
+				}
+			}
+
+		for (i=job->thread; round<ROUNDS && i<job->count; i+=THREADS)
+			{
+			if ((error = EAVLp_Shards_Remove(sh, NULL, NULL, &tnodes[i].node, &node)) != EAVL_OK
+					|| node != &tnodes[i].node
+					)
+				{
+				job->error = (error == EAVL_OK) ? EAVL_ERROR_TREE : error;
+				return NULL;
+				}
+			}
+		}
+
+	return NULL;
+	}
+
+
+/* Move every bound back and forth while the workers run */
+static void* shards_rebalance(
+		void*			data
+		)
+	{
+	job_t*			job = data;
+	EAVLp_shards_t*		sh = job->container;
+	EAVLp_node_t*		old;
+	unsigned int		flip = 0;
+	unsigned int		j;
+	int			error;
+
+	while (!__atomic_load_n(job->stop, __ATOMIC_ACQUIRE))
+		{
+		flip = !flip;
+		for (j=1; j<SHARDS; j++)
+			{
+			if ((error = EAVLp_Shards_Rebalance(sh, NULL, j, &bounds[flip][j].node, &old)) != EAVL_OK)
+				{
+				job->error = error;
+				return NULL;
+				}
+			}
+
+		/* Let the workers in between moves */
+		sched_yield();
+		}
+
+	return NULL;
+	}
+
+
+void shards(
+		unsigned int		count
+		)
+	{
+	EAVLp_shards_t		sh;
+	EAVLp_shard_t		shard[SHARDS];
+	EAVLp_node_t*		bound[SHARDS-1];
+	EAVLp_node_t*		node;
+	job_t			jobs[THREADS];
+	job_t			rebalancer;
+	pthread_t		threads[THREADS];
+	pthread_t		thread;
+	uintptr_t		stop = 0;
+	uintptr_t		total = 0;
+	unsigned int		key;
+	unsigned int		i;
+	int			error;
+
+	/* Alternate bounds lie between the keys and never cross */
+	for (i=1; i<SHARDS; i++)
+		{
+		bounds[0][i].val = KEY(i*count/SHARDS) + 2*i - 1;
+		bounds[1][i].val = KEY((2*i+1)*count/(2*SHARDS)) + 2*i;
+		bound[i-1] = &bounds[0][i].node;
+		}
+
+	if ((error = EAVLp_Shards_Init(&sh, SHARDS, shard, bound, &tcbset)) != EAVL_OK)
+		{
+		printf("ERROR: Shards setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	rebalancer.container = &sh;
+	rebalancer.stop = &stop;
+	rebalancer.error = EAVL_OK;
+	if (pthread_create(&thread, NULL, &shards_rebalance, &rebalancer)
+			|| (error = start_jobs(jobs, threads, count, &sh, &stop, &shards_work)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Shards threads\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	error = finish_jobs(jobs, threads);
+	__atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+	if (pthread_join(thread, NULL) || error != EAVL_OK || rebalancer.error != EAVL_OK)
+		{
+		printf("ERROR: Shards work: %d  %d\n", error, rebalancer.error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Every node ends up once in the shard its key belongs to */
+	for (i=0; i<SHARDS; i++)
+		{
+		total += shard[i].count;
+		}
+	for (i=0; i<count; i++)
+		{
+		key = KEY(i);
+		if ((error = EAVLp_Shards_Find(&sh, EAVL_FIND_EQ, NULL, NULL, &key, NULL, &node)) != EAVL_OK
+				|| node != &tnodes[i].node
+				)
+			{
+			printf("ERROR: Shards find: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	if (total != count)
+		{
+		printf("ERROR: Shards count: %lu  %u\n", (unsigned long)total, count);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLp_Shards_Remove(&sh, NULL, NULL, &tnodes[i].node, &node)) != EAVL_OK)
+			{
+			printf("ERROR: Shards cleanup: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	}
+
+
+/* Each thread pushes its own keys through its own slot */
+static void* combiner_work(
+		void*			data
+		)
+	{
+	job_t*			job = data;
+	EAVLp_combiner_t*	comb = job->container;
+	EAVLp_combiner_slot_t	slot;
+	EAVLp_node_t*		node;
+	unsigned int		round;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLp_Combiner_Register(comb, &slot)) != EAVL_OK)
+		{
+		job->error = error;
+		return NULL;
+		}
+
+	for (round=0; round<=ROUNDS && job->error == EAVL_OK; round++)
+		{
+		for (i=job->thread; i<job->count && job->error == EAVL_OK; i+=THREADS)
+			{
+			if ((error = EAVLp_Combiner_Insert(comb, &slot, &tnodes[i].node, &node)) != EAVL_OK
+					|| node != &tnodes[i].node
+					)
+				{
+				job->error = (error == EAVL_OK) ? EAVL_ERROR_TREE : error;
+				}
+			}
+
+		/* A second insert finds the node already there */
+		for (i=job->thread; i<job->count && job->error == EAVL_OK; i+=THREADS)
+			{
+			if ((error = EAVLp_Combiner_Insert(comb, &slot, &tnodes[i].node, &node)) != EAVL_EXISTS
+					|| node != &tnodes[i].node
+					)
+				{
+				job->error = (error == EAVL_EXISTS || error == EAVL_OK) ? EAVL_ERROR_TREE : error;
+				}
+			}
+
+		for (i=job->thread; round<ROUNDS && i<job->count && job->error == EAVL_OK; i+=THREADS)
+			{
+			if ((error = EAVLp_Combiner_Remove(comb, &slot, &tnodes[i].node, &node)) != EAVL_OK
+					|| node != &tnodes[i].node
+					)
+				{
+				job->error = (error == EAVL_OK) ? EAVL_ERROR_TREE : error;
+				}
+			}
+		}
+
+	if ((error = EAVLp_Combiner_Unregister(comb, &slot)) != EAVL_OK && job->error == EAVL_OK)
+		{
+		job->error = error;
+		}
+
+	return NULL;
+	}
+
+
+void combiner(
+		unsigned int		count
+		)
+	{
+	EAVLp_combiner_t	comb;
+	EAVLp_context_t		context;
+	EAVLp_node_t*		node;
+	job_t			jobs[THREADS];
+	pthread_t		threads[THREADS];
+	unsigned int		key;
+	unsigned int		total = 0;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLp_Combiner_Init(&comb, &tcbset, NULL)) != EAVL_OK)
+		{
+		printf("ERROR: Combiner setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = start_jobs(jobs, threads, count, &comb, NULL, &combiner_work)) != EAVL_OK)
+		{
+		printf("ERROR: Combiner threads\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = finish_jobs(jobs, threads)) != EAVL_OK)
+		{
+		printf("ERROR: Combiner work: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if (comb.slots)
+		{
+		printf("ERROR: Combiner slots left registered\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Every key is in the tree exactly once */
+	if ((error = EAVLp_Context_Init(&context, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&context, &comb.tree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Combiner context: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		key = KEY(i);
+		if ((error = EAVLp_Find(&context, EAVL_FIND_EQ, NULL, &key, NULL, &node)) != EAVL_OK
+				|| node != &tnodes[i].node
+				)
+			{
+			printf("ERROR: Combiner find: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	error = EAVLp_First(&context, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node);
+	while (error == EAVL_OK)
+		{
+		total++;
+		error = EAVLp_Next(&context, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node);
+		}
+	if (error != EAVL_NOTFOUND || total != count)
+		{
+		printf("ERROR: Combiner count: %d  %u  %u\n", error, total, count);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	(void) EAVLp_Context_Disassociate(&context);
+	}
+
+
+/* Each thread keeps associating contexts and setting them on its keys */
+static void* contexts_work(
+		void*			data
+		)
+	{
+	job_t*			job = data;
+	EAVLp_tree_t*		tree = job->container;
+	EAVLp_context_t		context[2];
+	EAVLp_node_t*		node;
+	unsigned int		round;
+	unsigned int		key;
+	unsigned int		i;
+	unsigned int		j;
+	int			error;
+
+	for (round=0; round<ROUNDS && job->error == EAVL_OK; round++)
+		{
+		for (j=0; j<2; j++)
+			{
+			if ((error = EAVLp_Context_Init(&context[j], NULL)) != EAVL_OK
+					|| (error = EAVLp_Context_Associate(&context[j], tree)) != EAVL_OK
+					)
+				{
+				job->error = error;
+				return NULL;
+				}
+			}
+
+		for (i=job->thread; i<job->count && job->error == EAVL_OK; i+=THREADS)
+			{
+			key = KEY(i);
+			j = i & 1;
+			if ((error = EAVLp_Find(&context[j], EAVL_FIND_EQ, NULL, &key, NULL, &node)) != EAVL_OK
+					|| node != &tnodes[i].node
+					)
+				{
+				job->error = (error == EAVL_OK) ? EAVL_ERROR_TREE : error;
+				}
+			/* Moving a set context checks it against the registry */
+			else if ((error = EAVLp_Next(&context[j], EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node)) != EAVL_OK
+					&& !(error == EAVL_NOTFOUND && i+1 == job->count)
+					)
+				{
+				job->error = error;
+				}
+			}
+
+		for (j=0; j<2; j++)
+			{
+			if ((error = EAVLp_Context_Disassociate(&context[j])) != EAVL_OK && job->error == EAVL_OK)
+				{
+				job->error = error;
+				}
+			}
+		}
+
+	return NULL;
+	}
+
+
+void contexts(
+		unsigned int		count
+		)
+	{
+	EAVLp_tree_t		tree;
+	EAVLp_context_t		context;
+	EAVLp_node_t*		node;
+	job_t			jobs[THREADS];
+	pthread_t		threads[THREADS];
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLp_Tree_Init(&tree, NULL, &tcbset)) != EAVL_OK
+			|| (error = EAVLp_Context_Init(&context, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Associate(&context, &tree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Contexts setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLp_Insert(&context, &tnodes[i].node, &node)) != EAVL_OK)
+			{
+			printf("ERROR: Contexts insert: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = start_jobs(jobs, threads, count, &tree, NULL, &contexts_work)) != EAVL_OK)
+		{
+		printf("ERROR: Contexts threads\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = finish_jobs(jobs, threads)) != EAVL_OK)
+		{
+		printf("ERROR: Contexts work: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Only the setup context is still associated */
+	if ((error = EAVLp_Clear(&context, NULL)) != EAVL_OK
+			|| (error = EAVLp_Context_Disassociate(&context)) != EAVL_OK
+			|| (error = EAVLp_Release(&tree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Contexts cleanup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+int main(
+		int			argc,
+		char**			argv
+		)
+	{
+	unsigned int		count = 0;
+	unsigned int		i;
+
+	EAVLp_Checks_Enabled = EAVLp_Checks_Available;
+
+	if (argc > 1)
+		{
+		count = (unsigned int)strtol(argv[1], NULL, 10);
+		}
+
+	if (!(1 <= count && count <= NODES))
+		{
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		tnodes[i].val = KEY(i);
+		}
+
+//  shards
+	printf("\n== shards\n");
+	shards(count);
+
+//  combiner
+	printf("\n== combiner\n");
+	combiner(count);
+
+//  contexts
+	printf("\n== contexts\n");
+	contexts(count);
+
+	return 0;
+	}
@@ -0,0 +1,1537 @@
+/*
+**
+*/
+
+
+#define _XOPEN_SOURCE 1000
+
+
+#include "EAVL_rTree.h"
+#include "container_of.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+
+#ifndef __GNUC__
+#define INFO(STR, TYPE) \
+	printf("%-40s%6ld\n", (STR), sizeof(TYPE))
+#else
+#define INFO(STR, TYPE) \
+	printf("%-40s%6ld / %6ld\n", (STR), sizeof(TYPE), __alignof__(TYPE))
+#endif	/* __GNUC__ */
+
+#ifndef UNUSED
+#define UNUSED(var)	var = var
+#endif	/* UNUSED */
+
+#ifndef MAX
+#define MAX(A, B)	(((A) < (B)) ? (B) : (A))
+#endif
+
+
+
+#define NODES		65537
+
+
+
+char buffer[1024];
+EAVLr_node_t*		nodep[NODES];
+struct node
+	{
+	unsigned int		val;
+	unsigned int		height;
+	unsigned int		weight;
+	unsigned int		count;
+	unsigned int		sum;
+	EAVLr_node_t		node;
+	};
+struct node			nodes[NODES];
+
+
+unsigned char	member[NODES];
+unsigned int	opcount;
+unsigned int	checksize;
+
+
+#define RIGHT			EAVL_DIR_RIGHT
+#define LEFT			EAVL_DIR_LEFT
+
+#define SAME			"     "
+#define DIFF			"|    "
+//char bend[] = "`, ";
+//char bend[] = "\\/ ";
+char bend[] = "++ ";
+
+
+void EAVLr_Node_print(EAVLr_node_t* eavl_node);
+void EAVLr_Tree_print(char* prefix, char* end, char* prefix2, int dir, EAVLr_node_t* root);
+EAVL_dir_t Node_CMP(void* ref_value, EAVLr_node_t* ref_node, EAVLr_node_t* node, void* data);
+int Node_verify(EAVLr_node_t* eavl_node, EAVLr_node_t* childL, EAVLr_node_t* childR, void* data);
+int Node_fixup(EAVLr_node_t* eavl_node, EAVLr_node_t* childL, EAVLr_node_t* childR, void* data);
+void Init_nodes(struct node fnodes[], EAVLr_node_t* fnodep[], unsigned int count);
+void check_reset(unsigned int count, unsigned int state);
+int check_tree(EAVLr_context_t* context);
+void check_op(EAVLr_context_t* context, unsigned int index, int (*op)(EAVLr_context_t* context, unsigned int k), int expect, char* operation, unsigned int state);
+void init_tree_context(EAVLr_tree_t* tree, EAVLr_context_t* context);
+void build_tree(EAVLr_tree_t* tree, EAVLr_context_t* context, unsigned int count);
+int insert(EAVLr_context_t* context, unsigned int k);
+int Eremove(EAVLr_context_t* context, unsigned int k);
+int Nfixup(EAVLr_context_t* context, unsigned int k);
+int traverse(EAVLr_context_t* context, EAVL_dir_t dir, EAVL_order_t order);
+void reshape(EAVLr_tree_t* tree, EAVLr_context_t* context, unsigned int count);
+void relocate(unsigned int count);
+int image_sync(void* addr, size_t length, void* cbdata);
+void image_find(EAVLr_image_t* image, unsigned int count, unsigned int stride, char* operation);
+void image(unsigned int count);
+
+
+void check_reset(
+		unsigned int		count,
+		unsigned int		state
+		)
+	{
+	unsigned int		i;
+
+	opcount = 0;
+	checksize = count;
+	for (i=0; i<count; i++)
+		{
+		member[i] = (unsigned char)state;
+		}
+	}
+
+
+int check_tree(
+		EAVLr_context_t*	context
+		)
+	{
+	EAVLr_context_t		checkcontext;
+	unsigned int		i;
+	EAVLr_node_t*		dummy;
+	int			error;
+	int			result = 0;
+
+	if ((error = EAVLr_Context_Init(&checkcontext, NULL)) != EAVL_OK)
+		{
+		printf("ERROR: Context_Init: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	if ((error = EAVLr_Context_Associate(&checkcontext, context->tree)) != EAVL_OK)
+		{
+		printf("ERROR: Context_Associate: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<checksize; i++)
+		{
+		error = EAVLr_Find(
+				context,
+				EAVL_FIND_EQ,
+				NULL,
+				NULL,
+				nodep[i],
+				&dummy
+				);
+//printf("\t%d\n", error);
+
+		if (member[i] && error != EAVL_OK)
+			{
+//printf("\t-1-\n");
+			result = 1;
+			goto out;
+			}
+		else if (!member[i] && error != EAVL_NOTFOUND)
+			{
+//printf("\t-2-\n");
+			result = 1;
+			goto out;
+			}
+		}
+
+out:
+	if ((error = EAVLr_Context_Disassociate(&checkcontext)) != EAVL_OK)
+		{
+		printf("ERROR: Context_Disassociate: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	return result;
+	}
+
+
+void check_op(
+		EAVLr_context_t*	context,
+		unsigned int		index,
+		int (*op)(EAVLr_context_t* context, unsigned int k),
+		int			expect,
+		char*			operation,
+		unsigned int		state
+		)
+	{
+	int			error;
+
+	if (check_tree(context))
+		{
+		printf("Operation PRE check FAILED\n");
+		printf("\tindex: %d  OpCount: %d\n", index, opcount);
+		exit(1);
+		}
+
+	error = (*op)(context, index);
+	if (error != expect)
+		{
+		printf("Operation \"%s\" FAILED\n", operation);
+		printf("\tindex: %d  error: %d  expect: %d\n", index, error, expect);
+		exit(1);
+		}
+
+	member[index] = (unsigned char)state;
+	opcount++;
+
+	if (check_tree(context))
+		{
+		printf("Operation POST check FAILED\n");
+		printf("\tindex: %d  OpCount: %d\n", index, opcount);
+		exit(1);
+		}
+
+printf("%10d\r", opcount); fflush(NULL);
+	}
+
+
+void EAVLr_Node_print(
+		EAVLr_node_t*		eavl_node
+		)
+	{
+	struct node*		node;
+
+	node = container_of(eavl_node, struct node, node);
+	printf("%d", node->val);
+	}
+
+
+void EAVLr_Tree_print(char*		prefix,
+		char*			end,
+		char*			prefix2,
+		int			dir,
+		EAVLr_node_t*		root
+		)
+	{
+	char*			last;
+	char*			nend;
+
+	if (!root)
+		{
+		printf("%s%c---(nil)\n", prefix, bend[dir]);
+
+		return;
+		}
+
+	nend = stpcpy(end, prefix2);
+
+	if (root && EAVLr_GET_CHILD(root, RIGHT))
+		{
+		if (dir != LEFT)
+			{
+			last = SAME;
+			}
+		else
+			{
+			last = DIFF;
+			}
+		EAVLr_Tree_print(prefix, nend, last, RIGHT, EAVLr_GET_CHILD(root, RIGHT));
+		printf("%s%s%s\n", prefix, last, DIFF);
+		}
+
+	printf("%s%c---(", prefix, bend[dir]);
+	EAVLr_Node_print(root);
+	printf(")[a:%p  p:%p  L:%p  R:%p  b:%u]\n",
+			(void*)root,
+			(void*)EAVLr_GET_PARENT(root),
+			(void*)EAVLr_GET_CHILD(root, 0),
+			(void*)EAVLr_GET_CHILD(root, 1),
+			EAVLr_GET_BAL(root)
+			);
+
+	if (root && EAVLr_GET_CHILD(root, LEFT))
+		{
+		if (dir != RIGHT)
+			{
+			last = SAME;
+			}
+		else
+			{
+			last = DIFF;
+			}
+		printf("%s%s%s\n", prefix, last, DIFF);
+		EAVLr_Tree_print(prefix, nend, last, LEFT, EAVLr_GET_CHILD(root, LEFT));
+		}
+
+	*end = '\0';
+	}
+
+
+EAVL_dir_t Node_CMP(
+		void*			ref_value,
+		EAVLr_node_t*		ref_node,
+		EAVLr_node_t*		node,
+		void*			data
+		)
+	{
+	unsigned int*		valp = &container_of(node, struct node, node)->val;
+	unsigned int*		refp = (unsigned int*)ref_value;
+
+	UNUSED(data);
+
+	if (ref_node)
+		{
+		refp = &container_of(ref_node, struct node, node)->val;
+		}
+
+	return (*valp == *refp) ? EAVL_CMP_SAME : (*valp < *refp) ? EAVL_CMP_LEFT : EAVL_CMP_RIGHT;
+	}
+
+
+#define CBNODEPRINT(NODE, PREFIX)					\
+	do								\
+		{							\
+		if ((NODE))						\
+			{						\
+			printf("%s%5d", (PREFIX), container_of((NODE), struct node, node)->val);	\
+			}						\
+		else							\
+			{						\
+			printf("%s     ", (PREFIX));			\
+			}						\
+		} while (0)
+
+
+#define CBNODEPRINTHW(NODE)						\
+	do								\
+		{							\
+		printf("(%d:%d:%d:%d)",					\
+			((NODE) ? container_of((NODE), struct node, node)->height : 0),	\
+			((NODE) ? container_of((NODE), struct node, node)->weight : 0),	\
+			((NODE) ? container_of((NODE), struct node, node)->sum : 0),	\
+			((NODE) ? container_of((NODE), struct node, node)->count : 0)	\
+			);						\
+		} while (0)
+
+
+int Node_verify(
+		EAVLr_node_t*		eavl_node,
+		EAVLr_node_t*		childL,
+		EAVLr_node_t*		childR,
+		void*			data
+		)
+	{
+	UNUSED(data);
+
+//	printf("Verify::  ");
+//	CBNODEPRINT(eavl_node, "");
+//	CBNODEPRINTHW(eavl_node);
+//	CBNODEPRINT(childL, "  L:");
+//	CBNODEPRINTHW(childL);
+//	CBNODEPRINT(childR, "  R:");
+//	CBNODEPRINTHW(childR);
+//	printf("\n");
+
+	if (container_of(eavl_node, struct node, node)->height !=
+			1 + MAX(
+				((childL) ? container_of(childL, struct node, node)->height : 0),
+				((childR) ? container_of(childR, struct node, node)->height : 0)
+				)
+			)
+		{
+		return EAVL_CB_ERROR;
+		}
+	if (container_of(eavl_node, struct node, node)->weight !=
+			1
+			+ ((childL) ? container_of(childL, struct node, node)->weight : 0)
+			+ ((childR) ? container_of(childR, struct node, node)->weight : 0)
+			)
+		{
+		return EAVL_CB_ERROR;
+		}
+	if (container_of(eavl_node, struct node, node)->sum !=
+			container_of(eavl_node, struct node, node)->count
+			+ ((childL) ? container_of(childL, struct node, node)->sum : 0)
+			+ ((childR) ? container_of(childR, struct node, node)->sum : 0)
+			)
+		{
+		return EAVL_CB_ERROR;
+		}
+
+	return EAVL_CB_OK;
+	return EAVL_CB_FINISHED;
+	}
+
+
+int Node_fixup(
+		EAVLr_node_t*		eavl_node,
+		EAVLr_node_t*		childL,
+		EAVLr_node_t*		childR,
+		void*			data
+		)
+	{
+	UNUSED(data);
+
+//	printf("Fixup::  ");
+//	CBNODEPRINT(eavl_node, "");
+//	CBNODEPRINTHW(eavl_node);
+//	CBNODEPRINT(childL, "  L:");
+//	CBNODEPRINTHW(childL);
+//	CBNODEPRINT(childR, "  R:");
+//	CBNODEPRINTHW(childR);
+//	printf("\n");
+
+	container_of(eavl_node, struct node, node)->height =
+			1 + MAX(
+				((childL) ? container_of(childL, struct node, node)->height : 0),
+				((childR) ? container_of(childR, struct node, node)->height : 0)
+				)
+			;
+	container_of(eavl_node, struct node, node)->weight =
+			1
+			+ ((childL) ? container_of(childL, struct node, node)->weight : 0)
+			+ ((childR) ? container_of(childR, struct node, node)->weight : 0)
+			;
+	container_of(eavl_node, struct node, node)->sum =
+			container_of(eavl_node, struct node, node)->count
+			+ ((childL) ? container_of(childL, struct node, node)->sum : 0)
+			+ ((childR) ? container_of(childR, struct node, node)->sum : 0)
+			;
+
+	return EAVL_CB_OK;
+	}
+
+
+static int Node_release(
+		EAVLr_node_t*		node,
+		void*			data
+		)
+	{
+	UNUSED(node);
+	UNUSED(data);
+
+//	printf("Release::  ");
+//	CBNODEPRINT(node, "");
+//	printf("\n");
+
+	/* Do nothing */
+
+	return EAVL_CB_OK;
+	}
+
+
+EAVLr_cbset_t cbset =
+		{
+		&Node_CMP,
+		&Node_fixup,
+		&Node_verify
+		};
+
+
+void Init_nodes(
+		struct node		fnodes[],
+		EAVLr_node_t*		fnodep[],
+		unsigned int		count
+		)
+	{
+	unsigned int		i;
+
+	for (i=0; i<count; i++)
+		{
+		fnodes[i].val = i+100;
+		fnodes[i].height = -1u;
+		fnodes[i].weight = -1u;
+		fnodes[i].sum = -1u;
+		fnodes[i].count = 0;
+		fnodep[i] = &fnodes[i].node;
+		}
+	}
+
+
+void init_tree_context(
+		EAVLr_tree_t*		tree,
+		EAVLr_context_t*	context
+		)
+	{
+	int			error;
+
+	UNUSED(tree);
+
+//	if ((error = EAVLr_Tree_Init(tree, &rootlink, NULL, &cbset)) != EAVL_OK)
+//		{
+//		printf("ERROR: Tree_Init: %d\n", error);
+//		printf("\t%s:%u\n", __FILE__, __LINE__);
+//		exit(1);
+//		}
+//
+//	if ((error = EAVLr_Context_Init(context, NULL, NULL)) != EAVL_OK)
+//		{
+//		printf("ERROR: Context_Init: %d\n", error);
+//		printf("\t%s:%u\n", __FILE__, __LINE__);
+//		exit(1);
+//		}
+//
+//	if ((error = EAVLr_Context_Associate(context, tree)) != EAVL_OK)
+//		{
+//		printf("ERROR: Context_Associate: %d\n", error);
+//		printf("\t%s:%u\n", __FILE__, __LINE__);
+//		exit(1);
+//		}
+
+	if ((error = EAVLr_Clear(context, &Node_release)) != EAVL_OK)
+		{
+		printf("ERROR: tree_Clear: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+//	printf("init_tree_context:: finis\n");fflush(NULL);
+	}
+
+
+void build_tree(
+		EAVLr_tree_t*		tree,
+		EAVLr_context_t*	context,
+		unsigned int		count
+		)
+	{
+	int			error;
+
+	init_tree_context(tree, context);
+	if ((error = EAVLr_Load(context, count, nodep)) != EAVL_OK)
+		{
+		printf("ERROR: Tree_Load: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+
+//		printf("\n");
+//		*buffer = '\0';
+//		EAVLr_Tree_print(buffer, buffer, "", 2, EAVLr_TREE_ROOT(context->tree));
+//		printf("\n");
+
+		exit(1);
+		}
+	}
+
+
+int insert(
+		EAVLr_context_t*	context,
+		unsigned int		k
+		)
+	{
+	EAVLr_node_t*		existing;
+	int			error;
+
+//	printf("%d\n\n", k);
+
+	error = EAVLr_Insert(context, nodep[k], &existing);
+
+//	printf("\n");
+//	*buffer = '\0';
+//	EAVLr_Tree_print(buffer, buffer, "", 2, EAVLr_TREE_ROOT(context->tree));
+//	printf("\n");
+
+	if (error != EAVL_OK)
+		{
+		printf("ERROR: Node_Insert: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+
+		printf("\n");
+		*buffer = '\0';
+		EAVLr_Tree_print(buffer, buffer, "", 2, EAVLr_TREE_ROOT(context->tree));
+		printf("\n");
+
+		printf("Recent::  %p\n", (void*)context->recent);
+
+		exit(1);
+		}
+
+	return error;
+	}
+
+
+int Eremove(
+		EAVLr_context_t*	context,
+		unsigned int		k
+		)
+	{
+	int			error = 0;
+	EAVLr_node_t*		dummy;
+
+//	printf("\n");
+//	*buffer = '\0';
+//	EAVLr_Tree_print(buffer, buffer, "", 2, EAVLr_TREE_ROOT(context->tree));
+//	printf("\n");
+
+//	printf("%d\n\n", k);
+
+	error = EAVLr_Find(context, EAVL_FIND_EQ, NULL, NULL, nodep[k], &dummy);
+	if (error != EAVL_OK)
+		{
+		printf("ERROR: Node_Find: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+
+		printf("\n");
+		*buffer = '\0';
+		EAVLr_Tree_print(buffer, buffer, "", 2, EAVLr_TREE_ROOT(context->tree));
+		printf("\n");
+
+		printf("Recent::  %p\n", (void*)context->recent);
+
+		exit(1);
+		}
+
+	error = EAVLr_Remove(context, NULL);
+
+//	printf("\n");
+//	*buffer = '\0';
+//	EAVLr_Tree_print(buffer, buffer, "", 2, EAVLr_TREE_ROOT(context->tree));
+//	printf("\n");
+
+	if (error != EAVL_OK)
+		{
+		printf("ERROR: Node_Remove: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+
+		printf("\n");
+		*buffer = '\0';
+		EAVLr_Tree_print(buffer, buffer, "", 2, EAVLr_TREE_ROOT(context->tree));
+		printf("\n");
+
+		printf("Recent::  %p\n", (void*)context->recent);
+
+		exit(1);
+		}
+
+	return error;
+	}
+
+
+int Nfixup(
+		EAVLr_context_t*	context,
+		unsigned int		k
+		)
+	{
+	EAVLr_node_t*		dummy;
+	int			error = 0;
+
+	error = EAVLr_Find(context, EAVL_FIND_EQ, NULL, NULL, nodep[k], &dummy);
+
+	if (error != EAVL_OK)
+		{
+		container_of(nodep[k], struct node, node)->count++;
+		error = EAVLr_Fixup(context);
+//printf("\n");
+		}
+
+	return error;
+	}
+
+
+int traverse(
+		EAVLr_context_t*	context,
+		EAVL_dir_t		dir,
+		EAVL_order_t		order
+		)
+	{
+	EAVLr_node_t*		result;
+	int			error;
+
+	error = EAVLr_First(context, dir, order, &result);
+
+	while (error == EAVL_OK)
+		{
+		printf("Found: (%d)[n:%p a:%p]\n",
+				container_of(result, struct node, node)->val,
+				(void*)container_of(result, struct node, node),
+				(void*)result
+				);
+
+		error = EAVLr_Next(context, dir, order, &result);
+		}
+
+	if (error != EAVL_NOTFOUND)
+		{
+		printf("ERROR: Node_First/Next{d:%u o:%u}: %d\n", dir, order, error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		}
+
+	return error;
+	}
+
+
+struct region
+	{
+	EAVLr_root_t		root;
+	struct node		nodes[NODES];
+	};
+
+
+void relocate(
+		unsigned int		count
+		)
+	{
+	struct region*		regions[2];
+	EAVLr_node_t*		rnodep[NODES];
+	EAVLr_context_t		rcontext;
+	EAVLr_tree_t		rtree;
+	EAVLr_node_t*		result;
+	unsigned int		val;
+	unsigned int		i;
+	int			error;
+
+	for (i=0; i<2; i++)
+		{
+		if (!(regions[i] = malloc(sizeof(struct region))))
+			{
+			printf("ERROR: malloc\n");
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	Init_nodes(regions[0]->nodes, rnodep, count);
+	EAVLr_ROOT_INIT(&regions[0]->root);
+
+	if ((error = EAVLr_Tree_Init(&rtree, &regions[0]->root, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLr_Context_Init(&rcontext, NULL)) != EAVL_OK
+			|| (error = EAVLr_Context_Associate(&rcontext, &rtree)) != EAVL_OK
+			|| (error = EAVLr_Load(&rcontext, count, rnodep)) != EAVL_OK
+			|| (error = EAVLr_Context_Disassociate(&rcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: relocate build: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Move the whole region; the links must remain valid */
+	memcpy(regions[1], regions[0], sizeof(struct region));
+	memset(regions[0], 0xa5, sizeof(struct region));
+
+	if ((error = EAVLr_Tree_Init(&rtree, &regions[1]->root, NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLr_Context_Associate(&rcontext, &rtree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: relocate attach: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		val = i+100;
+		error = EAVLr_Find(&rcontext, EAVL_FIND_EQ, NULL, &val, NULL, &result);
+		if (error != EAVL_OK || result != &regions[1]->nodes[i].node)
+			{
+			printf("ERROR: relocate Find(%u): %d\n", val, error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLr_Clear(&rcontext, NULL)) != EAVL_OK
+			|| (error = EAVLr_Context_Disassociate(&rcontext)) != EAVL_OK
+			|| (error = EAVLr_Release(&rtree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: relocate release: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	free(regions[0]);
+	free(regions[1]);
+	}
+
+
+#define IMAGE_BLOCK		(64)
+#define IMAGE_STRIDE		(7)
+#define IMAGE_COPY(IMAGE, INDEX)					\
+	((EAVLr_image_copy_t*)((char*)(IMAGE) + (IMAGE)->copy[(INDEX)]))
+
+
+int image_sync(
+		void*			addr,
+		size_t			length,
+		void*			cbdata
+		)
+	{
+	UNUSED(addr);
+	UNUSED(length);
+
+	(*(unsigned int*)cbdata)++;
+
+	return EAVL_CB_OK;
+	}
+
+
+void image_find(
+		EAVLr_image_t*		image,
+		unsigned int		count,
+		unsigned int		stride,
+		char*			operation
+		)
+	{
+	struct node*		inodes = EAVLr_IMAGE_DATA(image);
+	EAVLr_context_t		icontext;
+	EAVLr_tree_t		itree;
+	EAVLr_node_t*		result;
+	unsigned int		val;
+	unsigned int		i;
+	int			error;
+
+	if ((error = EAVLr_Tree_Init(&itree, EAVLr_IMAGE_ROOT(image), NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLr_Context_Init(&icontext, NULL)) != EAVL_OK
+			|| (error = EAVLr_Context_Associate(&icontext, &itree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: %s open: %d\n", operation, error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		val = i+100;
+		error = EAVLr_Find(&icontext, EAVL_FIND_EQ, NULL, &val, NULL, &result);
+		if ((i % stride == 1)
+				? (error != EAVL_NOTFOUND)
+				: (error != EAVL_OK || result != &inodes[i].node)
+				)
+			{
+			printf("ERROR: %s Find(%u): %d\n", operation, val, error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	/* The tree stays in the image; just detach */
+	if ((error = EAVLr_Context_Disassociate(&icontext)) != EAVL_OK)
+		{
+		printf("ERROR: %s detach: %d\n", operation, error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void image(
+		unsigned int		count
+		)
+	{
+	EAVLr_image_t*		images[3];
+	struct node*		inodes;
+	EAVLr_node_t*		inodep[NODES];
+	EAVLr_context_t		icontext;
+	EAVLr_tree_t		itree;
+	EAVLr_node_t*		result;
+	size_t			size;
+	unsigned int		syncs;
+	unsigned int		val;
+	unsigned int		i;
+	int			error;
+
+	size = 8*IMAGE_BLOCK + 2*count*sizeof(struct node);
+	for (i=0; i<3; i++)
+		{
+		if (!(images[i] = malloc(size)))
+			{
+			printf("ERROR: malloc\n");
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLr_Image_Init(images[0], size, IMAGE_BLOCK)) != EAVL_OK
+			|| EAVLr_IMAGE_DATA_SIZE(images[0]) < count*sizeof(struct node)
+			)
+		{
+		printf("ERROR: image init: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	inodes = EAVLr_IMAGE_DATA(images[0]);
+	Init_nodes(inodes, inodep, count);
+
+	syncs = 0;
+	if ((error = EAVLr_Tree_Init(&itree, EAVLr_IMAGE_ROOT(images[0]), NULL, &cbset)) != EAVL_OK
+			|| (error = EAVLr_Image_Track(
+					images[0],
+					&itree,
+					offsetof(struct node, node),
+					sizeof(struct node)
+					)) != EAVL_OK
+			|| (error = EAVLr_Context_Init(&icontext, NULL)) != EAVL_OK
+			|| (error = EAVLr_Context_Associate(&icontext, &itree)) != EAVL_OK
+			|| (error = EAVLr_Load(&icontext, count, inodep)) != EAVL_OK
+			|| (error = EAVLr_Image_Sync(images[0], &image_sync, &syncs)) != EAVL_OK
+			|| syncs != 1 + (count*sizeof(struct node) + IMAGE_BLOCK - 1)/IMAGE_BLOCK
+			)
+		{
+		printf("ERROR: image build: %d  syncs: %u\n", error, syncs);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Nothing changed; only a copy is written */
+	syncs = 0;
+	if ((error = EAVLr_Image_Sync(images[0], &image_sync, &syncs)) != EAVL_OK
+			|| syncs != 1
+			)
+		{
+		printf("ERROR: image resync: %d  syncs: %u\n", error, syncs);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Untracked writes are reported by the caller */
+	for (i=0; i<2; i++)
+		{
+		syncs = 0;
+		inodes[count-1].sum ^= 1;
+		if ((error = EAVLr_Image_Dirty(
+						images[0],
+						&inodes[count-1].sum,
+						sizeof(inodes[count-1].sum)
+						)) != EAVL_OK
+				|| (error = EAVLr_Image_Sync(images[0], &image_sync, &syncs)) != EAVL_OK
+				|| syncs != 2
+				)
+			{
+			printf("ERROR: image dirty: %d  syncs: %u\n", error, syncs);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	/* Every node write of Remove and Insert is tracked */
+	for (i=1; i<count; i+=IMAGE_STRIDE)
+		{
+		val = i+100;
+		if ((error = EAVLr_Find(&icontext, EAVL_FIND_EQ, NULL, &val, NULL, &result)) != EAVL_OK
+				|| (error = EAVLr_Remove(&icontext, NULL)) != EAVL_OK
+				)
+			{
+			printf("ERROR: image Remove(%u): %d\n", val, error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	if ((error = EAVLr_Image_Sync(images[0], &image_sync, &syncs)) != EAVL_OK)
+		{
+		printf("ERROR: image sync: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	memcpy(images[1], images[0], size);
+	if ((error = EAVLr_Image_Open(images[1], size, 1)) != EAVL_OK)
+		{
+		printf("ERROR: image tracked remove: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	image_find(images[1], count, IMAGE_STRIDE, "image tracked remove");
+
+	/* A live header reaching the disk without a sync changes nothing */
+	memcpy(images[2], images[0], size);
+
+	for (i=1; i<count; i+=IMAGE_STRIDE)
+		{
+		if ((error = EAVLr_Insert(&icontext, &inodes[i].node, &result)) != EAVL_OK)
+			{
+			printf("ERROR: image Insert(%u): %d\n", i+100, error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	memcpy(images[2], images[0], (size_t)images[0]->copy[0]);
+	if ((error = EAVLr_Image_Open(images[2], size, 1)) != EAVL_OK)
+		{
+		printf("ERROR: image header writeback: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	image_find(images[2], count, IMAGE_STRIDE, "image header writeback");
+
+	/* Both copies describe the same data after two syncs */
+	if ((error = EAVLr_Context_Disassociate(&icontext)) != EAVL_OK
+			|| (error = EAVLr_Image_Sync(images[0], &image_sync, &syncs)) != EAVL_OK
+			|| (error = EAVLr_Image_Sync(images[0], &image_sync, &syncs)) != EAVL_OK
+			)
+		{
+		printf("ERROR: image tracked insert: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* "Map" the image somewhere else */
+	memcpy(images[1], images[0], size);
+	memset(images[0], 0xa5, size);
+
+	if ((error = EAVLr_Image_Open(images[1], size, 1)) != EAVL_OK)
+		{
+		printf("ERROR: image open: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	image_find(images[1], count, 1, "image");
+
+	/* Unsynced data changes are only caught by a verifying open */
+	inodes = EAVLr_IMAGE_DATA(images[1]);
+	inodes[count-1].sum ^= 1;
+	if ((error = EAVLr_Image_Open(images[1], size, 0)) != EAVL_OK
+			|| (error = EAVLr_Image_Open(images[1], size, 1)) != EAVL_ERROR_TREE
+			)
+		{
+		printf("ERROR: image data corruption: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	inodes[count-1].sum ^= 1;
+
+	/* A torn copy falls back to the other one */
+	i = images[1]->current;
+	IMAGE_COPY(images[1], i)->crc ^= 1;
+	if ((error = EAVLr_Image_Open(images[1], size, 1)) != EAVL_OK
+			|| images[1]->current == i
+			)
+		{
+		printf("ERROR: image copy corruption: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	image_find(images[1], count, 1, "image copy corruption");
+
+	IMAGE_COPY(images[1], images[1]->current)->blockcrc[0] ^= 1;
+	if ((error = EAVLr_Image_Open(images[1], size, 0)) != EAVL_ERROR_TREE)
+		{
+		printf("ERROR: image header corruption: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	free(images[0]);
+	free(images[1]);
+	free(images[2]);
+	}
+
+
+void reshape(
+		EAVLr_tree_t*		tree,
+		EAVLr_context_t*	context,
+		unsigned int		count
+		)
+	{
+	static EAVLr_node_t*	snodep[NODES];
+	static unsigned char	shape[2][EAVL_SHAPE_SIZE(NODES)];
+	unsigned int		scount;
+	unsigned int		i;
+	unsigned int		k;
+	int			error;
+
+	/* An irregular shape that Load would not produce */
+	init_tree_context(tree, context);
+	check_reset(count, 0);
+	srandom(3);
+	for (i=0; i<count; i++)
+		{
+		k = (unsigned int)random()%count;
+		if (!member[k])
+			{
+			check_op(context, k, &insert, EAVL_OK, "Reshape insert", 1);
+			}
+		}
+
+	scount = NODES;
+	if ((error = EAVLr_Serialize(context, &scount, snodep, shape[0])) != EAVL_OK)
+		{
+		printf("ERROR: Serialize: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0, k=0; i<count; i++)
+		{
+		if (member[i] && snodep[k++] != nodep[i])
+			{
+			printf("ERROR: Serialize order: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	if (k != scount)
+		{
+		printf("ERROR: Serialize count: %u  expect: %u\n", scount, k);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Too small */
+	k = scount-1;
+	if ((error = EAVLr_Serialize(context, &k, snodep, shape[1])) != EAVL_ERROR_PARAMETER
+			|| k != scount
+			)
+		{
+		printf("ERROR: Serialize short: %d  count: %u\n", error, k);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Stored aggregates; no fixup */
+	init_tree_context(tree, context);
+	if ((error = EAVLr_Deserialize(context, scount, snodep, shape[0], 0)) != EAVL_OK)
+		{
+		printf("ERROR: Deserialize: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	if (check_tree(context))
+		{
+		printf("ERROR: Deserialize check\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	k = scount;
+	if ((error = EAVLr_Serialize(context, &k, snodep, shape[1])) != EAVL_OK
+			|| memcmp(shape[0], shape[1], EAVL_SHAPE_SIZE(scount) - (scount&1))
+			|| ((scount&1) && (shape[0][scount>>1] ^ shape[1][scount>>1]) & 0x0F)
+			)
+		{
+		printf("ERROR: Deserialize shape: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Recomputed aggregates */
+	init_tree_context(tree, context);
+	for (i=0; i<scount; i++)
+		{
+		container_of(snodep[i], struct node, node)->height = -1u;
+		}
+	if ((error = EAVLr_Deserialize(context, scount, snodep, shape[0], 1)) != EAVL_OK
+			|| check_tree(context)
+			)
+		{
+		printf("ERROR: Deserialize fixup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Inconsistent streams */
+	init_tree_context(tree, context);
+	if (scount > 1
+			&& (error = EAVLr_Deserialize(context, scount-1, snodep, shape[0], 0)) != EAVL_ERROR_TREE
+			)
+		{
+		printf("ERROR: Deserialize short: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	shape[0][0] ^= 0x0C;
+	if ((error = EAVLr_Deserialize(context, scount, snodep, shape[0], 0)) != EAVL_ERROR_TREE)
+		{
+		printf("ERROR: Deserialize balance: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+int main(
+		int			argc,
+		char**			argv
+		)
+	{
+	unsigned int		count = 0;
+	EAVLr_context_t		context;
+	EAVLr_tree_t		tree;
+	EAVLr_root_t		rootlink;
+	int			error;
+	unsigned int		k;
+	unsigned int		i;
+/*
+	INFO("void*:", void*);
+	printf("\n");
+
+	INFO("char:", char);
+	INFO("short:", short);
+	INFO("int:", int);
+	INFO("long:", long);
+	INFO("long long:", long long);
+	printf("\n");
+
+	INFO("float:", float);
+	INFO("double:", double);
+	printf("\n");
+
+	INFO("EAVLr_tree_t:", EAVLr_tree_t);
+	INFO("EAVLr_node_t:", EAVLr_node_t);
+	INFO("EAVLr_context_t:", EAVLr_context_t);
+	printf("\n");
+*/
+
+	EAVLr_Checks_Enabled = EAVLr_Checks_Available;
+
+	if (argc > 1)
+		{
+		count = (unsigned int)strtol(argv[1], NULL, 10);
+		}
+
+	if (!(1 <= count && count <= NODES))
+		{
+		exit(1);
+		}
+
+	Init_nodes(nodes, nodep, NODES-1);
+
+	EAVLr_ROOT_INIT(&rootlink);
+
+	if ((error = EAVLr_Tree_Init(&tree, &rootlink, NULL, &cbset)) != EAVL_OK)
+		{
+		printf("ERROR: Tree_Init: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLr_Context_Init(&context, NULL)) != EAVL_OK)
+		{
+		printf("ERROR: Context_Init: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLr_Context_Associate(&context, &tree)) != EAVL_OK)
+		{
+		printf("ERROR: Context_Associate: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	if ((error = EAVLr_Load(&context, count, nodep)) != EAVL_OK)
+		{
+		printf("ERROR: Tree_Load: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+
+	*buffer = '\0';
+
+	printf("\n");
+	EAVLr_Tree_print(buffer, buffer, "", 2, EAVLr_TREE_ROOT(&tree));
+	printf("\n");
+
+
+	for (k=EAVL_DIR_LEFT; k<=EAVL_DIR_RIGHT; k++)
+		{
+		EAVLr_node_t*		result = NULL;
+
+		if (EAVL_OK != (error = EAVLr_First(
+				&context,
+				k,
+				EAVL_ORDER_IN,
+				&result
+				)))
+			{
+			printf("ERROR: Node_First{u:%d}: %d\n", k, error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			printf("Recent::  %p\n", (void*)context.recent);
+
+			exit(1);
+			}
+
+		if (result)
+			{
+			printf("Found: (%d)[n:%p a:%p]{d:%u}\n",
+					container_of(result, struct node, node)->val,
+					(void*)container_of(result, struct node, node),
+					(void*)result,
+					k
+					);
+			}
+		}
+
+
+	if (argc > 2)
+		{
+		int			val = atoi(argv[2]);
+		EAVLr_node_t*		result;
+
+		printf("\n");
+
+		if (EAVL_OK != (error = EAVLr_Find(
+				&context,
+				EAVL_FIND_EQ,
+				NULL,
+				&val,
+				NULL,
+				&result
+				)))
+			{
+			printf("ERROR: Node_Find: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		if (result)
+			{
+			printf("Found: (%d)[n:%p a:%p]\n",
+					container_of(result, struct node, node)->val,
+					(void*)container_of(result, struct node, node),
+					(void*)result
+					);
+			}
+		else
+			{
+			printf("NOT found: (%d)\n", val);
+			}
+		}
+
+
+	if (argc > 3)
+		{
+		unsigned int		val = (unsigned int)strtol(argv[2], NULL, 10);
+		unsigned int		dir = (unsigned int)strtol(argv[3], NULL, 10);
+		EAVLr_node_t*		result;
+
+		printf("\n");
+
+		if (EAVL_OK != (error = EAVLr_Find(
+				&context,
+				EAVL_FIND_EQ,
+				NULL,
+				&val,
+				NULL,
+				&result
+				)))
+			{
+			printf("ERROR: Node_Find: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		if (!result)
+			{
+			printf("NOT found: (%d)\n", val);
+			}
+
+		while (result)
+			{
+			printf("Found: (%d)[n:%p a:%p]\n",
+					container_of(result, struct node, node)->val,
+					(void*)container_of(result, struct node, node),
+					(void*)result
+					);
+
+			error = EAVLr_Next(
+					&context,
+					dir,
+					EAVL_ORDER_IN,
+					&result
+					);
+			if (error == EAVL_NOTFOUND)
+				{
+				break;
+				}
+			else if (error != EAVL_OK)
+				{
+				printf("ERROR: Node_Next{d:%d}: %d\n", dir, error);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				printf("%p\n", (void*)context.recent);
+				exit(1);
+				}
+			}
+		}
+
+//  traverse RIGHT IN
+	printf("\n== traverse RIGHT IN\n");
+	(void) traverse(&context, EAVL_DIR_RIGHT, EAVL_ORDER_IN);
+
+//  traverse LEFT IN
+	printf("\n== traverse LEFT IN\n");
+	(void) traverse(&context, EAVL_DIR_LEFT, EAVL_ORDER_IN);
+
+//  traverse RIGHT PRE
+	printf("\n== traverse RIGHT PRE\n");
+	(void) traverse(&context, EAVL_DIR_RIGHT, EAVL_ORDER_PRE);
+
+//  traverse LEFT POST
+	printf("\n== traverse LEFT POST\n");
+	(void) traverse(&context, EAVL_DIR_LEFT, EAVL_ORDER_POST);
+
+//  traverse RIGHT POST
+	printf("\n== traverse RIGHT POST\n");
+	(void) traverse(&context, EAVL_DIR_RIGHT, EAVL_ORDER_POST);
+
+//  traverse LEfT PRE
+	printf("\n== traverse LEFT PRE\n");
+	(void) traverse(&context, EAVL_DIR_LEFT, EAVL_ORDER_PRE);
+
+//  insert LEFT
+	printf("\n== insert LEFT\n");
+	init_tree_context(&tree, &context);
+	check_reset(count, 0);
+	for (k=0; k<count; k++)
+		{
+		check_op(&context, k, &insert, EAVL_OK, "Insert LEFT", 1);
+		}
+
+//  insert RIGHT
+	printf("\n== insert RIGHT\n");
+	init_tree_context(&tree, &context);
+	check_reset(count, 0);
+	for (k=count-1; k<count; k--)
+		{
+		check_op(&context, k, &insert, EAVL_OK, "Insert RIGHT", 1);
+		}
+
+// insert inside-out
+	printf("\n== insert inside-out\n");
+	init_tree_context(&tree, &context);
+	check_reset(count, 0);
+	for (k=((count+1)>>1)-1; k<((count+1)>>1); k-=1)
+		{
+		check_op(&context, k, &insert, EAVL_OK, "Insert inside-out", 1);
+		if (k != count-1-k)
+			{
+			check_op(&context, count-1-k, &insert, EAVL_OK, "Insert inside-out", 1);
+			}
+		}
+
+//  insert outside-in
+	printf("\n== insert outside-in\n");
+	init_tree_context(&tree, &context);
+	check_reset(count, 0);
+	for (k=0; k<((count+1)>>1); k+=1)
+		{
+		check_op(&context, k, &insert, EAVL_OK, "Insert outside-in", 1);
+		if (k != count-1-k)
+			{
+			check_op(&context, count-1-k, &insert, EAVL_OK, "Insert outside-in", 1);
+			}
+		}
+
+//  remove LEFT
+	printf("\n== remove LEFT\n");
+	build_tree(&tree, &context, count);
+	check_reset(count, 1);
+	for (k=0; k<count; k++)
+		{
+		check_op(&context, k, &Eremove, EAVL_OK, "Remove LEFT", 0);
+		}
+
+//  remove RIGHT
+	printf("\n== remove RIGHT\n");
+	build_tree(&tree, &context, count);
+	check_reset(count, 1);
+	for (k=count-1; k<count; k--)
+		{
+		check_op(&context, k, &Eremove, EAVL_OK, "Remove RIGHT", 0);
+		}
+
+//  remove inside-out
+	printf("\n== remove inside-out\n");
+	build_tree(&tree, &context, count);
+	check_reset(count, 1);
+	for (k=((count+1)>>1)-1; k<((count+1)>>1); k-=1)
+		{
+		check_op(&context, k, &Eremove, EAVL_OK, "Remove inside-out", 0);
+		if (k != count-1-k)
+			{
+			check_op(&context, count-1-k, &Eremove, EAVL_OK, "Remove inside-out", 0);
+			}
+		}
+
+//  remove outside-in
+	printf("\n== remove outside-in\n");
+	build_tree(&tree, &context, count);
+	check_reset(count, 1);
+	for (k=0; k<((count+1)>>1); k+=1)
+		{
+		check_op(&context, k, &Eremove, EAVL_OK, "Remove outside-in", 0);
+		if (k != count-1-k)
+			{
+			check_op(&context, count-1-k, &Eremove, EAVL_OK, "Remove outside-in", 0);
+			}
+		}
+
+// insert-remove
+	printf("\n== insert-remove\n");
+	init_tree_context(&tree, &context);
+	check_reset(count, 0);
+	srandom(2);
+	for (i=0; i<count; i++)
+		{
+		k = (unsigned int)random()%count;
+		check_op(&context, k, &insert, EAVL_OK, "Insert-Remove insert", 1);
+		check_op(&context, k, &Eremove, EAVL_OK, "Insert-Remove remove", 0);
+		}
+
+//  serialize
+	printf("\n== serialize\n");
+	reshape(&tree, &context, count);
+
+//  relocate
+	printf("\n== relocate\n");
+	relocate(count);
+	image(count);
+
+//  random
+	printf("\n== Random\n");
+	init_tree_context(&tree, &context);
+	check_reset(count, 0);
+	srandom(2);
+	while (1)
+		{
+		EAVLr_node_t*		dummy;
+
+		k = (unsigned int)random()%count;
+		error = EAVLr_Find(
+				&context,
+				EAVL_FIND_EQ,
+				NULL,
+				NULL,
+				nodep[k],
+				&dummy
+				);
+		switch (error)
+			{
+			case EAVL_OK:
+				if (random() & 0x3)
+					{
+					check_op(&context, k, &Nfixup, EAVL_OK, "Random Fixup", 1);
+					}
+				else
+					{
+					check_op(&context, k, &Eremove, EAVL_OK, "Random Remove", 0);
+					}
+				break;
+
+			case EAVL_NOTFOUND:
+				check_op(&context, k, &insert, EAVL_OK, "Random Insert", 1);
+				break;
+
+			default:
+				printf("ERROR: Node_Find: %d\n", error);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+			}
+		}
+
+
+	return 0;
+	}
@@ -94,6 +94,13 @@ int insert(EAVLs_context_t* context, unsigned int k);
 int Eremove(EAVLs_context_t* context, unsigned int k);
 int Nfixup(EAVLs_context_t* context, unsigned int k);
 int traverse(EAVLs_context_t* context, EAVL_dir_t dir, EAVL_order_t order);
+void reshape(EAVLs_tree_t* tree, EAVLs_context_t* context, unsigned int count);
+void reseek(EAVLs_tree_t* tree, EAVLs_context_t* context, unsigned int count);
+void cursors(EAVLs_tree_t* tree, EAVLs_context_t* context, unsigned int count);
+void vectored(EAVLs_tree_t* tree, EAVLs_context_t* context, unsigned int count);
+void cycle(EAVLs_tree_t* tree, EAVLs_context_t* context, unsigned int count);
+EAVL_dir_t Aug_CMP(void* ref_value, EAVLs_node_t* ref_node, EAVLs_node_t* node, void* data);
+void aug(unsigned int count);
 
 
 static pathestore_t* create_pathestore(void)
@@ -213,6 +220,38 @@ printf("!!!!\n");
 	}
 
 
+static EAVLs_pathelement_t* cb_pathe_vectored(
+		unsigned int		index,
+		unsigned int		param,
+		void*			data
+		)
+	{
+	pathestore_t*		pathestore;
+
+	if (index != EAVL_PATHE_VECTOR)
+		{
+		return cb_pathe(index, param, data);
+		}
+
+	pathestore = ((cbData_t*)(data))->pathestore;
+	if (pathestore->count < param)
+		{
+		void*			temp;
+
+		temp = realloc(pathestore->elements, sizeof(EAVLs_pathelement_t)*param);
+		if (!temp)
+			{
+			return NULL;
+			}
+
+		pathestore->elements = (EAVLs_pathelement_t*)temp;
+		pathestore->count = param;
+		}
+
+	return pathestore->elements;
+	}
+
+
 static void destroy_pathestore(
 		pathestore_t*		pathestore
 		)
@@ -852,6 +891,600 @@ int traverse(
 	}
 
 
+void reshape(
+		EAVLs_tree_t*		tree,
+		EAVLs_context_t*	context,
+		unsigned int		count
+		)
+	{
+	static EAVLs_node_t*	snodep[NODES];
+	static unsigned char	shape[2][EAVL_SHAPE_SIZE(NODES)];
+	unsigned int		scount;
+	unsigned int		i;
+	unsigned int		k;
+	int			error;
+
+	/* An irregular shape that Load would not produce */
+	init_tree_context(tree, context);
+	check_reset(count, 0);
+	srandom(3);
+	for (i=0; i<count; i++)
+		{
+		k = (unsigned int)random()%count;
+		if (!member[k])
+			{
+			check_op(context, k, &insert, EAVL_OK, "Reshape insert", 1);
+			}
+		}
+
+	scount = NODES;
+	if ((error = EAVLs_Serialize(context, &scount, snodep, shape[0])) != EAVL_OK)
+		{
+		printf("ERROR: Serialize: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0, k=0; i<count; i++)
+		{
+		if (member[i] && snodep[k++] != nodep[i])
+			{
+			printf("ERROR: Serialize order: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	if (k != scount)
+		{
+		printf("ERROR: Serialize count: %u  expect: %u\n", scount, k);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Too small */
+	k = scount-1;
+	if ((error = EAVLs_Serialize(context, &k, snodep, shape[1])) != EAVL_ERROR_PARAMETER
+			|| k != scount
+			)
+		{
+		printf("ERROR: Serialize short: %d  count: %u\n", error, k);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Stored aggregates; no fixup */
+	init_tree_context(tree, context);
+	if ((error = EAVLs_Deserialize(context, scount, snodep, shape[0], 0)) != EAVL_OK)
+		{
+		printf("ERROR: Deserialize: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	if (check_tree(context))
+		{
+		printf("ERROR: Deserialize check\n");
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	k = scount;
+	if ((error = EAVLs_Serialize(context, &k, snodep, shape[1])) != EAVL_OK
+			|| memcmp(shape[0], shape[1], EAVL_SHAPE_SIZE(scount) - (scount&1))
+			|| ((scount&1) && (shape[0][scount>>1] ^ shape[1][scount>>1]) & 0x0F)
+			)
+		{
+		printf("ERROR: Deserialize shape: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Recomputed aggregates */
+	init_tree_context(tree, context);
+	for (i=0; i<scount; i++)
+		{
+		container_of(snodep[i], struct node, node)->height = -1u;
+		}
+	if ((error = EAVLs_Deserialize(context, scount, snodep, shape[0], 1)) != EAVL_OK
+			|| check_tree(context)
+			)
+		{
+		printf("ERROR: Deserialize fixup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Inconsistent streams */
+	init_tree_context(tree, context);
+	if (scount > 1
+			&& (error = EAVLs_Deserialize(context, scount-1, snodep, shape[0], 0)) != EAVL_ERROR_TREE
+			)
+		{
+		printf("ERROR: Deserialize short: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	shape[0][0] ^= 0x0C;
+	if ((error = EAVLs_Deserialize(context, scount, snodep, shape[0], 0)) != EAVL_ERROR_TREE)
+		{
+		printf("ERROR: Deserialize balance: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void reseek(
+		EAVLs_tree_t*		tree,
+		EAVLs_context_t*	context,
+		unsigned int		count
+		)
+	{
+	EAVLs_context_t		reader;
+	EAVLs_node_t*		node;
+	EAVLs_node_t*		dummy;
+	unsigned int		reused[4] = {1, 0, 5, 3};
+	unsigned int		i;
+	unsigned int		j;
+	int			error;
+
+	if (count < 2)
+		{
+		return;
+		}
+
+	build_tree(tree, context, count);
+
+	if ((error = EAVLs_Context_Init(&reader, &cb_pathe, create_cbData())) != EAVL_OK
+			|| (error = EAVLs_Context_Associate(&reader, tree)) != EAVL_OK
+			|| (error = EAVLs_Context_Reseek(&reader)) != EAVL_ERROR_CONTEXT
+			)
+		{
+		printf("ERROR: Reseek setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* A scan interleaved with changes made through another context */
+	error = EAVLs_First(&reader, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node);
+	for (i=0; error == EAVL_OK; i++)
+		{
+		if (node != nodep[i])
+			{
+			printf("ERROR: Reseek scan: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		j = (i + count/2) % count;
+		if ((error = EAVLs_Context_Reseek(&reader)) != EAVL_OK
+				|| (error = EAVLs_Find(context, EAVL_FIND_EQ, NULL, NULL, nodep[j], &dummy)) != EAVL_OK
+				|| (error = EAVLs_Remove(context, NULL)) != EAVL_OK
+				|| (error = EAVLs_Insert(context, nodep[j], &dummy)) != EAVL_OK
+				|| (error = EAVLs_Context_Reseek(&reader)) != EAVL_OK
+				|| reader.recent != nodep[i]
+				)
+			{
+			printf("ERROR: Reseek: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		error = EAVLs_Next(&reader, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node);
+		}
+
+	if (error != EAVL_NOTFOUND || i != count)
+		{
+		printf("ERROR: Reseek scan end: %d  %u\n", error, i);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* The recent node was removed */
+	if ((error = EAVLs_Find(&reader, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy)) != EAVL_OK
+			|| (error = EAVLs_Find(context, EAVL_FIND_EQ, NULL, NULL, nodep[0], &dummy)) != EAVL_OK
+			|| (error = EAVLs_Remove(context, NULL)) != EAVL_OK
+			|| (error = EAVLs_Context_Reseek(&reader)) != EAVL_NOTFOUND
+			|| (error = EAVLs_Insert(context, nodep[0], &dummy)) != EAVL_OK
+			|| (error = EAVLs_Context_Disassociate(&reader)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Reseek removed: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/*
+	** A path node comes back in the same place under a key that puts
+	** the recent node on its other side:
+	**	101 (100, 105 (103))  ->  104 (100 (103), 105)
+	*/
+	init_tree_context(tree, context);
+	for (i=0; i<4; i++)
+		{
+		nodes[reused[i]].val = reused[i] + 100;
+		if ((error = EAVLs_Insert(context, &nodes[reused[i]].node, &dummy)) != EAVL_OK)
+			{
+			printf("ERROR: Reseek reused insert: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	if ((error = EAVLs_Context_Associate(&reader, tree)) != EAVL_OK
+			|| (error = EAVLs_Find(&reader, EAVL_FIND_EQ, NULL, NULL, &nodes[3].node, &dummy)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Reseek reused setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	init_tree_context(tree, context);
+	nodes[1].val = 104;
+	for (i=0; i<4; i++)
+		{
+		if ((error = EAVLs_Insert(context, &nodes[reused[i]].node, &dummy)) != EAVL_OK)
+			{
+			printf("ERROR: Reseek reused insert: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+	if ((error = EAVLs_Context_Reseek(&reader)) != EAVL_OK
+			|| reader.recent != &nodes[3].node
+			|| (error = EAVLs_Next(&reader, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node)) != EAVL_OK
+			|| node != &nodes[1].node
+			|| (error = EAVLs_Context_Disassociate(&reader)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Reseek reused: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	init_tree_context(tree, context);
+	nodes[1].val = 101;
+
+	destroy_cbData((cbData_t*)reader.common.cbdata);
+	}
+
+
+void cursors(
+		EAVLs_tree_t*		tree,
+		EAVLs_context_t*	context,
+		unsigned int		count
+		)
+	{
+	EAVLs_cursor_t		cursor;
+	EAVLs_node_t*		node;
+	unsigned int		val;
+	unsigned int		i;
+	int			error;
+
+	build_tree(tree, context, count);
+
+	/* A cursor needs no context and is not reset by writers */
+	if ((error = EAVLs_Cursor_Init(&cursor, tree, NULL)) != EAVL_OK
+			|| (error = EAVLs_Cursor_Next(&cursor, EAVL_DIR_RIGHT, &node)) != EAVL_ERROR_CONTEXT
+			)
+		{
+		printf("ERROR: Cursor_Init: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	error = EAVLs_Cursor_First(&cursor, EAVL_DIR_RIGHT, &node);
+	for (i=0; error == EAVL_OK; i++)
+		{
+		if (i >= count || node != nodep[i])
+			{
+			printf("ERROR: Cursor_Next: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		error = EAVLs_Cursor_Next(&cursor, EAVL_DIR_RIGHT, &node);
+		}
+	if (error != EAVL_NOTFOUND || i != count)
+		{
+		printf("ERROR: Cursor_Next end: %d  %u\n", error, i);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	error = EAVLs_Cursor_Last(&cursor, EAVL_DIR_RIGHT, &node);
+	for (i=count; error == EAVL_OK; i--)
+		{
+		if (!i || node != nodep[i-1])
+			{
+			printf("ERROR: Cursor_Prev: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		error = EAVLs_Cursor_Prev(&cursor, EAVL_DIR_RIGHT, &node);
+		}
+	if (error != EAVL_NOTFOUND || i)
+		{
+		printf("ERROR: Cursor_Prev end: %d  %u\n", error, i);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	/* Find, then continue the scan from the found node */
+	val = nodes[count/2].val;
+	if ((error = EAVLs_Cursor_Find(&cursor, EAVL_FIND_GT, NULL, &val, NULL, &node)) != EAVL_OK
+			? (error != EAVL_NOTFOUND || count/2 != count-1)
+			: (node != nodep[count/2+1]
+				|| ((error = EAVLs_Cursor_Prev(&cursor, EAVL_DIR_RIGHT, &node)) != EAVL_OK)
+				|| node != nodep[count/2]
+				)
+			)
+		{
+		printf("ERROR: Cursor_Find: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+void vectored(
+		EAVLs_tree_t*		tree,
+		EAVLs_context_t*	context,
+		unsigned int		count
+		)
+	{
+	EAVLs_context_t		vcontext;
+	EAVLs_node_t*		node;
+	EAVLs_node_t*		dummy;
+	unsigned int		i;
+	int			error;
+
+	build_tree(tree, context, count);
+
+	if ((error = EAVLs_Context_Init_Vectored(&vcontext, &cb_pathe_vectored, create_cbData())) != EAVL_OK
+			|| (error = EAVLs_Context_Associate(&vcontext, tree)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Vectored setup: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	for (i=0; i<count; i++)
+		{
+		if ((error = EAVLs_Find(&vcontext, EAVL_FIND_EQ, NULL, NULL, nodep[i], &dummy)) != EAVL_OK
+				|| (error = EAVLs_Remove(&vcontext, NULL)) != EAVL_OK
+				|| (error = EAVLs_Insert(&vcontext, nodep[i], &dummy)) != EAVL_OK
+				|| (error = EAVLs_Fixup(&vcontext)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Vectored: %d  %u\n", error, i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		}
+
+	error = EAVLs_First(&vcontext, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node);
+	for (i=0; error == EAVL_OK; i++)
+		{
+		if (i >= count || node != nodep[i])
+			{
+			printf("ERROR: Vectored scan: %u\n", i);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+		error = EAVLs_Next(&vcontext, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node);
+		}
+
+	if (error != EAVL_NOTFOUND || i != count
+			|| (error = EAVLs_Context_Disassociate(&vcontext)) != EAVL_OK
+			)
+		{
+		printf("ERROR: Vectored scan end: %d  %u\n", error, i);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	destroy_cbData((cbData_t*)vcontext.common.cbdata);
+	}
+
+
+struct anode
+	{
+	unsigned int		val;
+	EAVLs_aug_node_t	aug;
+	};
+struct anode			anodes[NODES];
+EAVLs_node_t*		anodep[NODES];
+
+
+void cycle(
+		EAVLs_tree_t*		tree,
+		EAVLs_context_t*	context,
+		unsigned int		count
+		)
+	{
+	EAVL_node_spec_t	saved;
+	EAVL_node_t*		first;
+	EAVLs_node_t*		node;
+	int			error;
+
+	build_tree(tree, context, count);
+
+	/* The first node made its own left child never finishes its subtree */
+	first = &nodep[0]->EAVLnode;
+	saved = first->child[EAVL_DIR_LEFT];
+	first->child[EAVL_DIR_LEFT] = (uintptr_t)first | EAVL_GET_LOW(saved);
+
+	if ((error = EAVLs_First(context, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node)) != EAVL_ERROR_TREE)
+		{
+		printf("ERROR: Cycle: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+
+	first->child[EAVL_DIR_LEFT] = saved;
+
+	if ((error = EAVLs_First(context, EAVL_DIR_RIGHT, EAVL_ORDER_IN, &node)) != EAVL_OK
+			|| node != nodep[0]
+			)
+		{
+		printf("ERROR: Cycle restored: %d\n", error);
+		printf("\t%s:%u\n", __FILE__, __LINE__);
+		exit(1);
+		}
+	}
+
+
+EAVL_dir_t Aug_CMP(
+		void*			ref_value,
+		EAVLs_node_t*		ref_node,
+		EAVLs_node_t*		node,
+		void*			data
+		)
+	{
+	unsigned int*		valp = &container_of(node, struct anode, aug.node)->val;
+	unsigned int*		refp = (unsigned int*)ref_value;
+
+	UNUSED(data);
+
+	if (ref_node)
+		{
+		refp = &container_of(ref_node, struct anode, aug.node)->val;
+		}
+
+	return (*valp == *refp) ? EAVL_CMP_SAME : (*valp < *refp) ? EAVL_CMP_LEFT : EAVL_CMP_RIGHT;
+	}
+
+
+EAVLs_cbset_t augcbset =
+		{
+		&Aug_CMP,
+		&EAVLs_Aug_Fixup,
+		&EAVLs_Aug_Verify
+		};
+
+
+void aug(
+		unsigned int		count
+		)
+	{
+	const EAVL_monoid_t*	monoids[2] = {&EAVL_Monoid_Sum, &EAVL_Monoid_Min};
+	EAVLs_tree_t		atree;
+	EAVLs_context_t		acontext;
+	EAVL_aug_value_t	total;
+	EAVL_aug_value_t	expect;
+	EAVLs_node_t*		node;
+	uintptr_t		n;
+	unsigned int		in;
+	unsigned int		lo;
+	unsigned int		hi;
+	unsigned int		i;
+	unsigned int		j;
+	unsigned int		m;
+	int			error;
+
+	for (m=0; m<2; m++)
+		{
+		for (i=0; i<count; i++)
+			{
+			anodes[i].val = 2*i+1;
+			anodep[i] = &anodes[i].aug.node;
+			(void) EAVLs_Aug_Init(&anodes[i].aug, monoids[m], (EAVL_aug_value_t)((i*7919)%1001) - 500);
+			}
+
+		if ((error = EAVLs_Tree_Init(&atree, NULL, &augcbset)) != EAVL_OK
+				|| (error = EAVLs_Context_Init(&acontext, &cb_pathe, create_cbData())) != EAVL_OK
+				|| (error = EAVLs_Context_Associate(&acontext, &atree)) != EAVL_OK
+				|| (error = EAVLs_Load(&acontext, count, anodep)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Aug setup: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		if (count && EAVLs_AUG(atree.root)->count != count)
+			{
+			printf("ERROR: Aug count: %lu\n", (unsigned long)EAVLs_AUG(atree.root)->count);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		/* Select a node, then rank it and the gap before it */
+		for (i=0; i<count; i+=1+count/64)
+			{
+			lo = anodes[i].val - 1;
+			if ((error = EAVLs_Select(&acontext, i, &node)) != EAVL_OK
+					|| node != anodep[i]
+					|| (error = EAVLs_Rank(&acontext, NULL, NULL, node, &n)) != EAVL_OK
+					|| n != i
+					|| (error = EAVLs_Rank(&acontext, NULL, &lo, NULL, &n)) != EAVL_NOTFOUND
+					|| n != i
+					)
+				{
+				printf("ERROR: Rank/Select: %d  %u  %lu\n", error, i, (unsigned long)n);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+			}
+
+		if ((error = EAVLs_Select(&acontext, count, &node)) != EAVL_NOTFOUND)
+			{
+			printf("ERROR: Select past end: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		/* Bounds between and on the keys, including outside the tree */
+		srandom(m);
+		for (j=0; j<64; j++)
+			{
+			lo = (unsigned int)random()%(2*count+2);
+			hi = lo + (unsigned int)random()%(2*count+2-lo);
+
+			expect = monoids[m]->identity;
+			in = 0;
+			for (i=0; i<count; i++)
+				{
+				if (anodes[i].val >= lo && anodes[i].val <= hi)
+					{
+					expect = (*monoids[m]->combine)(expect, anodes[i].aug.value);
+					in++;
+					}
+				}
+
+			if ((error = EAVLs_Count_Range(&acontext, NULL, &lo, NULL, &hi, NULL, &n)) != EAVL_OK
+					|| n != in
+					)
+				{
+				printf("ERROR: Count_Range: %d  %u  %u  %lu  %u\n", error, lo, hi, (unsigned long)n, in);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+
+			error = EAVLs_Aug_Range(&acontext, NULL, &lo, NULL, &hi, NULL, &total);
+			if ((error == EAVL_OK)
+					? (total != expect)
+					: (error != EAVL_NOTFOUND || (lo/2 < count && (lo|1) <= hi))
+					)
+				{
+				printf("ERROR: Aug_Range: %d  %u  %u  %ld  %ld\n", error, lo, hi, (long)total, (long)expect);
+				printf("\t%s:%u\n", __FILE__, __LINE__);
+				exit(1);
+				}
+			}
+
+		if ((error = EAVLs_Clear(&acontext, NULL)) != EAVL_OK
+				|| (error = EAVLs_Context_Disassociate(&acontext)) != EAVL_OK
+				)
+			{
+			printf("ERROR: Aug cleanup: %d\n", error);
+			printf("\t%s:%u\n", __FILE__, __LINE__);
+			exit(1);
+			}
+
+		destroy_cbData((cbData_t*)acontext.common.cbdata);
+		}
+	}
+
+
 int main(
 		int			argc,
 		char**			argv
@@ -1181,6 +1814,30 @@ int main(
 		check_op(&context, k, &Eremove, EAVL_OK, "Insert-Remove remove", 0);
 		}
 
+//  serialize
+	printf("\n== serialize\n");
+	reshape(&tree, &context, count);
+
+//  reseek
+	printf("\n== reseek\n");
+	reseek(&tree, &context, count);
+
+//  cursors
+	printf("\n== cursors\n");
+	cursors(&tree, &context, count);
+
+//  vectored
+	printf("\n== vectored\n");
+	vectored(&tree, &context, count);
+
+//  cycle
+	printf("\n== cycle\n");
+	cycle(&tree, &context, count);
+
+//  aug
+	printf("\n== aug\n");
+	aug(count);
+
 //  random
 	printf("\n== Random\n");
 	init_tree_context(&tree, &context);